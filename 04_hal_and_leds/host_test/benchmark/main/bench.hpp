@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+
+// ---------------------------------------------------------------
+// Minimal benchmark helpers
+// Every result is printed on its own line as
+//     BENCH <name> <value> <unit>
+// so scripts can grep for it. Lower is always better.
+// ---------------------------------------------------------------
+
+/**
+ * @brief Runs fn until at least min_seconds have passed, three times,
+ *        and returns the best average time per call, in nanoseconds.
+ *
+ * Taking the best round filters out the noise of a shared machine:
+ * the fastest run is the one that was disturbed the least.
+ */
+template <typename Fn>
+double bench_ns_per_call(Fn fn, double min_seconds = 0.1)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 0;
+    for (int round = 0; round < 3; round++) {
+        long calls = 0;
+        clock::time_point start = clock::now();
+        double elapsed = 0;
+        do {
+            fn();
+            calls++;
+            elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        } while (elapsed < min_seconds);
+
+        double ns = elapsed * 1e9 / calls;
+        if (round == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+inline void bench_report(const char *name, double value, const char *unit)
+{
+    printf("BENCH %s %.3f %s\n", name, value, unit);
+    fflush(stdout);
+}
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "atomic_led_sink.hpp"
+#include "batch_protocol.hpp"
+#include "batch_server.hpp"
+#include "bench.hpp"
+#include "fd_stream.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+// ---------------------------------------------------------------
+// BatchServer round trips over a Unix socket pair: one request in
+// flight, so each result is the whole loop of encode, write, parse,
+// compute, reply and parse again. Reported per pair, for several
+// batch sizes, to show what batching saves on the per-frame costs.
+// tools/batch_client.py measures the same thing from Python, against
+// a board or the linux build of test_apps/batch_server.
+// ---------------------------------------------------------------
+static const size_t BATCH_SIZES[] = {1, 16, 256};
+
+void bench_batch_protocol()
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("socketpair failed, batch_protocol skipped\n");
+        return;
+    }
+
+    Sum sum;
+    AtomicLedSink leds;
+    SumBoss boss(sum, leds);
+    std::thread server_thread([&] {
+        FdStream stream(fds[1], fds[1]);
+        BatchServer server(stream, boss);
+        while (server.poll(100) != ESP_ERR_INVALID_STATE) {
+        }
+    });
+
+    FdStream client(fds[0], fds[0]);
+    ByteRing ring;
+    BatchParser parser;
+    std::vector<uint8_t> frame(BatchProtocol::MAX_FRAME_SIZE);
+
+    for (size_t batch : BATCH_SIZES) {
+        std::vector<BatchPair> pairs(batch);
+        for (size_t i = 0; i < batch; i++) {
+            pairs[i] = {static_cast<int32_t>(i % 12), 3}; // Some fail, as in real traffic
+        }
+        size_t size = BatchProtocol::encode_request(0, pairs.data(), batch, frame.data());
+
+        double ns = bench_ns_per_call([&] {
+            client.write(frame.data(), size);
+            BatchFrame reply;
+            while (!parser.next(ring, reply)) {
+                size_t span;
+                uint8_t *free = ring.free_span(span);
+                ring.produce(static_cast<size_t>(client.read(free, span, 1000)));
+            }
+            ring.consume(reply.size());
+        });
+
+        char name[64];
+        snprintf(name, sizeof(name), "batch_protocol/round_trip/%zu", batch);
+        bench_report(name, ns / batch, "ns/pair");
+    }
+
+    shutdown(fds[0], SHUT_WR); // End of file for the server
+    server_thread.join();
+    close(fds[0]);
+    close(fds[1]);
+}
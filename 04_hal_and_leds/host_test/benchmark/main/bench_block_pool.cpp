@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "block_pool.hpp"
+#include "compute_request.hpp"
+
+// ---------------------------------------------------------------
+// BlockPool against malloc: one allocate + deallocate pair of a
+// ComputeRequest, from one thread and from 4 threads at once. The
+// chips compare against heap_caps_malloc in test_apps/benchmark;
+// heap_caps_malloc on the host is malloc anyway.
+// ---------------------------------------------------------------
+static const size_t PAIRS_PER_THREAD = 100000;
+static const size_t THREADS = 4;
+
+// Keeps the compiler from removing a malloc/free pair
+static void *volatile sink;
+
+static BlockPool<ComputeRequest, 256, 1> shared_pool;
+static BlockPool<ComputeRequest, 256, THREADS> cached_pool;
+
+template <typename Pool>
+static void pool_pairs(Pool &pool)
+{
+    for (size_t i = 0; i < PAIRS_PER_THREAD; i++) {
+        void *block = pool.allocate();
+        sink = block;
+        pool.deallocate(block);
+    }
+}
+
+static void malloc_pairs()
+{
+    for (size_t i = 0; i < PAIRS_PER_THREAD; i++) {
+        void *block = malloc(sizeof(ComputeRequest));
+        sink = block;
+        free(block);
+    }
+}
+
+template <typename Fn>
+static double ns_per_pair(size_t threads, Fn pairs)
+{
+    double ns = bench_ns_per_call([&] {
+        std::vector<std::thread> pool;
+        for (size_t t = 0; t < threads; t++) {
+            pool.emplace_back(pairs);
+        }
+        for (auto &thread : pool) {
+            thread.join();
+        }
+    });
+    return ns / (threads * PAIRS_PER_THREAD);
+}
+
+void bench_block_pool()
+{
+    printf("# block_pool: allocate + deallocate of a %zu byte ComputeRequest\n", sizeof(ComputeRequest));
+
+    for (size_t threads = 1; threads <= THREADS; threads *= THREADS) {
+        double shared = ns_per_pair(threads, [] { pool_pairs(shared_pool); });
+        double cached = ns_per_pair(threads, [] { pool_pairs(cached_pool); });
+        double heap = ns_per_pair(threads, malloc_pairs);
+
+        char name[64];
+        snprintf(name, sizeof(name), "block_pool/shared/%zut", threads);
+        bench_report(name, shared, "ns/pair");
+        snprintf(name, sizeof(name), "block_pool/per_core/%zut", threads);
+        bench_report(name, cached, "ns/pair");
+        snprintf(name, sizeof(name), "block_pool/malloc/%zut", threads);
+        bench_report(name, heap, "ns/pair");
+    }
+}
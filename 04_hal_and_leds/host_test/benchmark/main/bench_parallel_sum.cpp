@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "bench.hpp"
+#include "parallel_sum.hpp"
+
+// ---------------------------------------------------------------
+// ParallelSum scaling: one worker against every core, for buffers
+// from 1 KiB to 64 MiB. Small buffers show the hand-off cost, big
+// ones are limited by memory bandwidth.
+// ---------------------------------------------------------------
+void bench_parallel_sum()
+{
+    const SumStreamBounds bounds = {0, 4095, 0, INT32_MAX};
+    const size_t max_bytes = 64u << 20;
+
+    std::vector<int16_t> samples(max_bytes / sizeof(int16_t));
+    for (auto &s : samples) {
+        s = static_cast<int16_t>(rand() % 4096);
+    }
+
+    ParallelSum single(1);
+    ParallelSum all(0);
+    printf("# parallel_sum: 1 worker (1t) vs all %zu workers (all)\n", all.workers());
+
+    for (size_t bytes = 1024; bytes <= max_bytes; bytes *= 4) {
+        size_t count = bytes / sizeof(int16_t);
+        int64_t result;
+
+        double ns_single = bench_ns_per_call([&] { single.reduce(samples.data(), count, bounds, result); });
+        double ns_all = bench_ns_per_call([&] { all.reduce(samples.data(), count, bounds, result); });
+
+        char name[64];
+        snprintf(name, sizeof(name), "parallel_sum/%zuKiB/1t", bytes / 1024);
+        bench_report(name, ns_single / 1000, "us");
+        snprintf(name, sizeof(name), "parallel_sum/%zuKiB/all", bytes / 1024);
+        bench_report(name, ns_all / 1000, "us");
+        printf("#   %6zu KiB: %5.2fx speedup, %6.2f GB/s\n", bytes / 1024, ns_single / ns_all, bytes / ns_all);
+    }
+}
@@ -0,0 +1,159 @@
+#include <stdio.h>
+
+#include "atomic_led_sink.hpp"
+#include "bench.hpp"
+#include "i_gpio_hal.hpp"
+#include "led_sargent.hpp"
+#include "result_fanout.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+// ---------------------------------------------------------------
+// The single-call paths: Sum on its own, LedSargent on a HAL that
+// does nothing, SumBoss on both LED backends, and SumBoss with a
+// ResultFanout of three sinks, all enabled or all disabled, next to
+// the same three sinks behind virtual calls. Each timed call
+// runs a block of operations, so the clock read in
+// bench_ns_per_call doesn't swamp a few nanoseconds of work.
+// The operands cycle through valid, out-of-range and invalid pairs,
+// so the branches see the same mix as in bench_batch_protocol.
+// ---------------------------------------------------------------
+static const int OPS_PER_CALL = 1000;
+
+// Keeps the compiler from removing the results
+static volatile int sink;
+
+// Every write succeeds and goes nowhere: what is left is LedSargent itself
+class NullGpioHal : public IGpioHal
+{
+public:
+    esp_err_t pin_set_direction(gpio_num_t, gpio_mode_t) override { return ESP_OK; }
+    esp_err_t pin_set_level(gpio_num_t, uint32_t) override { return ESP_OK; }
+    int pin_get_level(gpio_num_t) override { return 0; }
+    esp_err_t pin_set_intr(gpio_num_t, gpio_int_type_t, gpio_isr_t, void *) override { return ESP_OK; }
+    esp_err_t pin_remove_intr(gpio_num_t) override { return ESP_OK; }
+};
+
+// A statistics sink: counts and sums, the work a real one would do
+class CountingSink
+{
+public:
+    void on_result(const SumResult &result)
+    {
+        count_++;
+        total_ += result.result;
+    }
+    int count() const { return count_; }
+
+private:
+    int count_ = 0;
+    long total_ = 0;
+};
+
+// The same sinks the classic way, to compare with the fanout
+class VirtualCountingSink : public IResultObserver
+{
+public:
+    void on_result(const SumResult &result) override { sink_.on_result(result); }
+    int count() const { return sink_.count(); }
+
+private:
+    CountingSink sink_;
+};
+
+class VirtualChain : public IResultObserver
+{
+public:
+    VirtualChain(IResultObserver *const *observers, int count)
+        : observers_(observers)
+        , count_(count)
+    {
+    }
+    void on_result(const SumResult &result) override
+    {
+        for (int i = 0; i < count_; i++) {
+            observers_[i]->on_result(result);
+        }
+    }
+
+private:
+    IResultObserver *const *observers_;
+    int count_;
+};
+
+template <typename Fn>
+static void report_per_op(const char *name, Fn op)
+{
+    double ns = bench_ns_per_call([&] {
+        int acc = 0;
+        for (int i = 0; i < OPS_PER_CALL; i++) {
+            acc += op(i % 13 - 1, i % 7);
+        }
+        sink = acc;
+    });
+    bench_report(name, ns / OPS_PER_CALL, "ns/call");
+}
+
+void bench_sum_boss()
+{
+    Sum sum;
+    report_per_op("sum/add_constrained_err_isr", [&](int a, int b) {
+        int result;
+        return sum.add_constrained_err_isr(a, b, result) + result;
+    });
+    report_per_op("sum/add_constrained_err", [&](int a, int b) {
+        int result;
+        return sum.add_constrained_err(a, b, result) + result;
+    });
+
+    NullGpioHal hal;
+    LedSargent leds(hal, GPIO_NUM_4, GPIO_NUM_5);
+    report_per_op("led_sargent/green_red", [&](int a, int) {
+        return (a & 1) ? leds.green() : leds.red();
+    });
+
+    SumBoss boss(sum, leds);
+    report_per_op("sum_boss/compute/led_sargent", [&](int a, int b) {
+        int result;
+        return boss.compute(a, b, result) + result;
+    });
+    report_per_op("sum_boss/compute_isr/led_sargent", [&](int a, int b) {
+        int result;
+        return boss.compute_isr(a, b, result) + result;
+    });
+
+    CountingSink stats, logger, display;
+    ResultFanout fanout(route<ResultMask::ALL>(stats), route<ResultMask::ERRORS>(logger),
+                        route<ResultMask::ALL>(display));
+    boss.set_observer(&fanout);
+    report_per_op("sum_boss/compute/fanout_3", [&](int a, int b) {
+        int result;
+        return boss.compute(a, b, result) + result;
+    });
+
+    ResultFanout disabled(route<ResultMask::NONE>(stats), route<ResultMask::NONE>(logger),
+                          route<ResultMask::NONE>(display));
+    boss.set_observer(&disabled);
+    report_per_op("sum_boss/compute/fanout_3_disabled", [&](int a, int b) {
+        int result;
+        return boss.compute(a, b, result) + result;
+    });
+
+    VirtualCountingSink virtual_sinks[3];
+    IResultObserver *const observers[] = {&virtual_sinks[0], &virtual_sinks[1], &virtual_sinks[2]};
+    VirtualChain chain(observers, 3);
+    boss.set_observer(&chain);
+    report_per_op("sum_boss/compute/virtual_chain_3", [&](int a, int b) {
+        int result;
+        return boss.compute(a, b, result) + result;
+    });
+    boss.set_observer(nullptr);
+    sink = stats.count() + logger.count() + display.count() + virtual_sinks[0].count();
+
+    AtomicLedSink counters;
+    SumBoss counted(sum, counters);
+    report_per_op("sum_boss/compute/atomic_sink", [&](int a, int b) {
+        int result;
+        return counted.compute(a, b, result) + result;
+    });
+}
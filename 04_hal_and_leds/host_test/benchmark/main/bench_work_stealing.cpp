@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "atomic_led_sink.hpp"
+#include "bench.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+#include "work_stealing_executor.hpp"
+
+// ---------------------------------------------------------------
+// WorkStealingExecutor scaling: one batch of SumBoss::compute jobs
+// for 1 to 8 workers, reported per job. A compute is tens of ns, so
+// this mostly measures the deques and the wake-up of the pool.
+// ---------------------------------------------------------------
+void bench_work_stealing()
+{
+    const size_t JOBS = 64 * 1024;
+
+    std::vector<ComputeJob> jobs(JOBS);
+    for (auto &job : jobs) {
+        // Mostly valid operands, some out of range for the red path
+        job.a = rand() % 12;
+        job.b = rand() % 12;
+    }
+
+    Sum sum;
+    AtomicLedSink leds;
+    SumBoss boss(sum, leds);
+
+    printf("# work_stealing: %zu SumBoss::compute jobs per batch\n", JOBS);
+    for (size_t workers = 1; workers <= 8; workers *= 2) {
+        WorkStealingExecutor executor(workers);
+
+        double ns = bench_ns_per_call([&] { executor.compute(boss, jobs.data(), jobs.size()); });
+
+        char name[64];
+        snprintf(name, sizeof(name), "work_stealing/compute/%zuw", workers);
+        bench_report(name, ns / JOBS, "ns/job");
+        printf("#   %zu workers: %6.2f Mjobs/s\n", workers, JOBS * 1e3 / ns);
+    }
+}
@@ -0,0 +1,19 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+// Each benchmark lives in its own file
+void bench_sum_boss();
+void bench_parallel_sum();
+void bench_work_stealing();
+void bench_block_pool();
+void bench_batch_protocol();
+
+extern "C" void app_main(void)
+{
+    bench_sum_boss();
+    bench_parallel_sum();
+    bench_work_stealing();
+    bench_block_pool();
+    bench_batch_protocol();
+    exit(0);
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "i_dma_tx.hpp"
+
+// -------------------------------------------------------------------
+// Fake IDmaTx for the host tests, with a pluggable device behind it
+// queue_tx() copies the buffer as it was queued, and the transfer stays
+// in flight until complete() or wait_tx() ends it, the way the
+// peripheral would. A transfer that ends is checked against that copy,
+// so a buffer written while still being sent shows up in corrupted().
+// Ended frames are kept in frames() and handed to the decoder, which
+// plays the device on the other end: a 74HC595 chain, WS2812 pixels...
+// -------------------------------------------------------------------
+class FakeDmaTx : public IDmaTx
+{
+public:
+    typedef std::vector<uint8_t> Frame;
+    // What the device does with a frame once it is out
+    typedef std::function<void(const Frame &)> Decoder;
+
+    explicit FakeDmaTx(Decoder decoder = Decoder(), size_t queue_size = 2)
+        : decoder_(decoder)
+        , queue_size_(queue_size)
+        , stalled_(false)
+        , corrupted_(0)
+    {
+    }
+
+    esp_err_t queue_tx(const uint8_t *data, size_t len) override
+    {
+        if (transfers_.size() >= queue_size_) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        transfers_.push_back({data, Frame(data, data + len), false});
+        return ESP_OK;
+    }
+    esp_err_t wait_tx(const uint8_t **data, uint32_t) override
+    {
+        if (transfers_.empty()) {
+            return ESP_ERR_TIMEOUT;
+        }
+        if (!transfers_.front().ended) {
+            if (stalled_) {
+                return ESP_ERR_TIMEOUT;
+            }
+            end(transfers_.front()); // Ends while the caller waits
+        }
+        *data = transfers_.front().data;
+        transfers_.pop_front();
+        return ESP_OK;
+    }
+
+    // Ends the oldest transfer in flight, if any
+    void complete()
+    {
+        for (Transfer &t : transfers_) {
+            if (!t.ended) {
+                end(t);
+                return;
+            }
+        }
+    }
+    // While stalled, wait_tx() times out instead of ending a transfer
+    void stall(bool stalled) { stalled_ = stalled; }
+
+    size_t in_flight() const
+    {
+        size_t count = 0;
+        for (const Transfer &t : transfers_) {
+            count += t.ended ? 0 : 1;
+        }
+        return count;
+    }
+    const std::vector<Frame> &frames() const { return frames_; }
+    int corrupted() const { return corrupted_; }
+
+private:
+    struct Transfer
+    {
+        const uint8_t *data;
+        Frame sent; // The buffer as it was when queued
+        bool ended;
+    };
+
+    void end(Transfer &t)
+    {
+        t.ended = true;
+        if (Frame(t.data, t.data + t.sent.size()) != t.sent) {
+            corrupted_++;
+        }
+        frames_.push_back(t.sent);
+        if (decoder_) {
+            decoder_(t.sent);
+        }
+    }
+
+    Decoder decoder_;
+    size_t queue_size_;
+    std::deque<Transfer> transfers_;
+    std::vector<Frame> frames_;
+    bool stalled_;
+    int corrupted_;
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "i_ledc_hal.hpp"
+
+// -------------------------------------------------------------------
+// Fake LEDC peripheral for the host tests
+// Keeps the timer setup, the pin of each channel and its duty. A fade
+// is a linear ramp in time, read through the injected clock
+// (VirtualClock::now_us), so a test can look at the duty halfway
+// through a fade without waiting. Checks what the driver checks:
+// timer before channels, duty within the resolution, known channels.
+// calls() counts every call the code under test made.
+// By default a new duty or fade stops the fade in progress, as on chips
+// with SOC_LEDC_SUPPORT_FADE_STOP. without_fade_stop() models the other
+// chips: the call first waits for the fade to end, by moving the clock.
+// -------------------------------------------------------------------
+class FakeLedcHal : public ILedcHal
+{
+public:
+    static constexpr uint32_t CHANNELS = 8;
+
+    explicit FakeLedcHal(int64_t (*now)())
+        : now_(now)
+        , freq_hz_(0)
+        , duty_bits_(0)
+        , calls_(0)
+        , fail_with_(ESP_OK)
+        , wait_(nullptr)
+        , waited_us_(0)
+    {
+        for (Channel &channel : channels_) {
+            channel = Channel();
+        }
+    }
+
+    esp_err_t timer_config(uint32_t freq_hz, uint32_t duty_bits) override
+    {
+        calls_++;
+        if (fail_with_ != ESP_OK) {
+            return fail_with_;
+        }
+        if (freq_hz == 0 || duty_bits == 0 || duty_bits > 20) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        freq_hz_ = freq_hz;
+        duty_bits_ = duty_bits;
+        return ESP_OK;
+    }
+    esp_err_t channel_config(uint32_t channel, gpio_num_t pin) override
+    {
+        calls_++;
+        if (channel >= CHANNELS || pin < 0 || pin >= GPIO_NUM_MAX) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (duty_bits_ == 0) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        channels_[channel] = Channel();
+        channels_[channel].pin = pin;
+        return ESP_OK;
+    }
+    esp_err_t set_duty(uint32_t channel, uint32_t duty) override
+    {
+        calls_++;
+        esp_err_t ret = check(channel, duty);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        wait_for_fade(channel);
+        Channel &c = channels_[channel];
+        c.from = c.to = duty;
+        c.fade_us = 0;
+        return ESP_OK;
+    }
+    esp_err_t fade_to(uint32_t channel, uint32_t duty, uint32_t time_ms) override
+    {
+        calls_++;
+        esp_err_t ret = check(channel, duty);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        wait_for_fade(channel);
+        Channel &c = channels_[channel];
+        c.from = duty_at(c, now_()); // A new fade starts where the last one is now
+        c.to = duty;
+        c.start_us = now_();
+        c.fade_us = static_cast<int64_t>(time_ms) * 1000;
+        return ESP_OK;
+    }
+    uint32_t get_duty(uint32_t channel) override
+    {
+        calls_++;
+        return channel < CHANNELS ? duty_at(channels_[channel], now_()) : 0;
+    }
+
+    // Inspection, not counted in calls()
+    uint32_t duty(uint32_t channel) const { return duty_at(channels_[channel], now_()); }
+    bool fading(uint32_t channel) const
+    {
+        const Channel &c = channels_[channel];
+        return c.fade_us != 0 && now_() < c.start_us + c.fade_us;
+    }
+    gpio_num_t pin(uint32_t channel) const { return channels_[channel].pin; }
+    uint32_t freq_hz() const { return freq_hz_; }
+    uint32_t duty_bits() const { return duty_bits_; }
+    int calls() const { return calls_; }
+    void reset_calls() { calls_ = 0; }
+
+    // Makes timer_config() fail with err, for the constructor error path
+    void fail_timer_config(esp_err_t err) { fail_with_ = err; }
+
+    // A chip without fade stop: set_duty() and fade_to() on a fading
+    // channel wait for the fade to end, through advance_us
+    // (VirtualClock::advance_us), before they apply
+    void without_fade_stop(void (*advance_us)(int64_t)) { wait_ = advance_us; }
+    // Total time the code under test spent blocked in those waits
+    int64_t waited_us() const { return waited_us_; }
+
+private:
+    struct Channel
+    {
+        gpio_num_t pin = GPIO_NUM_NC;
+        uint32_t from = 0;
+        uint32_t to = 0;
+        int64_t start_us = 0;
+        int64_t fade_us = 0; // 0 when no fade was started since the last set_duty
+    };
+
+    esp_err_t check(uint32_t channel, uint32_t duty) const
+    {
+        if (channel >= CHANNELS || duty > (1u << duty_bits_) - 1) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        return channels_[channel].pin == GPIO_NUM_NC ? ESP_ERR_INVALID_STATE : ESP_OK;
+    }
+
+    void wait_for_fade(uint32_t channel)
+    {
+        if (wait_ == nullptr || !fading(channel)) {
+            return;
+        }
+        const Channel &c = channels_[channel];
+        int64_t left = c.start_us + c.fade_us - now_();
+        waited_us_ += left;
+        wait_(left);
+    }
+
+    static uint32_t duty_at(const Channel &c, int64_t now_us)
+    {
+        int64_t elapsed = now_us - c.start_us;
+        if (c.fade_us == 0 || elapsed >= c.fade_us) {
+            return c.to;
+        }
+        int64_t delta = static_cast<int64_t>(c.to) - static_cast<int64_t>(c.from);
+        return static_cast<uint32_t>(c.from + delta * elapsed / c.fade_us);
+    }
+
+    int64_t (*now_)();
+    uint32_t freq_hz_;
+    uint32_t duty_bits_;
+    Channel channels_[CHANNELS];
+    int calls_;
+    esp_err_t fail_with_;
+    void (*wait_)(int64_t); // nullptr: fades are stopped, never waited for
+    int64_t waited_us_;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "driver/gpio.h"
+
+// -------------------------------------------------------------------
+// In-memory GPIO peripheral behind the real gpio_* functions
+// The driver mock's functions normally need an expectation per call.
+// While a GpioEmulator exists, they are routed to it instead (through
+// CMock's _Stub callbacks), so GpioHal, LedSargent and anything else
+// calling the driver runs end to end at full speed. Only one emulator
+// can be attached at a time.
+//
+// The state is kept like the hardware keeps it: one bit per pad in an
+// output register, an output-enable register and an input-enable
+// register. A pad reads back what drives it: its own output if the
+// output driver is on, otherwise what the test drives from outside,
+// otherwise its pull resistor. A pad whose input is disabled reads 0,
+// as on the chips. Every pad starts as gpio_reset_pin leaves it: input
+// enabled, pull-up on, output off.
+// -------------------------------------------------------------------
+class GpioEmulator
+{
+public:
+    GpioEmulator();
+    ~GpioEmulator();
+
+    GpioEmulator(const GpioEmulator &) = delete;
+    GpioEmulator &operator=(const GpioEmulator &) = delete;
+
+    // Drives a pad from outside, like a button or a sensor. If the pad's
+    // level changes in a way its interrupt type matches, its ISR handler
+    // runs right away, on the caller's thread.
+    void drive(gpio_num_t pin, uint32_t level);
+    // Stops driving the pad, its pull resistor decides the level again
+    void release(gpio_num_t pin);
+
+    // Level on the pad right now
+    uint32_t level(gpio_num_t pin) const;
+
+    uint64_t out_reg() const { return out_; }
+    uint64_t enable_reg() const { return output_enable_; }
+    uint64_t input_enable_reg() const { return input_enable_; }
+
+    // gpio_set_level calls, in total and on one pin
+    uint64_t writes() const { return writes_; }
+    uint64_t writes(gpio_num_t pin) const { return valid(pin) ? pads_[pin].writes : 0; }
+
+    // ISR handler calls since construction
+    uint64_t interrupts() const { return interrupts_; }
+
+private:
+    struct Pad
+    {
+        bool open_drain;
+        bool pull_up;
+        bool pull_down;
+        bool driven;
+        uint32_t driven_level;
+        gpio_int_type_t intr_type;
+        gpio_isr_t handler;
+        void *arg;
+        uint64_t writes;
+    };
+
+    static bool valid(gpio_num_t pin) { return pin >= 0 && pin < GPIO_NUM_MAX; }
+    static uint64_t bit(gpio_num_t pin) { return 1ULL << pin; }
+
+    void set_mode(gpio_num_t pin, gpio_mode_t mode);
+    void reset(gpio_num_t pin);
+    void fire_if_matching(gpio_num_t pin, uint32_t before, uint32_t after);
+
+    // The driver functions, routed here while attached
+    static esp_err_t on_config(const gpio_config_t *config, int calls);
+    static esp_err_t on_reset_pin(gpio_num_t pin, int calls);
+    static esp_err_t on_set_direction(gpio_num_t pin, gpio_mode_t mode, int calls);
+    static esp_err_t on_set_level(gpio_num_t pin, uint32_t level, int calls);
+    static int on_get_level(gpio_num_t pin, int calls);
+    static esp_err_t on_set_pull_mode(gpio_num_t pin, gpio_pull_mode_t pull, int calls);
+    static esp_err_t on_install_isr_service(int flags, int calls);
+    static esp_err_t on_set_intr_type(gpio_num_t pin, gpio_int_type_t type, int calls);
+    static esp_err_t on_isr_handler_add(gpio_num_t pin, gpio_isr_t handler, void *arg, int calls);
+    static esp_err_t on_isr_handler_remove(gpio_num_t pin, int calls);
+
+    static GpioEmulator *active_;
+
+    Pad pads_[GPIO_NUM_MAX];
+    uint64_t out_;
+    uint64_t output_enable_;
+    uint64_t input_enable_;
+    bool isr_service_;
+    uint64_t writes_;
+    uint64_t interrupts_;
+};
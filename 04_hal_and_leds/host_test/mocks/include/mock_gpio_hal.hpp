@@ -0,0 +1,28 @@
+#pragma once
+
+#include "gmock/gmock.h"
+
+#include "i_gpio_hal.hpp"
+
+// -------------------------------------------------------------------
+// Mock class for the GPIO HAL interface
+// Shared by every test file that needs a fake GPIO.
+// -------------------------------------------------------------------
+class MockGpioHal : public IGpioHal
+{
+public:
+    // Defined in mock_gpio_hal.cpp: the constructor and destructor are where gmock
+    // builds every method's mocker, the slow part to compile
+    MockGpioHal();
+    ~MockGpioHal() override;
+
+    MOCK_METHOD(esp_err_t, pin_set_direction, (gpio_num_t, gpio_mode_t), (override));
+    MOCK_METHOD(esp_err_t, pin_set_level, (gpio_num_t, uint32_t), (override));
+    MOCK_METHOD(int, pin_get_level, (gpio_num_t), (override));
+    MOCK_METHOD(esp_err_t, pin_set_intr, (gpio_num_t, gpio_int_type_t, gpio_isr_t, void *), (override));
+    MOCK_METHOD(esp_err_t, pin_remove_intr, (gpio_num_t), (override));
+    MOCK_METHOD(esp_err_t, port_set_levels, (uint64_t, uint64_t), (override));
+};
+
+// Instantiated once in mock_gpio_hal.cpp instead of in every test file
+extern template class ::testing::NiceMock<MockGpioHal>;
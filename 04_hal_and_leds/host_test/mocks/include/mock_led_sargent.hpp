@@ -0,0 +1,22 @@
+#pragma once
+
+#include "gmock/gmock.h"
+
+#include "i_led_sargent.hpp"
+
+// Mock class for ILedSargent
+class MockLedSargent : public ILedSargent
+{
+public:
+    // Defined in mock_led_sargent.cpp: the constructor and destructor are where gmock
+    // builds every method's mocker, the slow part to compile
+    MockLedSargent();
+    ~MockLedSargent() override;
+
+    MOCK_METHOD(esp_err_t, green, (), (override));
+    MOCK_METHOD(esp_err_t, red, (), (override));
+    MOCK_METHOD(esp_err_t, off, (), (override));
+};
+
+// Instantiated once in mock_led_sargent.cpp instead of in every test file
+extern template class ::testing::NiceMock<MockLedSargent>;
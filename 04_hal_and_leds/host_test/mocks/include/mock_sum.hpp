@@ -0,0 +1,26 @@
+#pragma once
+
+#include "gmock/gmock.h"
+
+#include "i_sum.hpp"
+
+// Mock class for ISum
+class MockSum : public ISum
+{
+public:
+    // Defined in mock_sum.cpp: the constructor and destructor are where gmock
+    // builds every method's mocker, the slow part to compile
+    MockSum();
+    ~MockSum() override;
+
+    // Mock each virtual method from ISum.
+    // MOCK_METHOD macro syntax: (return_type, method_name, (parameters), (override))
+
+    MOCK_METHOD(int, add, (int a, int b), (override));
+    MOCK_METHOD(int, add_constrained, (int a, int b), (override));
+    MOCK_METHOD(esp_err_t, add_constrained_err, (int a, int b, int &result), (override));
+    MOCK_METHOD(esp_err_t, add_constrained_err_isr, (int a, int b, int &result), (override));
+};
+
+// Instantiated once in mock_sum.cpp instead of in every test file
+extern template class ::testing::NiceMock<MockSum>;
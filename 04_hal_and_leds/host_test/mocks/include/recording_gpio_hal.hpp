@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "i_gpio_hal.hpp"
+
+// -------------------------------------------------------------------
+// Fake GPIO HAL that records every level written, with a timestamp
+// Unlike MockGpioHal there are no expectations to set up: the code
+// under test runs freely and the test checks the trace afterwards.
+// -------------------------------------------------------------------
+class RecordingGpioHal : public IGpioHal
+{
+public:
+    struct Write
+    {
+        int64_t time_us;
+        gpio_num_t pin;
+        uint32_t level;
+    };
+
+    // now() timestamps each write, e.g. VirtualClock::now_us
+    explicit RecordingGpioHal(int64_t (*now)())
+        : now_(now)
+    {
+        for (auto &level : levels_) {
+            level = 0;
+        }
+    }
+
+    esp_err_t pin_set_direction(gpio_num_t pin, gpio_mode_t) override
+    {
+        return valid(pin) ? ESP_OK : ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t pin_set_level(gpio_num_t pin, uint32_t level) override
+    {
+        if (!valid(pin)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        levels_[pin] = level ? 1 : 0;
+        writes_.push_back({now_(), pin, levels_[pin]});
+        return ESP_OK;
+    }
+    // Recorded pin by pin, as the default does, and counted as one port write
+    esp_err_t port_set_levels(uint64_t set_mask, uint64_t clear_mask) override
+    {
+        port_writes_++;
+        return IGpioHal::port_set_levels(set_mask, clear_mask);
+    }
+    int pin_get_level(gpio_num_t pin) override { return valid(pin) ? static_cast<int>(levels_[pin]) : 0; }
+    // No inputs to simulate here
+    esp_err_t pin_set_intr(gpio_num_t, gpio_int_type_t, gpio_isr_t, void *) override { return ESP_ERR_NOT_SUPPORTED; }
+    esp_err_t pin_remove_intr(gpio_num_t) override { return ESP_ERR_NOT_SUPPORTED; }
+
+    const std::vector<Write> &writes() const { return writes_; }
+    int port_writes() const { return port_writes_; }
+    void clear()
+    {
+        writes_.clear();
+        port_writes_ = 0;
+    }
+
+private:
+    static bool valid(gpio_num_t pin) { return pin >= 0 && pin < GPIO_NUM_MAX; }
+
+    int64_t (*now_)();
+    uint32_t levels_[GPIO_NUM_MAX];
+    std::vector<Write> writes_;
+    int port_writes_ = 0;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+// -------------------------------------------------------------------
+// Virtual time for host runs
+// delay_ms() doesn't wait, it moves the clock forward. Code that only
+// waits through an injected delay (DemoSequence) runs its whole
+// timeline at CPU speed, with now_us() as the timestamp source.
+// Both are plain functions, so they fit the function-pointer clock and
+// delay parameters the component takes.
+// -------------------------------------------------------------------
+class VirtualClock
+{
+public:
+    static int64_t now_us() { return now_us_; }
+    static void delay_ms(uint32_t ms) { now_us_ += static_cast<int64_t>(ms) * 1000; }
+    static void advance_us(int64_t us) { now_us_ += us; }
+    static void reset() { now_us_ = 0; }
+
+private:
+    static int64_t now_us_;
+};
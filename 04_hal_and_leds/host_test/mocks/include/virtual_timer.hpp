@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "i_one_shot_timer.hpp"
+#include "virtual_clock.hpp"
+
+// -------------------------------------------------------------------
+// One-shot timer on VirtualClock
+// start_once() only records a deadline. run_for() moves VirtualClock
+// forward, stopping at each deadline on the way to fire the callback
+// there, the way esp_timer would, and the callback may start the
+// timer again. fires() counts the callbacks, i.e. the CPU wakeups.
+// -------------------------------------------------------------------
+class VirtualTimer : public IOneShotTimer
+{
+public:
+    VirtualTimer()
+        : callback_(nullptr)
+        , arg_(nullptr)
+        , armed_(false)
+        , deadline_us_(0)
+        , fires_(0)
+    {
+    }
+
+    esp_err_t attach(Callback callback, void *arg) override
+    {
+        callback_ = callback;
+        arg_ = arg;
+        return ESP_OK;
+    }
+    esp_err_t start_once(uint64_t timeout_us) override
+    {
+        if (callback_ == nullptr) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        armed_ = true;
+        deadline_us_ = VirtualClock::now_us() + static_cast<int64_t>(timeout_us);
+        return ESP_OK;
+    }
+    void stop() override { armed_ = false; }
+
+    // Moves VirtualClock forward by ms, firing every deadline on the way
+    void run_for(uint32_t ms)
+    {
+        int64_t end = VirtualClock::now_us() + static_cast<int64_t>(ms) * 1000;
+        while (armed_ && deadline_us_ <= end) {
+            VirtualClock::advance_us(deadline_us_ - VirtualClock::now_us());
+            armed_ = false;
+            fires_++;
+            callback_(arg_);
+        }
+        VirtualClock::advance_us(end - VirtualClock::now_us());
+    }
+
+    bool armed() const { return armed_; }
+    int64_t deadline_us() const { return deadline_us_; }
+    int fires() const { return fires_; }
+
+private:
+    Callback callback_;
+    void *arg_;
+    bool armed_;
+    int64_t deadline_us_;
+    int fires_;
+};
@@ -0,0 +1,279 @@
+#include <assert.h>
+
+#include "Mockgpio.h"
+
+#include "gpio_emulator.hpp"
+
+static_assert(GPIO_NUM_MAX <= 64, "One register bit per pad");
+
+GpioEmulator *GpioEmulator::active_ = nullptr;
+
+GpioEmulator::GpioEmulator()
+    : pads_()
+    , out_(0)
+    , output_enable_(0)
+    , input_enable_(0)
+    , isr_service_(false)
+    , writes_(0)
+    , interrupts_(0)
+{
+    assert(active_ == nullptr && "Only one GpioEmulator at a time");
+    for (int pin = 0; pin < GPIO_NUM_MAX; pin++) {
+        reset(static_cast<gpio_num_t>(pin));
+    }
+    active_ = this;
+
+    gpio_config_Stub(on_config);
+    gpio_reset_pin_Stub(on_reset_pin);
+    gpio_set_direction_Stub(on_set_direction);
+    gpio_set_level_Stub(on_set_level);
+    gpio_get_level_Stub(on_get_level);
+    gpio_set_pull_mode_Stub(on_set_pull_mode);
+    gpio_install_isr_service_Stub(on_install_isr_service);
+    gpio_set_intr_type_Stub(on_set_intr_type);
+    gpio_isr_handler_add_Stub(on_isr_handler_add);
+    gpio_isr_handler_remove_Stub(on_isr_handler_remove);
+}
+
+GpioEmulator::~GpioEmulator()
+{
+    // Back to the plain mock, expectations and all
+    gpio_config_Stub(nullptr);
+    gpio_reset_pin_Stub(nullptr);
+    gpio_set_direction_Stub(nullptr);
+    gpio_set_level_Stub(nullptr);
+    gpio_get_level_Stub(nullptr);
+    gpio_set_pull_mode_Stub(nullptr);
+    gpio_install_isr_service_Stub(nullptr);
+    gpio_set_intr_type_Stub(nullptr);
+    gpio_isr_handler_add_Stub(nullptr);
+    gpio_isr_handler_remove_Stub(nullptr);
+    active_ = nullptr;
+}
+
+// ---------------------------------------------------------------
+// Pads
+// ---------------------------------------------------------------
+
+uint32_t GpioEmulator::level(gpio_num_t pin) const
+{
+    if (!valid(pin)) {
+        return 0;
+    }
+    const Pad &pad = pads_[pin];
+    uint32_t out = (out_ & bit(pin)) ? 1 : 0;
+
+    // Push-pull drives both levels, open drain only pulls low
+    if ((output_enable_ & bit(pin)) && !(pad.open_drain && out == 1)) {
+        return out;
+    }
+    if (pad.driven) {
+        return pad.driven_level;
+    }
+    return pad.pull_up ? 1 : 0; // Floating with no pull-up reads low
+}
+
+void GpioEmulator::drive(gpio_num_t pin, uint32_t level)
+{
+    if (!valid(pin)) {
+        return;
+    }
+    uint32_t before = this->level(pin);
+    pads_[pin].driven = true;
+    pads_[pin].driven_level = level ? 1 : 0;
+    fire_if_matching(pin, before, this->level(pin));
+}
+
+void GpioEmulator::release(gpio_num_t pin)
+{
+    if (!valid(pin)) {
+        return;
+    }
+    uint32_t before = level(pin);
+    pads_[pin].driven = false;
+    fire_if_matching(pin, before, level(pin));
+}
+
+void GpioEmulator::set_mode(gpio_num_t pin, gpio_mode_t mode)
+{
+    uint64_t mask = bit(pin);
+    input_enable_ = (mode & GPIO_MODE_DEF_INPUT) ? (input_enable_ | mask) : (input_enable_ & ~mask);
+    output_enable_ = (mode & GPIO_MODE_DEF_OUTPUT) ? (output_enable_ | mask) : (output_enable_ & ~mask);
+    pads_[pin].open_drain = (mode & GPIO_MODE_DEF_OD) != 0;
+}
+
+void GpioEmulator::reset(gpio_num_t pin)
+{
+    // gpio_reset_pin: input only, pull-up on, no interrupt
+    uint64_t writes = pads_[pin].writes;
+    pads_[pin] = Pad();
+    pads_[pin].pull_up = true;
+    pads_[pin].intr_type = GPIO_INTR_DISABLE;
+    pads_[pin].writes = writes;
+    out_ &= ~bit(pin);
+    set_mode(pin, GPIO_MODE_INPUT);
+}
+
+void GpioEmulator::fire_if_matching(gpio_num_t pin, uint32_t before, uint32_t after)
+{
+    const Pad &pad = pads_[pin];
+    if (!isr_service_ || pad.handler == nullptr || !(input_enable_ & bit(pin))) {
+        return;
+    }
+
+    bool fire = false;
+    switch (pad.intr_type) {
+    case GPIO_INTR_POSEDGE:
+        fire = before == 0 && after == 1;
+        break;
+    case GPIO_INTR_NEGEDGE:
+        fire = before == 1 && after == 0;
+        break;
+    case GPIO_INTR_ANYEDGE:
+        fire = before != after;
+        break;
+    // A level interrupt fires again for as long as the level holds on a
+    // chip. Here it fires once, when the pad reaches the level.
+    case GPIO_INTR_HIGH_LEVEL:
+        fire = before == 0 && after == 1;
+        break;
+    case GPIO_INTR_LOW_LEVEL:
+        fire = before == 1 && after == 0;
+        break;
+    default:
+        break;
+    }
+    if (fire) {
+        interrupts_++;
+        pad.handler(pad.arg);
+    }
+}
+
+// ---------------------------------------------------------------
+// Driver functions
+// Same argument checks and return codes as the real driver.
+// ---------------------------------------------------------------
+
+esp_err_t GpioEmulator::on_config(const gpio_config_t *config, int)
+{
+    if (config == nullptr || config->pin_bit_mask == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint64_t valid_mask = (GPIO_NUM_MAX == 64) ? ~0ULL : (1ULL << GPIO_NUM_MAX) - 1;
+    if (config->pin_bit_mask & ~valid_mask) {
+        return ESP_ERR_INVALID_ARG; // "GPIO_PIN mask error", nothing is changed
+    }
+
+    for (int i = 0; i < GPIO_NUM_MAX; i++) {
+        gpio_num_t pin = static_cast<gpio_num_t>(i);
+        if (!(config->pin_bit_mask & bit(pin))) {
+            continue;
+        }
+        Pad &pad = active_->pads_[pin];
+        active_->set_mode(pin, config->mode);
+        pad.pull_up = config->pull_up_en == GPIO_PULLUP_ENABLE;
+        pad.pull_down = config->pull_down_en == GPIO_PULLDOWN_ENABLE;
+        pad.intr_type = config->intr_type;
+    }
+    return ESP_OK;
+}
+
+esp_err_t GpioEmulator::on_reset_pin(gpio_num_t pin, int)
+{
+    if (!valid(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    active_->reset(pin);
+    return ESP_OK;
+}
+
+esp_err_t GpioEmulator::on_set_direction(gpio_num_t pin, gpio_mode_t mode, int)
+{
+    if (!valid(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    active_->set_mode(pin, mode);
+    return ESP_OK;
+}
+
+esp_err_t GpioEmulator::on_set_level(gpio_num_t pin, uint32_t level, int)
+{
+    if (!valid(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t before = active_->level(pin);
+    if (level) {
+        active_->out_ |= bit(pin);
+    }
+    else {
+        active_->out_ &= ~bit(pin);
+    }
+    active_->pads_[pin].writes++;
+    active_->writes_++;
+    // An input/output pad sees its own edges, as on the chips
+    active_->fire_if_matching(pin, before, active_->level(pin));
+    return ESP_OK;
+}
+
+int GpioEmulator::on_get_level(gpio_num_t pin, int)
+{
+    if (!valid(pin) || !(active_->input_enable_ & bit(pin))) {
+        return 0;
+    }
+    return static_cast<int>(active_->level(pin));
+}
+
+esp_err_t GpioEmulator::on_set_pull_mode(gpio_num_t pin, gpio_pull_mode_t pull, int)
+{
+    if (!valid(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    Pad &pad = active_->pads_[pin];
+    pad.pull_up = pull == GPIO_PULLUP_ONLY || pull == GPIO_PULLUP_PULLDOWN;
+    pad.pull_down = pull == GPIO_PULLDOWN_ONLY || pull == GPIO_PULLUP_PULLDOWN;
+    return ESP_OK;
+}
+
+esp_err_t GpioEmulator::on_install_isr_service(int, int)
+{
+    if (active_->isr_service_) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    active_->isr_service_ = true;
+    return ESP_OK;
+}
+
+esp_err_t GpioEmulator::on_set_intr_type(gpio_num_t pin, gpio_int_type_t type, int)
+{
+    if (!valid(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    active_->pads_[pin].intr_type = type;
+    return ESP_OK;
+}
+
+esp_err_t GpioEmulator::on_isr_handler_add(gpio_num_t pin, gpio_isr_t handler, void *arg, int)
+{
+    if (!valid(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!active_->isr_service_) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    active_->pads_[pin].handler = handler;
+    active_->pads_[pin].arg = arg;
+    return ESP_OK;
+}
+
+esp_err_t GpioEmulator::on_isr_handler_remove(gpio_num_t pin, int)
+{
+    if (!valid(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!active_->isr_service_) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    active_->pads_[pin].handler = nullptr;
+    active_->pads_[pin].arg = nullptr;
+    return ESP_OK;
+}
@@ -0,0 +1,6 @@
+#include "mock_gpio_hal.hpp"
+
+MockGpioHal::MockGpioHal() = default;
+MockGpioHal::~MockGpioHal() = default;
+
+template class ::testing::NiceMock<MockGpioHal>;
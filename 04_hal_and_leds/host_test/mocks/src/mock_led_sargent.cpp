@@ -0,0 +1,6 @@
+#include "mock_led_sargent.hpp"
+
+MockLedSargent::MockLedSargent() = default;
+MockLedSargent::~MockLedSargent() = default;
+
+template class ::testing::NiceMock<MockLedSargent>;
@@ -0,0 +1,6 @@
+#include "mock_sum.hpp"
+
+MockSum::MockSum() = default;
+MockSum::~MockSum() = default;
+
+template class ::testing::NiceMock<MockSum>;
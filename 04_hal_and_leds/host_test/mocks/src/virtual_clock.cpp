@@ -0,0 +1,3 @@
+#include "virtual_clock.hpp"
+
+int64_t VirtualClock::now_us_ = 0;
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+
+#include "atomic_led_sink.hpp"
+#include "gpio_emulator.hpp"
+#include "gpio_hal.hpp"
+#include "led_sargent.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+#include "trace_replay.hpp"
+
+// ---------------------------------------------------------------
+// Replays a trace of (a, b) records through SumBoss.
+// app_main has no command line on the linux target, so the options
+// come from the environment:
+//
+//     REPLAY_TRACE   trace to replay (required)
+//     REPLAY_OUTPUT  results file to write, for diffing (optional)
+//     REPLAY_LEDS    sink (default): AtomicLedSink, counters only
+//                    gpio: LedSargent on GpioHal on GpioEmulator,
+//                    the whole driver path
+//     REPLAY_PATH    compute (default) or compute_isr
+//
+// tools/trace_tool.py makes traces and diffs results files.
+// ---------------------------------------------------------------
+
+#define GREEN_LED_PIN GPIO_NUM_4
+#define RED_LED_PIN GPIO_NUM_5
+
+static const char *env_or(const char *name, const char *fallback)
+{
+    const char *value = getenv(name);
+    return (value != nullptr && value[0] != '\0') ? value : fallback;
+}
+
+static void print_class(const char *name, uint64_t count, uint64_t total)
+{
+    printf("  %-20s %12llu  %6.2f%%\n", name, static_cast<unsigned long long>(count),
+           total != 0 ? 100.0 * count / total : 0.0);
+}
+
+static void replay_through(
+    ILedSargent &leds, TraceReplay::Path path, const MappedTrace &trace, BatchReply *out, ReplayReport &report)
+{
+    Sum sum;
+    SumBoss boss(sum, leds);
+    TraceReplay replay(boss, path);
+    replay.run(trace.records(), trace.count(), out, report);
+}
+
+static int replay()
+{
+    const char *trace_path = env_or("REPLAY_TRACE", nullptr);
+    const char *output_path = env_or("REPLAY_OUTPUT", nullptr);
+    const char *leds = env_or("REPLAY_LEDS", "sink");
+    const char *path_name = env_or("REPLAY_PATH", "compute");
+
+    if (trace_path == nullptr) {
+        printf("REPLAY_TRACE is not set\n");
+        return 1;
+    }
+    bool gpio = strcmp(leds, "gpio") == 0;
+    if (!gpio && strcmp(leds, "sink") != 0) {
+        printf("REPLAY_LEDS must be sink or gpio, not %s\n", leds);
+        return 1;
+    }
+    bool isr = strcmp(path_name, "compute_isr") == 0;
+    if (!isr && strcmp(path_name, "compute") != 0) {
+        printf("REPLAY_PATH must be compute or compute_isr, not %s\n", path_name);
+        return 1;
+    }
+
+    MappedTrace trace;
+    esp_err_t ret = trace.open(trace_path);
+    if (ret != ESP_OK) {
+        printf("%s: can't replay it (%s)\n", trace_path, esp_err_to_name(ret));
+        return 1;
+    }
+
+    MappedResults results;
+    if (output_path != nullptr) {
+        ret = results.create(output_path, trace.count());
+        if (ret != ESP_OK) {
+            printf("%s: can't create it\n", output_path);
+            return 1;
+        }
+    }
+
+    ReplayReport report;
+    TraceReplay::Path path = isr ? TraceReplay::COMPUTE_ISR : TraceReplay::COMPUTE;
+    BatchReply *out = (output_path != nullptr) ? results.records() : nullptr;
+    if (gpio) {
+        GpioEmulator emulator; // Attached before GpioHal touches the driver
+        GpioHal gpio_hal;
+        LedSargent led_sargent(gpio_hal, GREEN_LED_PIN, RED_LED_PIN);
+        replay_through(led_sargent, path, trace, out, report);
+    }
+    else {
+        AtomicLedSink sink;
+        replay_through(sink, path, trace, out, report);
+    }
+
+    int status = 0;
+    if (output_path != nullptr && results.close() != ESP_OK) {
+        printf("%s: can't write it back\n", output_path);
+        status = 1;
+    }
+
+    double ns = report.records != 0 ? report.seconds * 1e9 / report.records : 0;
+    printf("trace   %s, %llu records\n", trace_path, static_cast<unsigned long long>(report.records));
+    printf("stack   Sum + %s, SumBoss::%s\n", gpio ? "LedSargent/GpioHal/GpioEmulator" : "AtomicLedSink", path_name);
+    printf("time    %.3f s, %.2f ns/record, %.2f M records/s\n", report.seconds, ns,
+           report.seconds > 0 ? report.records / report.seconds / 1e6 : 0.0);
+    print_class("ESP_OK", report.successes, report.records);
+    print_class("ESP_FAIL", report.out_of_range, report.records);
+    print_class("ESP_ERR_INVALID_ARG", report.invalid_args, report.records);
+    print_class("other", report.other_errors, report.records);
+    printf("BENCH replay/%s/%s %.3f ns/record\n", leds, path_name, ns);
+    return status;
+}
+
+extern "C" void app_main(void)
+{
+    // Sum logs every failed sum: that would be I/O on every bad record
+    esp_log_level_set("*", ESP_LOG_NONE);
+    exit(replay());
+}
@@ -1,8 +1,17 @@
+#include <stdlib.h>
+
 #include "gtest/gtest.h"
 
+#include "timing_listener.hpp"
+
 extern "C" void app_main(void)
 {
     testing::InitGoogleTest();
+
+    // Times every test; see timing_listener.hpp for the two variables
+    testing::UnitTest::GetInstance()->listeners().Append(
+        new TimingListener(getenv("TEST_TIMING_JSON"), getenv("TEST_TIME_BUDGETS")));
+
     int result = RUN_ALL_TESTS();
     exit(result);
-}
\ No newline at end of file
+}
@@ -0,0 +1,252 @@
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "atomic_led_sink.hpp"
+#include "batch_protocol.hpp"
+#include "batch_server.hpp"
+#include "fd_stream.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+// -------------------------------------------------------------------
+// BatchParser — framing over a ByteRing
+// -------------------------------------------------------------------
+
+static std::vector<uint8_t> request(uint8_t seq, const std::vector<BatchPair> &pairs)
+{
+    std::vector<uint8_t> frame(BatchProtocol::frame_size(pairs.size()));
+    EXPECT_EQ(frame.size(), BatchProtocol::encode_request(seq, pairs.data(), pairs.size(), frame.data()));
+    return frame;
+}
+
+/**
+ * @test Verifies that an encoded request comes back out of the parser
+ *       with the same seq and pairs, read in place from the ring.
+ */
+TEST(BatchParserTest, RoundTrip)
+{
+    ByteRing ring;
+    BatchParser parser;
+    std::vector<BatchPair> pairs = {{1, 2}, {-3, 4}, {100000, -7}};
+    std::vector<uint8_t> frame = request(42, pairs);
+    ASSERT_EQ(frame.size(), ring.write(frame.data(), frame.size()));
+
+    BatchFrame parsed;
+    ASSERT_TRUE(parser.next(ring, parsed));
+    EXPECT_EQ(BatchProtocol::REQUEST, parsed.type);
+    EXPECT_EQ(42, parsed.seq);
+    ASSERT_EQ(3, parsed.count);
+    for (size_t i = 0; i < pairs.size(); i++) {
+        EXPECT_EQ(pairs[i].a, parsed.pair(i).a);
+        EXPECT_EQ(pairs[i].b, parsed.pair(i).b);
+    }
+    ring.consume(parsed.size());
+    EXPECT_EQ(0u, ring.size());
+    EXPECT_FALSE(parser.next(ring, parsed));
+}
+
+/**
+ * @test Verifies that a frame arriving one byte at a time is only
+ *       reported once it is complete.
+ */
+TEST(BatchParserTest, WaitsForTheWholeFrame)
+{
+    ByteRing ring;
+    BatchParser parser;
+    std::vector<uint8_t> frame = request(1, {{5, 5}, {6, 6}});
+
+    BatchFrame parsed;
+    for (size_t i = 0; i < frame.size() - 1; i++) {
+        ring.write(&frame[i], 1);
+        EXPECT_FALSE(parser.next(ring, parsed)) << "after " << i + 1 << " bytes";
+    }
+    ring.write(&frame.back(), 1);
+    EXPECT_TRUE(parser.next(ring, parsed));
+    EXPECT_EQ(0u, parser.skipped());
+}
+
+/**
+ * @test Verifies that garbage, a false magic and a frame with a flipped
+ *       bit are skipped, and the good frame after them is found.
+ */
+TEST(BatchParserTest, ResyncsAfterGarbage)
+{
+    ByteRing ring;
+    BatchParser parser;
+    const uint8_t garbage[] = {0x00, 'S', 'x', 'S', 'B', 9, 0, 0, 0, 0}; // 'S' 'B' with type 9
+    std::vector<uint8_t> corrupt = request(1, {{1, 1}});
+    corrupt[BatchProtocol::HEADER_SIZE] ^= 0x10;
+    std::vector<uint8_t> good = request(2, {{2, 2}});
+
+    ring.write(garbage, sizeof(garbage));
+    ring.write(corrupt.data(), corrupt.size());
+    ring.write(good.data(), good.size());
+
+    BatchFrame parsed;
+    ASSERT_TRUE(parser.next(ring, parsed));
+    EXPECT_EQ(2, parsed.seq);
+    EXPECT_EQ(2, parsed.pair(0).a);
+    EXPECT_EQ(1u, parser.bad_crc());
+    EXPECT_EQ(sizeof(garbage) + corrupt.size(), parser.skipped());
+}
+
+/**
+ * @test Verifies that frames are read correctly when they wrap around
+ *       the end of the ring storage, at every possible split.
+ */
+TEST(BatchParserTest, FramesAcrossTheWrap)
+{
+    ByteRing ring;
+    BatchParser parser;
+    std::vector<uint8_t> frame = request(7, {{1, 2}, {3, 4}, {5, 6}});
+
+    // Moves the ring's start without parsing anything
+    std::vector<uint8_t> filler(ByteRing::SIZE);
+    auto advance = [&](size_t length) {
+        ring.write(filler.data(), length);
+        ring.consume(length);
+    };
+
+    // Each frame starts one byte further than the last, from ending right
+    // at the end of the storage to starting right at its start
+    advance(ByteRing::SIZE - frame.size());
+    for (size_t split = 0; split <= frame.size(); split++) {
+        ASSERT_EQ(frame.size(), ring.write(frame.data(), frame.size()));
+        BatchFrame parsed;
+        ASSERT_TRUE(parser.next(ring, parsed)) << "split " << split;
+        EXPECT_EQ(5, parsed.pair(2).a);
+        EXPECT_EQ(6, parsed.pair(2).b);
+        ring.consume(parsed.size());
+        advance(ByteRing::SIZE - frame.size() + 1);
+    }
+    EXPECT_EQ(0u, parser.skipped());
+}
+
+/**
+ * @test Verifies that frames over MAX_BATCH can't be encoded, and that a
+ *       header claiming more is treated as garbage.
+ */
+TEST(BatchParserTest, RejectsOversizedBatches)
+{
+    std::vector<BatchPair> pairs(BatchProtocol::MAX_BATCH + 1);
+    std::vector<uint8_t> frame(BatchProtocol::frame_size(pairs.size()));
+    EXPECT_EQ(0u, BatchProtocol::encode_request(0, pairs.data(), pairs.size(), frame.data()));
+
+    ByteRing ring;
+    BatchParser parser;
+    const uint8_t header[] = {'S', 'B', BatchProtocol::REQUEST, 0, 0x01, 0x01, 0, 0}; // 257 records
+    ring.write(header, sizeof(header));
+    BatchFrame parsed;
+    EXPECT_FALSE(parser.next(ring, parsed));
+    EXPECT_EQ(sizeof(header), parser.skipped());
+}
+
+// -------------------------------------------------------------------
+// BatchServer — end to end over a socket pair
+// -------------------------------------------------------------------
+
+class BatchServerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds_));
+        server_thread_ = std::thread([this] {
+            FdStream stream(fds_[1], fds_[1]);
+            BatchServer server(stream, boss_);
+            while (server.poll(100) != ESP_ERR_INVALID_STATE) {
+            }
+        });
+    }
+
+    void TearDown() override
+    {
+        shutdown(fds_[0], SHUT_WR); // End of file for the server
+        server_thread_.join();
+        close(fds_[0]);
+        close(fds_[1]);
+    }
+
+    // Sends a request and reads its reply with the same parser the server uses
+    bool round_trip(uint8_t seq, const std::vector<BatchPair> &pairs, std::vector<BatchReply> &replies)
+    {
+        std::vector<uint8_t> frame = request(seq, pairs);
+        FdStream client(fds_[0], fds_[0]);
+        if (client.write(frame.data(), frame.size()) != static_cast<int>(frame.size())) {
+            return false;
+        }
+        BatchFrame reply;
+        while (!parser_.next(ring_, reply)) {
+            size_t span;
+            uint8_t *free = ring_.free_span(span);
+            int n = client.read(free, span, 1000);
+            if (n <= 0) {
+                return false;
+            }
+            ring_.produce(static_cast<size_t>(n));
+        }
+        replies.clear();
+        for (size_t i = 0; i < reply.count; i++) {
+            replies.push_back(reply.reply(i));
+        }
+        bool ok = reply.type == BatchProtocol::REPLY && reply.seq == seq;
+        ring_.consume(reply.size());
+        return ok;
+    }
+
+    Sum sum_;
+    AtomicLedSink leds_;
+    SumBoss boss_{sum_, leds_};
+    int fds_[2];
+    std::thread server_thread_;
+    ByteRing ring_;
+    BatchParser parser_;
+};
+
+/**
+ * @test Verifies that every pair is answered, in order, with exactly what
+ *       SumBoss::compute returns for it, and that the LEDs saw them all.
+ */
+TEST_F(BatchServerTest, RepliesMatchCompute)
+{
+    std::vector<BatchPair> pairs;
+    for (int a = -1; a <= 11; a++) {
+        for (int b = -1; b <= 11; b++) {
+            pairs.push_back({a, b});
+        }
+    }
+
+    std::vector<BatchReply> replies;
+    ASSERT_TRUE(round_trip(9, pairs, replies));
+    ASSERT_EQ(pairs.size(), replies.size());
+
+    Sum reference;
+    for (size_t i = 0; i < pairs.size(); i++) {
+        int expected;
+        esp_err_t err = reference.add_constrained_err_isr(pairs[i].a, pairs[i].b, expected);
+        EXPECT_EQ(err, replies[i].err) << pairs[i].a << " + " << pairs[i].b;
+        EXPECT_EQ(expected, replies[i].result) << pairs[i].a << " + " << pairs[i].b;
+    }
+    EXPECT_EQ(pairs.size(), leds_.greens() + leds_.reds());
+}
+
+/**
+ * @test Verifies that an empty batch gets an empty reply, and that many
+ *       batches in a row keep their seq.
+ */
+TEST_F(BatchServerTest, ManyBatchesInARow)
+{
+    std::vector<BatchReply> replies;
+    ASSERT_TRUE(round_trip(0, {}, replies));
+    EXPECT_TRUE(replies.empty());
+
+    std::vector<BatchPair> pairs(BatchProtocol::MAX_BATCH, BatchPair{3, 4});
+    for (int i = 1; i <= 300; i++) {
+        ASSERT_TRUE(round_trip(static_cast<uint8_t>(i), pairs, replies)) << "batch " << i;
+        ASSERT_EQ(7, replies.back().result);
+    }
+}
@@ -0,0 +1,220 @@
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "atomic_led_sink.hpp"
+#include "block_pool.hpp"
+#include "compute_request.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+// -------------------------------------------------------------------
+// BlockPool
+// -------------------------------------------------------------------
+
+struct Tracked
+{
+    static int alive;
+    int value;
+    explicit Tracked(int v)
+        : value(v)
+    {
+        alive++;
+    }
+    ~Tracked() { alive--; }
+};
+int Tracked::alive = 0;
+
+/**
+ * @test Verifies that every block can be allocated once, each one is
+ *       distinct and aligned, and the next allocation fails.
+ */
+TEST(BlockPoolTest, AllocatesUntilExhausted)
+{
+    static BlockPool<double, 8> pool;
+    std::set<void *> blocks;
+
+    for (size_t i = 0; i < pool.capacity(); i++) {
+        void *block = pool.allocate();
+        ASSERT_NE(nullptr, block);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % alignof(double));
+        blocks.insert(block);
+    }
+    EXPECT_EQ(pool.capacity(), blocks.size());
+    EXPECT_EQ(nullptr, pool.allocate());
+
+    for (void *block : blocks) {
+        EXPECT_EQ(ESP_OK, pool.deallocate(block));
+    }
+}
+
+/**
+ * @test Verifies that a freed block is handed out again, so an exhausted
+ *       pool recovers as soon as one block comes back.
+ */
+TEST(BlockPoolTest, FreedBlockIsReused)
+{
+    static BlockPool<int, 2> pool;
+    void *first = pool.allocate();
+    void *second = pool.allocate();
+    ASSERT_EQ(nullptr, pool.allocate());
+
+    EXPECT_EQ(ESP_OK, pool.deallocate(first));
+    EXPECT_EQ(first, pool.allocate());
+
+    pool.deallocate(first);
+    pool.deallocate(second);
+}
+
+/**
+ * @test Verifies that create() constructs and destroy() destructs.
+ */
+TEST(BlockPoolTest, CreateAndDestroyRunConstructors)
+{
+    static BlockPool<Tracked, 4> pool;
+    Tracked::alive = 0;
+
+    Tracked *object = pool.create(42);
+    ASSERT_NE(nullptr, object);
+    EXPECT_EQ(42, object->value);
+    EXPECT_EQ(1, Tracked::alive);
+
+    EXPECT_EQ(ESP_OK, pool.destroy(object));
+    EXPECT_EQ(0, Tracked::alive);
+}
+
+/**
+ * @test Verifies that pointers that aren't one of the pool's blocks are
+ *       rejected, and that nullptr is ignored like free() does.
+ */
+TEST(BlockPoolTest, RejectsForeignPointers)
+{
+    static BlockPool<uint32_t, 4> pool;
+    uint32_t outside = 0;
+    uint8_t *block = static_cast<uint8_t *>(pool.allocate());
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pool.deallocate(&outside));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, pool.deallocate(block + 1));
+    EXPECT_EQ(ESP_OK, pool.deallocate(nullptr));
+    EXPECT_EQ(ESP_OK, pool.deallocate(block));
+}
+
+/**
+ * @test Verifies that with per-core caches, one thread can still take
+ *       every block: an empty cache borrows from the others.
+ */
+TEST(BlockPoolTest, CachesShareTheCapacity)
+{
+    static BlockPool<int, 10, 4> pool;
+    std::vector<void *> blocks;
+
+    for (size_t i = 0; i < 10; i++) {
+        void *block = pool.allocate();
+        ASSERT_NE(nullptr, block);
+        blocks.push_back(block);
+    }
+    EXPECT_EQ(nullptr, pool.allocate());
+
+    for (void *block : blocks) {
+        pool.deallocate(block);
+    }
+}
+
+/**
+ * @test Verifies that threads allocating and freeing at the same time
+ *       never get the same block twice: each thread stamps its block and
+ *       checks the stamp is still there before giving it back.
+ */
+TEST(BlockPoolTest, ConcurrentUseNeverSharesABlock)
+{
+    static BlockPool<std::atomic<int>, 16, 2> pool;
+    std::atomic<int> collisions(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t <= 4; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 20000; i++) {
+                std::atomic<int> *block = pool.create(t);
+                if (block == nullptr) {
+                    continue; // Exhausted for a moment, the others hold every block
+                }
+                std::this_thread::yield();
+                if (block->exchange(0) != t) {
+                    collisions++;
+                }
+                pool.destroy(block);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(0, collisions.load());
+    std::vector<void *> blocks;
+    for (void *block = pool.allocate(); block != nullptr; block = pool.allocate()) {
+        blocks.push_back(block);
+    }
+    EXPECT_EQ(16u, blocks.size()); // Nothing was lost
+    for (void *block : blocks) {
+        pool.deallocate(block);
+    }
+}
+
+// -------------------------------------------------------------------
+// ComputeRequest
+// -------------------------------------------------------------------
+
+/**
+ * @test Verifies that SumBoss::process fills the request and calls its
+ *       completion, which can give it back to the pool.
+ */
+TEST(ComputeRequestTest, ProcessCompletesAndReleases)
+{
+    Sum sum;
+    AtomicLedSink leds;
+    SumBoss boss(sum, leds);
+
+    struct Completion
+    {
+        int result;
+        esp_err_t err;
+    } completion = {0, ESP_FAIL};
+
+    ComputeRequest *request = compute_request_pool().create();
+    ASSERT_NE(nullptr, request);
+    request->a = 3;
+    request->b = 4;
+    request->ctx = &completion;
+    request->on_done = [](ComputeRequest &done, void *ctx) {
+        Completion *completion = static_cast<Completion *>(ctx);
+        completion->result = done.result;
+        completion->err = done.err;
+        compute_request_pool().destroy(&done);
+    };
+
+    EXPECT_EQ(ESP_OK, boss.process(*request));
+    EXPECT_EQ(7, completion.result);
+    EXPECT_EQ(ESP_OK, completion.err);
+    EXPECT_EQ(1u, leds.greens());
+}
+
+/**
+ * @test Verifies that the component's pool holds exactly
+ *       CONFIG_HAL_AND_LEDS_REQUEST_POOL_SIZE requests.
+ */
+TEST(ComputeRequestTest, PoolSizeComesFromKconfig)
+{
+    std::vector<ComputeRequest *> requests;
+    for (ComputeRequest *r = compute_request_pool().create(); r != nullptr; r = compute_request_pool().create()) {
+        requests.push_back(r);
+    }
+
+    EXPECT_EQ(static_cast<size_t>(CONFIG_HAL_AND_LEDS_REQUEST_POOL_SIZE), requests.size());
+    for (ComputeRequest *r : requests) {
+        compute_request_pool().destroy(r);
+    }
+}
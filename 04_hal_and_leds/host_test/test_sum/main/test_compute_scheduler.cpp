@@ -0,0 +1,181 @@
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "atomic_led_sink.hpp"
+#include "compute_scheduler.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+// -------------------------------------------------------------------
+// ComputeScheduler and ComputeTask
+// -------------------------------------------------------------------
+// The coroutines are free functions: their arguments are copied into the
+// frame, so they take pointers to what the test checks afterwards.
+
+class ComputeSchedulerTest : public ::testing::Test
+{
+protected:
+    Sum sum_;
+    AtomicLedSink leds_;
+    SumBoss boss_{sum_, leds_};
+    ComputeScheduler scheduler_{boss_};
+};
+
+// Awaits one compute, and notes whether the LED had changed by then
+static ComputeTask compute_once(ComputeScheduler &scheduler, int a, int b, ComputeResult *out,
+                                const AtomicLedSink *leds, int *led_calls_at_resume)
+{
+    *out = co_await scheduler.compute_async(a, b);
+    *led_calls_at_resume = leds->greens() + leds->reds();
+}
+
+// Chains results like sequential code, stopping at the first error
+static ComputeTask compute_chain(ComputeScheduler &scheduler, std::vector<ComputeResult> *results)
+{
+    const int addends[] = {2, 3, 9, 1};
+    int total = 1;
+    for (int addend : addends) {
+        ComputeResult r = co_await scheduler.compute_async(total, addend);
+        results->push_back(r);
+        if (r.err != ESP_OK) {
+            co_return;
+        }
+        total = r.result;
+    }
+}
+
+// Two awaits, each one logged with the name of the coroutine
+static ComputeTask compute_twice(ComputeScheduler &scheduler, char name, std::string *log)
+{
+    for (int i = 1; i <= 2; i++) {
+        ComputeResult r = co_await scheduler.compute_async(i, i);
+        log->push_back(name);
+        log->push_back(static_cast<char>('0' + r.result));
+    }
+}
+
+// Keeps a big array across the co_await, so its frame can't fit a block
+static ComputeTask big_frame(ComputeScheduler &scheduler)
+{
+    volatile char buffer[CONFIG_HAL_AND_LEDS_COROUTINE_FRAME_SIZE];
+    buffer[0] = 1;
+    co_await scheduler.compute_async(1, 1);
+    buffer[1] = buffer[0];
+}
+
+// Gives done after one compute, from the scheduler's task
+static ComputeTask compute_and_give(ComputeScheduler &scheduler, ComputeResult *out, SemaphoreHandle_t done)
+{
+    *out = co_await scheduler.compute_async(4, 5);
+    xSemaphoreGive(done);
+}
+
+/**
+ * @test Verifies that a spawned coroutine only starts on the scheduler,
+ *       and that co_await compute_async() resumes it with the result once
+ *       the LED call has returned.
+ */
+TEST_F(ComputeSchedulerTest, AwaitResumesAfterTheLed)
+{
+    ComputeResult result = {ESP_FAIL, 0};
+    int led_calls = -1;
+    ASSERT_EQ(ESP_OK, scheduler_.spawn(compute_once(scheduler_, 3, 4, &result, &leds_, &led_calls)));
+    EXPECT_EQ(-1, led_calls); // Not started yet
+
+    EXPECT_EQ(2u, scheduler_.run_ready()); // The start, then the compute
+    EXPECT_EQ(ESP_OK, result.err);
+    EXPECT_EQ(7, result.result);
+    EXPECT_EQ(1, led_calls);
+    EXPECT_EQ(AtomicLedSink::GREEN, leds_.state());
+    EXPECT_EQ(0u, scheduler_.run_ready());
+}
+
+/**
+ * @test Verifies that awaits chain like sequential code: each result feeds
+ *       the next compute, and the error ends the coroutine.
+ */
+TEST_F(ComputeSchedulerTest, AwaitsChainLikeSequentialCode)
+{
+    std::vector<ComputeResult> results;
+    ASSERT_EQ(ESP_OK, scheduler_.spawn(compute_chain(scheduler_, &results)));
+    scheduler_.run_ready();
+
+    ASSERT_EQ(3u, results.size());
+    EXPECT_EQ(3, results[0].result);
+    EXPECT_EQ(6, results[1].result);
+    EXPECT_EQ(ESP_FAIL, results[2].err); // 6 + 9 is out of range
+    EXPECT_EQ(AtomicLedSink::RED, leds_.state());
+}
+
+/**
+ * @test Verifies that coroutines share the scheduler: while one waits for
+ *       its compute, the other runs, in the order their requests came.
+ */
+TEST_F(ComputeSchedulerTest, CoroutinesInterleave)
+{
+    std::string log;
+    ASSERT_EQ(ESP_OK, scheduler_.spawn(compute_twice(scheduler_, 'a', &log)));
+    ASSERT_EQ(ESP_OK, scheduler_.spawn(compute_twice(scheduler_, 'b', &log)));
+    scheduler_.run_ready();
+    EXPECT_EQ("a2b2a4b4", log);
+}
+
+/**
+ * @test Verifies that frames only come from coroutine_frame_pool(): a full
+ *       pool or a frame too big gives an invalid task that spawn() refuses,
+ *       and finished or never spawned coroutines give their frames back.
+ */
+TEST_F(ComputeSchedulerTest, FramesComeFromThePool)
+{
+    {
+        ComputeTask unspawned[CONFIG_HAL_AND_LEDS_COROUTINE_FRAMES];
+        for (ComputeTask &task : unspawned) {
+            task = compute_twice(scheduler_, 'x', nullptr);
+            ASSERT_TRUE(task.valid());
+        }
+        ComputeTask one_more = compute_twice(scheduler_, 'x', nullptr);
+        EXPECT_FALSE(one_more.valid());
+        EXPECT_EQ(ESP_ERR_NO_MEM, scheduler_.spawn(std::move(one_more)));
+    } // Never spawned: destroyed, frames back to the pool
+
+    ComputeTask too_big = big_frame(scheduler_);
+    EXPECT_FALSE(too_big.valid());
+
+    std::string log;
+    for (int i = 0; i < CONFIG_HAL_AND_LEDS_COROUTINE_FRAMES; i++) {
+        ASSERT_EQ(ESP_OK, scheduler_.spawn(compute_twice(scheduler_, 'a' + i, &log)));
+    }
+    scheduler_.run_ready();
+    EXPECT_EQ(static_cast<size_t>(4 * CONFIG_HAL_AND_LEDS_COROUTINE_FRAMES), log.size());
+
+    // Finished: every frame is free again
+    ComputeTask again[CONFIG_HAL_AND_LEDS_COROUTINE_FRAMES];
+    for (ComputeTask &task : again) {
+        task = compute_twice(scheduler_, 'x', nullptr);
+        EXPECT_TRUE(task.valid());
+    }
+}
+
+/**
+ * @test Verifies the FreeRTOS task: after start(), coroutines run without
+ *       anyone calling run_ready(), and stop() ends the task.
+ */
+TEST_F(ComputeSchedulerTest, RunsOnItsOwnTask)
+{
+    SemaphoreHandle_t done = xSemaphoreCreateBinary();
+    ASSERT_EQ(ESP_OK, scheduler_.start());
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, scheduler_.start());
+
+    ComputeResult result = {ESP_FAIL, 0};
+    ASSERT_EQ(ESP_OK, scheduler_.spawn(compute_and_give(scheduler_, &result, done)));
+    ASSERT_EQ(pdTRUE, xSemaphoreTake(done, pdMS_TO_TICKS(1000)));
+    EXPECT_EQ(ESP_OK, result.err);
+    EXPECT_EQ(9, result.result);
+
+    scheduler_.stop();
+    EXPECT_EQ(ESP_OK, scheduler_.start()); // Can start again after a stop
+    scheduler_.stop();
+    vSemaphoreDelete(done);
+}
@@ -0,0 +1,153 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "dedic_gpio_hal.hpp"
+#include "led_sargent.hpp"
+#include "mock_gpio_hal.hpp"
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+// -------------------------------------------------------------------
+// DedicGpioHal — pin to bundle bit mapping
+// -------------------------------------------------------------------
+// The linux target has no dedicated GPIO, so these tests only cover the
+// mapping logic. Without a bundle the constructor sets the pads up through
+// the fallback, so each test hands it a NiceMock<MockGpioHal> instead of a
+// GpioHal on the driver mock.
+
+/**
+ * @test Verifies that there is no bundle on the host, so every write
+ *       falls back.
+ */
+TEST(DedicGpioHalTest, NoBundleOnHost)
+{
+    NiceMock<MockGpioHal> fallback;
+    const gpio_num_t pins[] = {GPIO_NUM_4, GPIO_NUM_5};
+    DedicGpioHal hal(pins, 2, fallback);
+
+    EXPECT_FALSE(hal.has_bundle());
+}
+
+/**
+ * @test Verifies that pins are mapped to bundle bits in the order they
+ *       were given to the constructor.
+ */
+TEST(DedicGpioHalTest, PinMaskFollowsConstructionOrder)
+{
+    NiceMock<MockGpioHal> fallback;
+    const gpio_num_t pins[] = {GPIO_NUM_5, GPIO_NUM_2, GPIO_NUM_4};
+    DedicGpioHal hal(pins, 3, fallback);
+
+    EXPECT_EQ(0b001u, hal.pin_mask(GPIO_NUM_5));
+    EXPECT_EQ(0b010u, hal.pin_mask(GPIO_NUM_2));
+    EXPECT_EQ(0b100u, hal.pin_mask(GPIO_NUM_4));
+}
+
+/**
+ * @test Verifies that a pin outside the bundle has an empty mask.
+ */
+TEST(DedicGpioHalTest, UnmappedPinHasEmptyMask)
+{
+    NiceMock<MockGpioHal> fallback;
+    const gpio_num_t pins[] = {GPIO_NUM_4, GPIO_NUM_5};
+    DedicGpioHal hal(pins, 2, fallback);
+
+    EXPECT_EQ(0u, hal.pin_mask(GPIO_NUM_2));
+}
+
+/**
+ * @test Verifies that only the first MAX_PINS pins are mapped.
+ */
+TEST(DedicGpioHalTest, ExtraPinsAreNotMapped)
+{
+    NiceMock<MockGpioHal> fallback;
+    const gpio_num_t pins[] = {
+        GPIO_NUM_0,
+        GPIO_NUM_1,
+        GPIO_NUM_2,
+        GPIO_NUM_3,
+        GPIO_NUM_4,
+        GPIO_NUM_5,
+        GPIO_NUM_6,
+        GPIO_NUM_7,
+        GPIO_NUM_8};
+    DedicGpioHal hal(pins, 9, fallback);
+
+    EXPECT_EQ(1u << 7, hal.pin_mask(GPIO_NUM_7));
+    EXPECT_EQ(0u, hal.pin_mask(GPIO_NUM_8));
+}
+
+/**
+ * @test Verifies that write_mask() rejects bits that don't belong to any
+ *       mapped pin, before touching the driver.
+ */
+TEST(DedicGpioHalTest, WriteMaskRejectsUnmappedBits)
+{
+    NiceMock<MockGpioHal> fallback;
+    const gpio_num_t pins[] = {GPIO_NUM_4, GPIO_NUM_5};
+    DedicGpioHal hal(pins, 2, fallback);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, hal.write_mask(0b100, 0b100));
+}
+
+// -------------------------------------------------------------------
+// DedicGpioHal — pad direction of the mapped pins
+// -------------------------------------------------------------------
+
+/**
+ * @test Verifies that the mapped pins are made outputs once, in the
+ *       constructor, and that pin_set_direction() on them, as LedSargent
+ *       calls it, never reaches the fallback again. On a chip that would
+ *       route the pads away from the bundle. Unmapped pins still go
+ *       through the fallback.
+ */
+TEST(DedicGpioHalTest, MappedPinDirectionNeverReachesFallback)
+{
+    MockGpioHal fallback;
+    // No bundle on the host: the constructor sets the pads up through the fallback
+    EXPECT_CALL(fallback, pin_set_direction(GPIO_NUM_4, GPIO_MODE_OUTPUT)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(fallback, pin_set_direction(GPIO_NUM_5, GPIO_MODE_OUTPUT)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(fallback, pin_set_direction(GPIO_NUM_2, GPIO_MODE_INPUT)).WillOnce(Return(ESP_OK));
+
+    const gpio_num_t pins[] = {GPIO_NUM_4, GPIO_NUM_5};
+    DedicGpioHal hal(pins, 2, fallback);
+    LedSargent led_sargent(hal, GPIO_NUM_4, GPIO_NUM_5);
+
+    EXPECT_EQ(ESP_OK, hal.pin_set_direction(GPIO_NUM_4, GPIO_MODE_OUTPUT));
+    EXPECT_EQ(ESP_OK, hal.pin_set_direction(GPIO_NUM_2, GPIO_MODE_INPUT));
+}
+
+/**
+ * @test Verifies that a mapped pin refuses any mode but output: the pad
+ *       can't become an input without leaving the bundle, and the call
+ *       still doesn't reach the fallback.
+ */
+TEST(DedicGpioHalTest, MappedPinRejectsOtherModes)
+{
+    MockGpioHal fallback;
+    EXPECT_CALL(fallback, pin_set_direction(_, GPIO_MODE_OUTPUT)).Times(2).WillRepeatedly(Return(ESP_OK));
+
+    const gpio_num_t pins[] = {GPIO_NUM_4, GPIO_NUM_5};
+    DedicGpioHal hal(pins, 2, fallback);
+
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, hal.pin_set_direction(GPIO_NUM_4, GPIO_MODE_INPUT));
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, hal.pin_set_direction(GPIO_NUM_5, GPIO_MODE_INPUT_OUTPUT));
+}
+
+/**
+ * @test Verifies that a failed pad setup in the constructor is returned
+ *       by pin_set_direction() on a mapped pin.
+ */
+TEST(DedicGpioHalTest, MappedPinReturnsSetupError)
+{
+    MockGpioHal fallback;
+    EXPECT_CALL(fallback, pin_set_direction(GPIO_NUM_4, _)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(fallback, pin_set_direction(GPIO_NUM_5, _)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+
+    const gpio_num_t pins[] = {GPIO_NUM_4, GPIO_NUM_5};
+    DedicGpioHal hal(pins, 2, fallback);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, hal.pin_set_direction(GPIO_NUM_4, GPIO_MODE_OUTPUT));
+}
@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+
+#include "demo_sequence.hpp"
+#include "recording_gpio_hal.hpp"
+#include "virtual_clock.hpp"
+
+// -------------------------------------------------------------------
+// DemoSequence — the test_build app on a virtual clock
+// -------------------------------------------------------------------
+// Same sequence as on the board, but every delay returns at once and
+// moves VirtualClock forward. The recorded trace says which LED was on
+// and when, in the app's own timeline.
+
+#define GREEN GPIO_NUM_4
+#define RED GPIO_NUM_5
+
+// A pass over the cases: each one holds its LED, clears it, then pauses
+static const int64_t PASS_US =
+    DemoSequence::CASE_COUNT * (DemoSequence::RESULT_DELAY_MS + DemoSequence::INTER_DELAY_MS) * 1000;
+
+class DemoSequenceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override { VirtualClock::reset(); }
+
+    RecordingGpioHal hal{VirtualClock::now_us};
+    DemoSequence demo{hal, GREEN, RED, VirtualClock::delay_ms};
+};
+
+/**
+ * @test Verifies the LED test of section 3: green at 4 s, red 500 ms later,
+ *       both off 500 ms after that, and 7 s of virtual time in total.
+ */
+TEST_F(DemoSequenceTest, IntroTimeline)
+{
+    demo.run_intro();
+
+    const RecordingGpioHal::Write expected[] = {
+        {4000000, GREEN, 0}, // off() before the test
+        {4000000, RED, 0},
+        {4000000, GREEN, 1}, // green()
+        {4500000, RED, 1},   // red(), green is still on
+        {5000000, GREEN, 0}, // off()
+        {5000000, RED, 0},
+    };
+    ASSERT_EQ(6u, hal.writes().size());
+    for (size_t i = 0; i < 6; i++) {
+        EXPECT_EQ(expected[i].time_us, hal.writes()[i].time_us) << "write " << i;
+        EXPECT_EQ(expected[i].pin, hal.writes()[i].pin) << "write " << i;
+        EXPECT_EQ(expected[i].level, hal.writes()[i].level) << "write " << i;
+    }
+    EXPECT_EQ(7000000, VirtualClock::now_us());
+}
+
+/**
+ * @test Verifies that each case lights the right LED at the start of its
+ *       slot, and clears it RESULT_DELAY_MS later.
+ */
+TEST_F(DemoSequenceTest, CasesLightTheRightLed)
+{
+    // Only {1, 2} and {5, 5} fit Sum's constraints
+    const gpio_num_t lit[] = {GREEN, RED, GREEN, RED, RED};
+
+    EXPECT_EQ(3u, demo.run_cases());
+
+    // Per case: the LED, then off() writes green and red
+    ASSERT_EQ(DemoSequence::CASE_COUNT * 3, hal.writes().size());
+    for (size_t i = 0; i < DemoSequence::CASE_COUNT; i++) {
+        int64_t slot = i * (DemoSequence::RESULT_DELAY_MS + DemoSequence::INTER_DELAY_MS) * 1000;
+        const RecordingGpioHal::Write &on = hal.writes()[i * 3];
+
+        EXPECT_EQ(slot, on.time_us) << "case " << i;
+        EXPECT_EQ(lit[i], on.pin) << "case " << i;
+        EXPECT_EQ(1u, on.level) << "case " << i;
+        EXPECT_EQ(slot + DemoSequence::RESULT_DELAY_MS * 1000, hal.writes()[i * 3 + 1].time_us) << "case " << i;
+    }
+    EXPECT_EQ(PASS_US, VirtualClock::now_us());
+}
+
+/**
+ * @test Verifies that the app's loop holds up over a long run: a day of
+ *       virtual time, with the LEDs off between passes. It takes
+ *       milliseconds instead of 24 hours.
+ */
+TEST_F(DemoSequenceTest, DayOfVirtualTime)
+{
+    const int64_t DAY_US = 24LL * 3600 * 1000000;
+    size_t passes = 0;
+
+    demo.run_intro();
+    int64_t start = VirtualClock::now_us();
+    while (VirtualClock::now_us() - start < DAY_US) {
+        hal.clear(); // Keep memory flat, only the last pass is checked
+        EXPECT_EQ(3u, demo.run_cases());
+        passes++;
+    }
+
+    EXPECT_EQ(static_cast<size_t>((DAY_US + PASS_US - 1) / PASS_US), passes);
+    EXPECT_EQ(0, hal.pin_get_level(GREEN));
+    EXPECT_EQ(0, hal.pin_get_level(RED));
+}
@@ -0,0 +1,184 @@
+#include "gtest/gtest.h"
+
+#include "gpio_emulator.hpp"
+#include "gpio_hal.hpp"
+#include "led_sargent.hpp"
+#include "operand_input.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+#include "timing_listener.hpp"
+#include "virtual_clock.hpp"
+
+// -------------------------------------------------------------------
+// GpioEmulator — the real GpioHal against an emulated peripheral
+// -------------------------------------------------------------------
+// Nothing is mocked above the driver here: GpioHal calls gpio_*, and
+// the emulator answers like the hardware would.
+
+#define GREEN GPIO_NUM_4
+#define RED GPIO_NUM_5
+
+/**
+ * @test Verifies that GpioHal writes end up in the output and enable
+ *       registers, and that an output-only pad reads 0 while an
+ *       input/output pad reads back its own level.
+ */
+TEST(GpioEmulatorTest, GpioHalWritesTheRegisters)
+{
+    GpioEmulator gpio;
+    GpioHal hal;
+
+    EXPECT_EQ(ESP_OK, hal.pin_set_direction(GREEN, GPIO_MODE_OUTPUT));
+    EXPECT_EQ(ESP_OK, hal.pin_set_direction(RED, GPIO_MODE_INPUT_OUTPUT));
+    EXPECT_EQ(ESP_OK, hal.pin_set_level(GREEN, 1));
+    EXPECT_EQ(ESP_OK, hal.pin_set_level(RED, 1));
+
+    EXPECT_EQ((1ULL << GREEN) | (1ULL << RED), gpio.out_reg() & ((1ULL << GREEN) | (1ULL << RED)));
+    EXPECT_TRUE(gpio.enable_reg() & (1ULL << GREEN));
+    EXPECT_EQ(1u, gpio.level(GREEN));
+    EXPECT_EQ(0, hal.pin_get_level(GREEN)); // Input disabled
+    EXPECT_EQ(1, hal.pin_get_level(RED));
+}
+
+/**
+ * @test Verifies that invalid pins get the driver's ESP_ERR_INVALID_ARG.
+ */
+TEST(GpioEmulatorTest, InvalidPinIsRejected)
+{
+    GpioEmulator gpio;
+    GpioHal hal;
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, hal.pin_set_direction(GPIO_NUM_NC, GPIO_MODE_OUTPUT));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, hal.pin_set_level(GPIO_NUM_MAX, 1));
+    EXPECT_EQ(0u, gpio.writes());
+}
+
+/**
+ * @test Verifies that gpio_config applies mode, pulls and interrupt type
+ *       to every pin in the mask, and rejects a mask with a pin that
+ *       doesn't exist without changing anything.
+ */
+TEST(GpioEmulatorTest, ConfigAppliesTheMask)
+{
+    GpioEmulator gpio;
+
+    gpio_config_t config = {};
+    config.pin_bit_mask = (1ULL << GREEN) | (1ULL << RED);
+    config.mode = GPIO_MODE_OUTPUT;
+    config.pull_up_en = GPIO_PULLUP_DISABLE;
+    config.pull_down_en = GPIO_PULLDOWN_ENABLE;
+    config.intr_type = GPIO_INTR_DISABLE;
+    EXPECT_EQ(ESP_OK, gpio_config(&config));
+    EXPECT_EQ(config.pin_bit_mask, gpio.enable_reg());
+    EXPECT_EQ(0u, gpio.input_enable_reg() & config.pin_bit_mask);
+
+    // Input with no pull-up and nothing driving it reads low
+    config.pin_bit_mask = 1ULL << GPIO_NUM_2;
+    config.mode = GPIO_MODE_INPUT;
+    EXPECT_EQ(ESP_OK, gpio_config(&config));
+    EXPECT_EQ(0, gpio_get_level(GPIO_NUM_2));
+
+    uint64_t enable_before = gpio.enable_reg();
+    if (GPIO_NUM_MAX < 64) {
+        config.pin_bit_mask = (1ULL << GPIO_NUM_6) | (1ULL << GPIO_NUM_MAX);
+        config.mode = GPIO_MODE_OUTPUT;
+        EXPECT_EQ(ESP_ERR_INVALID_ARG, gpio_config(&config));
+        EXPECT_EQ(enable_before, gpio.enable_reg());
+    }
+}
+
+/**
+ * @test Verifies that an interrupt armed through GpioHal fires on the
+ *       matching edge only, and not after it's removed.
+ */
+TEST(GpioEmulatorTest, InterruptFiresOnRisingEdge)
+{
+    GpioEmulator gpio;
+    GpioHal hal;
+    int calls = 0;
+
+    gpio.drive(GPIO_NUM_2, 0);
+    ASSERT_EQ(ESP_OK, hal.pin_set_direction(GPIO_NUM_2, GPIO_MODE_INPUT));
+    ASSERT_EQ(ESP_OK, hal.pin_set_intr(GPIO_NUM_2, GPIO_INTR_POSEDGE, [](void *arg) { (*static_cast<int *>(arg))++; }, &calls));
+
+    gpio.drive(GPIO_NUM_2, 1);
+    gpio.drive(GPIO_NUM_2, 1); // No edge
+    gpio.drive(GPIO_NUM_2, 0); // Falling
+    EXPECT_EQ(1, calls);
+
+    ASSERT_EQ(ESP_OK, hal.pin_remove_intr(GPIO_NUM_2));
+    gpio.drive(GPIO_NUM_2, 1);
+    EXPECT_EQ(1, calls);
+}
+
+/**
+ * @test Verifies OperandInput end to end: the test drives the data pins
+ *       and raises the strobe, the emulated interrupt runs the real
+ *       handler, and the operands come out of the queue.
+ */
+TEST(GpioEmulatorTest, OperandInputThroughThePins)
+{
+    GpioEmulator gpio;
+    GpioHal hal;
+    const OperandInputConfig config = {
+        GPIO_NUM_2,
+        {GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_6, GPIO_NUM_7},
+        {GPIO_NUM_12, GPIO_NUM_13, GPIO_NUM_14, GPIO_NUM_15},
+        5000,
+        VirtualClock::now_us};
+
+    VirtualClock::reset();
+    gpio.drive(config.strobe, 0);
+    OperandInput input(hal, config);
+    for (size_t i = 0; i < OperandInputConfig::BITS; i++) {
+        gpio.drive(config.a_pins[i], (6 >> i) & 1);
+        gpio.drive(config.b_pins[i], (3 >> i) & 1);
+    }
+    gpio.drive(config.strobe, 1);
+
+    // A bounce 1 ms later is filtered out by OperandInput's debounce
+    VirtualClock::delay_ms(1);
+    gpio.drive(config.strobe, 0);
+    gpio.drive(config.strobe, 1);
+
+    Operands operands;
+    ASSERT_TRUE(input.pop(operands));
+    EXPECT_EQ(6, operands.a);
+    EXPECT_EQ(3, operands.b);
+    EXPECT_FALSE(input.pop(operands));
+    EXPECT_EQ(2u, gpio.interrupts());
+}
+
+/**
+ * @test Soak test: a million SumBoss computes through LedSargent and the
+ *       real GpioHal. Every write reaches the emulated registers, and the
+ *       LEDs end up in the state of the last result.
+ */
+TEST(GpioEmulatorTest, SumBossSoak)
+{
+    TEST_TIME_BUDGET_MS(5000); // About 100 ms on a desktop; a slow path here shows up as a failure
+
+    GpioEmulator gpio;
+    GpioHal hal;
+    LedSargent leds(hal, GREEN, RED);
+    Sum sum;
+    SumBoss boss(sum, leds);
+
+    const int COMPUTES = 1000000;
+    int failures = 0;
+    for (int i = 0; i < COMPUTES; i++) {
+        int result;
+        if (boss.compute(i % 8, 4, result) != ESP_OK) { // Only 7 + 4 fails
+            failures++;
+        }
+        if (i % 2 == 1) {
+            ASSERT_EQ(ESP_OK, leds.off());
+        }
+    }
+
+    EXPECT_EQ(COMPUTES / 8, failures);
+    // One LED write per compute, two per off()
+    EXPECT_EQ(static_cast<uint64_t>(COMPUTES + COMPUTES), gpio.writes());
+    EXPECT_EQ(0u, gpio.level(GREEN));
+    EXPECT_EQ(0u, gpio.level(RED));
+}
@@ -0,0 +1,204 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "latency_histogram.hpp"
+#include "mock_led_sargent.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+// ======================================================================
+// Bucket math
+// ======================================================================
+
+/**
+ * @test Verifies that small values get one bucket each, so they are exact.
+ */
+TEST(LatencyHistogramTest, SmallValuesAreExact)
+{
+    for (uint32_t v = 0; v < 2 * LatencyHistogram::SUB_BUCKETS; v++) {
+        EXPECT_EQ(v, LatencyHistogram::bucket_index(v));
+        EXPECT_EQ(v, LatencyHistogram::bucket_highest(v));
+    }
+}
+
+/**
+ * @test Verifies that every value lands in a bucket that contains it, and
+ *       that the bucket is never wider than 1/SUB_BUCKETS of the value.
+ */
+TEST(LatencyHistogramTest, BucketsBoundTheRelativeError)
+{
+    const uint32_t samples[] = {64, 65, 100, 1000, 12345, 1u << 20, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFFu};
+    for (uint32_t v : samples) {
+        size_t index = LatencyHistogram::bucket_index(v);
+        ASSERT_LT(index, LatencyHistogram::BUCKETS);
+
+        uint32_t highest = LatencyHistogram::bucket_highest(index);
+        EXPECT_GE(highest, v);
+        EXPECT_LE(highest - v, v / LatencyHistogram::SUB_BUCKETS) << "value " << v;
+    }
+    EXPECT_EQ(LatencyHistogram::BUCKETS - 1, LatencyHistogram::bucket_index(0xFFFFFFFFu));
+}
+
+// ======================================================================
+// Percentiles against synthetic latencies
+// ======================================================================
+
+/**
+ * @test Verifies that an empty histogram reports zero everywhere.
+ */
+TEST(LatencyHistogramTest, EmptyReportsZero)
+{
+    LatencyHistogram hist;
+
+    EXPECT_EQ(0u, hist.count());
+    EXPECT_EQ(0u, hist.p50());
+    EXPECT_EQ(0u, hist.p999());
+    EXPECT_EQ(0u, hist.max());
+}
+
+/**
+ * @test Uniform latencies 1..10000: each percentile must sit within the
+ *       bucket precision of the exact answer, and max must be exact.
+ */
+TEST(LatencyHistogramTest, UniformDistribution)
+{
+    LatencyHistogram hist;
+    for (uint32_t v = 1; v <= 10000; v++) {
+        hist.record(v);
+    }
+
+    EXPECT_EQ(10000u, hist.count());
+    EXPECT_EQ(10000u, hist.max());
+
+    // Reported values may only be above the real one, by at most ~3%
+    EXPECT_GE(hist.p50(), 5000u);
+    EXPECT_LE(hist.p50(), 5000u + 5000u / LatencyHistogram::SUB_BUCKETS);
+    EXPECT_GE(hist.p99(), 9900u);
+    EXPECT_LE(hist.p99(), 10000u);
+    EXPECT_GE(hist.p999(), 9990u);
+    EXPECT_LE(hist.p999(), 10000u);
+}
+
+/**
+ * @test A fast path with rare spikes: the median must ignore the spikes,
+ *       the tail percentiles must see them.
+ */
+TEST(LatencyHistogramTest, TailSpikesShowOnlyInTail)
+{
+    LatencyHistogram hist;
+    for (int i = 0; i < 9980; i++) {
+        hist.record(20); // the usual case, exact bucket
+    }
+    for (int i = 0; i < 20; i++) {
+        hist.record(50000); // 0.2% of slow samples
+    }
+
+    EXPECT_EQ(20u, hist.p50());
+    EXPECT_EQ(20u, hist.p99());
+    EXPECT_GE(hist.p999(), 50000u);
+    EXPECT_EQ(50000u, hist.max());
+}
+
+/**
+ * @test Verifies that reset() clears all samples, and that recording
+ *       works normally afterwards.
+ */
+TEST(LatencyHistogramTest, ResetClearsEverything)
+{
+    LatencyHistogram hist;
+    hist.record(100);
+    hist.record(100000);
+
+    hist.reset();
+
+    EXPECT_EQ(0u, hist.count());
+    EXPECT_EQ(0u, hist.max());
+    EXPECT_EQ(0u, hist.p999());
+
+    hist.record(7);
+    EXPECT_EQ(7u, hist.p50());
+    EXPECT_EQ(7u, hist.max());
+}
+
+// ======================================================================
+// SumBoss instrumentation
+// ======================================================================
+
+// Every reading of the fake clock advances it by 3 ticks
+static int64_t fake_ticks = 0;
+static int64_t stepping_clock()
+{
+    int64_t now = fake_ticks;
+    fake_ticks += 3;
+    return now;
+}
+
+/**
+ * @test Verifies that SumBoss records one sample per compute, measured
+ *       from the request to the LED call, on both paths.
+ */
+TEST(SumBossLatencyTest, RecordsEachCompute)
+{
+    Sum sum;
+    NiceMock<MockLedSargent> led;
+    SumBoss boss(sum, led);
+    LatencyHistogram hist;
+    boss.set_latency_histogram(&hist, stepping_clock);
+
+    ON_CALL(led, green()).WillByDefault(Return(ESP_OK));
+    ON_CALL(led, red()).WillByDefault(Return(ESP_OK));
+
+    int result;
+    boss.compute(3, 4, result);     // green
+    boss.compute(6, 6, result);     // red
+    boss.compute_isr(1, 1, result); // green, ISR path
+
+    EXPECT_EQ(3u, hist.count());
+    EXPECT_EQ(3u, hist.max()); // two clock reads per compute, 3 ticks apart
+}
+
+/**
+ * @test Verifies that a failed LED call records nothing: the level never
+ *       changed, so there is no latency to measure.
+ */
+TEST(SumBossLatencyTest, SkipsFailedLedCalls)
+{
+    Sum sum;
+    NiceMock<MockLedSargent> led;
+    SumBoss boss(sum, led);
+    LatencyHistogram hist;
+    boss.set_latency_histogram(&hist, stepping_clock);
+
+    EXPECT_CALL(led, green()).WillOnce(Return(ESP_FAIL));
+    EXPECT_CALL(led, red()).WillOnce(Return(ESP_FAIL));
+
+    int result;
+    boss.compute(3, 4, result);
+    boss.compute(6, 6, result);
+
+    EXPECT_EQ(0u, hist.count());
+}
+
+/**
+ * @test Verifies that nothing is recorded once the histogram is detached.
+ */
+TEST(SumBossLatencyTest, DetachStopsRecording)
+{
+    Sum sum;
+    NiceMock<MockLedSargent> led;
+    SumBoss boss(sum, led);
+    LatencyHistogram hist;
+
+    ON_CALL(led, green()).WillByDefault(Return(ESP_OK));
+
+    int result;
+    boss.set_latency_histogram(&hist, stepping_clock);
+    boss.compute(3, 4, result);
+    boss.set_latency_histogram(nullptr, nullptr);
+    boss.compute(3, 4, result);
+
+    EXPECT_EQ(1u, hist.count());
+}
@@ -0,0 +1,133 @@
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "led_bank.hpp"
+#include "mock_gpio_hal.hpp"
+#include "recording_gpio_hal.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+#include "virtual_clock.hpp"
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+// -------------------------------------------------------------------
+// LedBank and LedBankSargent
+// -------------------------------------------------------------------
+// A four-LED bank, its pins out of order in the GPIO mask on purpose
+typedef LedBank<GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_18, GPIO_NUM_2> StatusBank;
+
+class LedBankTest : public ::testing::Test
+{
+protected:
+    void SetUp() override { VirtualClock::reset(); }
+
+    std::vector<uint32_t> levels()
+    {
+        return {level(GPIO_NUM_4), level(GPIO_NUM_5), level(GPIO_NUM_18), level(GPIO_NUM_2)};
+    }
+    uint32_t level(gpio_num_t pin) { return static_cast<uint32_t>(gpio_.pin_get_level(pin)); }
+
+    RecordingGpioHal gpio_{VirtualClock::now_us};
+};
+
+/**
+ * @test Verifies at compile time that the masks are constants, bit N of a
+ *       state being the Nth pin of the list.
+ */
+TEST_F(LedBankTest, MasksAreConstants)
+{
+    static_assert(StatusBank::COUNT == 4, "four pins");
+    static_assert(StatusBank::ALL == 0xF, "four LEDs");
+    static_assert(StatusBank::ALL_PINS == ((1ull << 4) | (1ull << 5) | (1ull << 18) | (1ull << 2)), "every pin");
+    static_assert(StatusBank::pin_mask(0b0101) == ((1ull << 4) | (1ull << 18)), "LEDs 0 and 2");
+    static_assert(StatusBank::pin_mask(0b1000) == (1ull << 2), "LED 3, below the others");
+    static_assert(StatusBank::pin_mask(0) == 0, "nothing");
+    static_assert(StatusBank::pin_mask(StatusBank::ALL) == StatusBank::ALL_PINS, "the two agree");
+    static_assert(LedBank<GPIO_NUM_0>::ALL == 1, "a single LED");
+}
+
+/**
+ * @test Verifies that show() sets every LED of the bank in one port write:
+ *       the LEDs of the state lit, the others off.
+ */
+TEST_F(LedBankTest, ShowIsOnePortWrite)
+{
+    StatusBank bank(gpio_);
+
+    ASSERT_EQ(ESP_OK, bank.show(0b0101));
+    EXPECT_EQ(1, gpio_.port_writes());
+    EXPECT_EQ((std::vector<uint32_t>{1, 0, 1, 0}), levels());
+
+    ASSERT_EQ(ESP_OK, bank.show(0b1010));
+    EXPECT_EQ(2, gpio_.port_writes());
+    EXPECT_EQ((std::vector<uint32_t>{0, 1, 0, 1}), levels());
+    EXPECT_EQ(0b1010u, bank.state());
+}
+
+/**
+ * @test Verifies that set() and clear() only touch their LEDs, and that a
+ *       bit past the last LED is refused without a write.
+ */
+TEST_F(LedBankTest, SetAndClearLeaveTheOthers)
+{
+    StatusBank bank(gpio_);
+    ASSERT_EQ(ESP_OK, bank.show(0b0001));
+
+    ASSERT_EQ(ESP_OK, bank.set(0b1000));
+    EXPECT_EQ((std::vector<uint32_t>{1, 0, 0, 1}), levels());
+    ASSERT_EQ(ESP_OK, bank.clear(0b0001));
+    EXPECT_EQ((std::vector<uint32_t>{0, 0, 0, 1}), levels());
+    EXPECT_EQ(0b1000u, bank.state());
+
+    gpio_.clear();
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, bank.show(0b10000));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, bank.set(1u << 31));
+    EXPECT_EQ(0, gpio_.port_writes());
+    EXPECT_EQ(0b1000u, bank.state());
+}
+
+/**
+ * @test Verifies the LedSargent error rule: a failed pin setup is returned
+ *       by every method, and nothing is written.
+ */
+TEST_F(LedBankTest, SetupErrorIsReturned)
+{
+    NiceMock<MockGpioHal> mock_gpio;
+    ON_CALL(mock_gpio, pin_set_direction(_, _)).WillByDefault(Return(ESP_OK));
+    ON_CALL(mock_gpio, pin_set_direction(GPIO_NUM_18, _)).WillByDefault(Return(ESP_ERR_INVALID_ARG)); // The third pin
+    EXPECT_CALL(mock_gpio, port_set_levels(_, _)).Times(0);
+    StatusBank bank(mock_gpio);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, bank.show(0b0001));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, bank.set(0b0001));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, bank.clear(0b0001));
+}
+
+/**
+ * @test Verifies LedBankSargent: the LedSargent contract on LEDs 0 and 1,
+ *       and SumBoss driving it like any ILedSargent.
+ */
+TEST_F(LedBankTest, TwoLedBankIsALedSargent)
+{
+    LedBankSargent<GPIO_NUM_4, GPIO_NUM_5> leds(gpio_);
+
+    ASSERT_EQ(ESP_OK, leds.green());
+    ASSERT_EQ(ESP_OK, leds.red());
+    EXPECT_EQ(1u, level(GPIO_NUM_4)); // green() and red() leave each other alone
+    EXPECT_EQ(1u, level(GPIO_NUM_5));
+    ASSERT_EQ(ESP_OK, leds.off());
+    EXPECT_EQ(0u, leds.bank().state());
+    EXPECT_EQ(3, gpio_.port_writes());
+
+    Sum sum;
+    SumBoss boss(sum, leds);
+    int result;
+    EXPECT_EQ(ESP_OK, boss.compute(2, 3, result));
+    EXPECT_EQ(1u, level(GPIO_NUM_4));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, boss.compute(-1, 3, result));
+    EXPECT_EQ(1u, level(GPIO_NUM_5));
+}
@@ -1,18 +1,8 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
-#include "i_gpio_hal.hpp"
 #include "led_sargent.hpp"
-
-// -------------------------------------------------------------------
-// Mock class for the GPIO HAL interface
-// -------------------------------------------------------------------
-class MockGpioHal : public IGpioHal
-{
-public:
-    MOCK_METHOD(esp_err_t, pin_set_direction, (gpio_num_t, gpio_mode_t), (override));
-    MOCK_METHOD(esp_err_t, pin_set_level, (gpio_num_t, uint32_t), (override));
-};
+#include "mock_gpio_hal.hpp"
 
 using ::testing::Return;
 
@@ -130,3 +120,47 @@ TEST(LedSargentTest, OffAbortsOnSecondFailure)
 
     EXPECT_EQ(ESP_FAIL, led.off());
 }
+
+// -------------------------------------------------------------------
+// Pin validation — done once, in the constructor
+// -------------------------------------------------------------------
+/**
+ * @test Verifies that if the constructor fails to set up a pin, the
+ *       methods return that error and never write to the HAL.
+ *
+ * Backends like LlGpioHal don't check the pin on every write, so a pin
+ * that failed setup must never reach pin_set_level.
+ */
+TEST(LedSargentTest, SetupFailureBlocksWrites)
+{
+    ::testing::NiceMock<MockGpioHal> mock_hal;
+
+    // The red pin is rejected during setup
+    EXPECT_CALL(mock_hal, pin_set_direction(GPIO_NUM_2, GPIO_MODE_OUTPUT)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_hal, pin_set_direction(GPIO_NUM_NC, GPIO_MODE_OUTPUT)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+
+    LedSargent led(mock_hal, GPIO_NUM_2, GPIO_NUM_NC);
+
+    // No write may reach the HAL — not even for the valid green pin
+    EXPECT_CALL(mock_hal, pin_set_level(::testing::_, ::testing::_)).Times(0);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, led.green());
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, led.red());
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, led.off());
+}
+
+/**
+ * @test Verifies that both pins are still set up when the first one
+ *       fails, and that the first error is the one reported.
+ */
+TEST(LedSargentTest, SetupReportsFirstFailure)
+{
+    MockGpioHal mock_hal;
+
+    EXPECT_CALL(mock_hal, pin_set_direction(GPIO_NUM_2, GPIO_MODE_OUTPUT)).WillOnce(Return(ESP_ERR_INVALID_ARG));
+    EXPECT_CALL(mock_hal, pin_set_direction(GPIO_NUM_4, GPIO_MODE_OUTPUT)).WillOnce(Return(ESP_FAIL));
+
+    LedSargent led(mock_hal, GPIO_NUM_2, GPIO_NUM_4);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, led.green());
+}
@@ -0,0 +1,210 @@
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "led_sargent.hpp"
+#include "led_sequencer.hpp"
+#include "recording_gpio_hal.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+#include "virtual_clock.hpp"
+#include "virtual_timer.hpp"
+
+// -------------------------------------------------------------------
+// LedSequencer on VirtualTimer
+// -------------------------------------------------------------------
+// The real LedSargent writes to a RecordingGpioHal, so every LED change
+// has its VirtualClock timestamp, and VirtualTimer plays the timer
+// callbacks at their deadlines.
+
+#define GREEN_LED_PIN GPIO_NUM_4
+#define RED_LED_PIN GPIO_NUM_5
+
+class LedSequencerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override { VirtualClock::reset(); }
+
+    // (ms, level) of every change of a pin, the repeated writes removed
+    std::vector<std::pair<int64_t, uint32_t>> edges(gpio_num_t pin) const
+    {
+        std::vector<std::pair<int64_t, uint32_t>> out;
+        uint32_t level = 0;
+        for (const RecordingGpioHal::Write &w : gpio_.writes()) {
+            if (w.pin == pin && w.level != level) {
+                level = w.level;
+                out.push_back({w.time_us / 1000, level});
+            }
+        }
+        return out;
+    }
+
+    RecordingGpioHal gpio_{VirtualClock::now_us};
+    LedSargent leds_{gpio_, GREEN_LED_PIN, RED_LED_PIN};
+    VirtualTimer timer_;
+    LedSequencer sequencer_{leds_, timer_, VirtualClock::now_us};
+};
+
+typedef std::vector<std::pair<int64_t, uint32_t>> Edges;
+
+/**
+ * @test Verifies that play() returns at once and the timer plays the
+ *       rest: the ESP_ERR_INVALID_ARG code, twice, at the right times,
+ *       with one wakeup per step and nothing left armed after it.
+ */
+TEST_F(LedSequencerTest, PlaysAPatternFromTheTimer)
+{
+    ASSERT_EQ(ESP_OK, sequencer_.play(LedPatterns::INVALID_ARG));
+    EXPECT_EQ(0, VirtualClock::now_us());
+    EXPECT_EQ(&LedPatterns::INVALID_ARG, sequencer_.showing());
+
+    timer_.run_for(5000);
+    Edges expected = {{0, 1},    {150, 0},  {300, 1},  {450, 0}, // First time
+                      {1050, 1}, {1200, 0}, {1350, 1}, {1500, 0}}; // Second time
+    EXPECT_EQ(expected, edges(RED_LED_PIN));
+    EXPECT_TRUE(edges(GREEN_LED_PIN).empty());
+
+    EXPECT_EQ(8, timer_.fires()); // 4 steps, twice
+    EXPECT_FALSE(timer_.armed());
+    EXPECT_EQ(nullptr, sequencer_.showing());
+    EXPECT_EQ(0u, sequencer_.playing());
+}
+
+/**
+ * @test Verifies preemption: an error code cuts into the heartbeat, and
+ *       the heartbeat resumes afterwards with what was left of its blip.
+ */
+TEST_F(LedSequencerTest, HigherPriorityPreempts)
+{
+    ASSERT_EQ(ESP_OK, sequencer_.play(LedPatterns::HEARTBEAT));
+    timer_.run_for(20);
+    ASSERT_EQ(ESP_OK, sequencer_.play(LedPatterns::OUT_OF_RANGE));
+    EXPECT_EQ(&LedPatterns::OUT_OF_RANGE, sequencer_.showing());
+    EXPECT_EQ(2u, sequencer_.playing());
+
+    timer_.run_for(6000);
+    // Heartbeat on at 0, paused at 20 with 30 ms left, resumed when the
+    // error code ends at 20 + 2 x 1200
+    Edges green = {{0, 1}, {20, 0}, {2420, 1}, {2450, 0}, {5400, 1}, {5450, 0}};
+    Edges red = {{20, 1}, {820, 0}, {1220, 1}, {2020, 0}};
+    EXPECT_EQ(green, edges(GREEN_LED_PIN));
+    EXPECT_EQ(red, edges(RED_LED_PIN));
+    EXPECT_EQ(&LedPatterns::HEARTBEAT, sequencer_.showing()); // Forever
+}
+
+/**
+ * @test Verifies that a lower priority pattern waits for the one showing,
+ *       then plays in full.
+ */
+TEST_F(LedSequencerTest, LowerPriorityWaits)
+{
+    ASSERT_EQ(ESP_OK, sequencer_.play(LedPatterns::INVALID_ARG));
+    timer_.run_for(100);
+    ASSERT_EQ(ESP_OK, sequencer_.play(LedPatterns::OK));
+    EXPECT_EQ(&LedPatterns::INVALID_ARG, sequencer_.showing());
+
+    timer_.run_for(3000);
+    Edges green = {{2100, 1}, {2400, 0}};
+    EXPECT_EQ(green, edges(GREEN_LED_PIN));
+    EXPECT_EQ(0u, sequencer_.playing());
+}
+
+/**
+ * @test Verifies the slots: a pattern played again restarts, a full
+ *       sequencer refuses a pattern that outranks nothing, and makes room
+ *       for one that does by dropping its lowest.
+ */
+TEST_F(LedSequencerTest, SlotsFollowPriority)
+{
+    static constexpr LedStep STEPS[] = {{LedStep::RED, 100}};
+    static constexpr LedPattern P1 = {STEPS, 1, 1, 0};
+    static constexpr LedPattern P2 = {STEPS, 1, 2, 0};
+    static constexpr LedPattern P3 = {STEPS, 1, 3, 0};
+    static constexpr LedPattern P4 = {STEPS, 1, 4, 0};
+    static constexpr LedPattern LOW = {STEPS, 1, 1, 0};
+    static constexpr LedPattern HIGH = {STEPS, 1, 9, 0};
+
+    for (const LedPattern *p : {&P1, &P2, &P3, &P4}) {
+        ASSERT_EQ(ESP_OK, sequencer_.play(*p));
+    }
+    EXPECT_EQ(ESP_OK, sequencer_.play(P2)); // Restart, no new slot
+    EXPECT_EQ(LedSequencer::MAX_PATTERNS, sequencer_.playing());
+
+    EXPECT_EQ(ESP_ERR_NO_MEM, sequencer_.play(LOW)); // Ties with P1, doesn't outrank it
+    EXPECT_EQ(ESP_OK, sequencer_.play(HIGH));
+    EXPECT_EQ(&HIGH, sequencer_.showing());
+
+    sequencer_.stop(HIGH);
+    EXPECT_EQ(&P4, sequencer_.showing());
+    sequencer_.stop(P4);
+    sequencer_.stop(P3);
+    EXPECT_EQ(&P2, sequencer_.showing()); // P1 was dropped for HIGH
+
+    sequencer_.stop_all();
+    EXPECT_EQ(nullptr, sequencer_.showing());
+    EXPECT_FALSE(timer_.armed());
+    EXPECT_EQ(0u, gpio_.pin_get_level(RED_LED_PIN));
+}
+
+/**
+ * @test Verifies that patterns the timer could never get past are refused.
+ */
+TEST_F(LedSequencerTest, RejectsBadPatterns)
+{
+    static constexpr LedStep ZERO[] = {{LedStep::RED, 100}, {LedStep::OFF, 0}};
+    static constexpr LedPattern EMPTY = {ZERO, 0, 1, 1};
+    static constexpr LedPattern ZERO_MS = {ZERO, 2, 1, 1};
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, sequencer_.play(EMPTY));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, sequencer_.play(ZERO_MS));
+    EXPECT_EQ(0u, sequencer_.playing());
+    EXPECT_TRUE(gpio_.writes().empty());
+}
+
+/**
+ * @test Verifies that a late timer callback doesn't stretch the pattern:
+ *       steps are chained on their deadlines, and a step already over
+ *       when the callback runs is skipped.
+ */
+TEST_F(LedSequencerTest, LateCallbackKeepsTheCadence)
+{
+    ASSERT_EQ(ESP_OK, sequencer_.play(LedPatterns::OUT_OF_RANGE));
+    VirtualClock::delay_ms(900); // The callback due at 800 comes 100 ms late
+    LedSequencer::on_timer(&sequencer_);
+    EXPECT_EQ(1200 * 1000, timer_.deadline_us());
+
+    VirtualClock::delay_ms(1200); // Past 1200 and 2000: the second blink is over
+    LedSequencer::on_timer(&sequencer_);
+    EXPECT_EQ(2400 * 1000, timer_.deadline_us());
+    EXPECT_EQ(0u, gpio_.pin_get_level(RED_LED_PIN));
+}
+
+/**
+ * @test Verifies that SumBoss shows compute() results as blink codes,
+ *       the error outranking the success after it, while compute_isr()
+ *       keeps the steady LEDs.
+ */
+TEST_F(LedSequencerTest, SumBossPlaysBlinkCodes)
+{
+    Sum sum;
+    SumBoss boss(sum, leds_);
+    boss.set_sequencer(&sequencer_);
+
+    int result;
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, boss.compute(-1, 3, result));
+    EXPECT_EQ(&LedPatterns::INVALID_ARG, sequencer_.showing());
+    EXPECT_EQ(ESP_OK, boss.compute(2, 3, result));
+    EXPECT_EQ(&LedPatterns::INVALID_ARG, sequencer_.showing());
+    EXPECT_EQ(2u, sequencer_.playing());
+
+    timer_.run_for(2100);
+    EXPECT_EQ(&LedPatterns::OK, sequencer_.showing());
+    timer_.run_for(400);
+    EXPECT_EQ(nullptr, sequencer_.showing());
+
+    gpio_.clear();
+    EXPECT_EQ(ESP_OK, boss.compute_isr(2, 3, result));
+    EXPECT_EQ(0u, sequencer_.playing());
+    EXPECT_EQ(1, gpio_.pin_get_level(GREEN_LED_PIN));
+}
@@ -0,0 +1,206 @@
+#include "gtest/gtest.h"
+
+#include "fake_ledc_hal.hpp"
+#include "ledc_led_sargent.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+#include "virtual_clock.hpp"
+
+// -------------------------------------------------------------------
+// LedcLedSargent on FakeLedcHal
+// -------------------------------------------------------------------
+#define GREEN_LED_PIN GPIO_NUM_4
+#define RED_LED_PIN GPIO_NUM_5
+
+static const uint32_t GREEN = LedcLedSargent::GREEN_CHANNEL;
+static const uint32_t RED = LedcLedSargent::RED_CHANNEL;
+static const uint32_t FULL = LedcLedSargent::MAX_DUTY;
+
+class LedcLedSargentTest : public ::testing::Test
+{
+protected:
+    void SetUp() override { VirtualClock::reset(); }
+
+    FakeLedcHal ledc_{VirtualClock::now_us};
+};
+
+/**
+ * @test Verifies that the constructor sets up the timer, then one channel
+ *       per LED on the right pin, both dark.
+ */
+TEST_F(LedcLedSargentTest, ConfiguresTimerAndChannels)
+{
+    LedcLedSargent leds(ledc_, GREEN_LED_PIN, RED_LED_PIN);
+
+    EXPECT_EQ(LedcLedSargent::FREQ_HZ, ledc_.freq_hz());
+    EXPECT_EQ(LedcLedSargent::DUTY_BITS, ledc_.duty_bits());
+    EXPECT_EQ(GREEN_LED_PIN, ledc_.pin(GREEN));
+    EXPECT_EQ(RED_LED_PIN, ledc_.pin(RED));
+    EXPECT_EQ(0u, ledc_.duty(GREEN));
+    EXPECT_EQ(0u, ledc_.duty(RED));
+}
+
+/**
+ * @test Verifies the LedSargent contract: green() and red() light one LED
+ *       at full duty and leave the other alone, off() darkens both.
+ */
+TEST_F(LedcLedSargentTest, GreenRedOff)
+{
+    LedcLedSargent leds(ledc_, GREEN_LED_PIN, RED_LED_PIN);
+
+    EXPECT_EQ(ESP_OK, leds.green());
+    EXPECT_EQ(FULL, ledc_.duty(GREEN));
+    EXPECT_EQ(0u, ledc_.duty(RED));
+
+    EXPECT_EQ(ESP_OK, leds.red());
+    EXPECT_EQ(FULL, ledc_.duty(GREEN));
+    EXPECT_EQ(FULL, ledc_.duty(RED));
+
+    EXPECT_EQ(ESP_OK, leds.off());
+    EXPECT_EQ(0u, ledc_.duty(GREEN));
+    EXPECT_EQ(0u, ledc_.duty(RED));
+}
+
+/**
+ * @test Verifies that set_brightness() dims the LED that is lit at once,
+ *       applies to the next one lit, and rejects more than 100%.
+ */
+TEST_F(LedcLedSargentTest, BrightnessScalesTheDuty)
+{
+    LedcLedSargent leds(ledc_, GREEN_LED_PIN, RED_LED_PIN);
+    EXPECT_EQ(0u, LedcLedSargent::duty_for(0));
+    EXPECT_EQ(512u, LedcLedSargent::duty_for(50));
+    EXPECT_EQ(FULL, LedcLedSargent::duty_for(100));
+
+    ASSERT_EQ(ESP_OK, leds.green());
+    EXPECT_EQ(ESP_OK, leds.set_brightness(50));
+    EXPECT_EQ(512u, ledc_.duty(GREEN));
+    EXPECT_EQ(0u, ledc_.duty(RED)); // Not lit, stays dark
+
+    EXPECT_EQ(ESP_OK, leds.red());
+    EXPECT_EQ(512u, ledc_.duty(RED));
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, leds.set_brightness(101));
+    EXPECT_EQ(512u, ledc_.duty(GREEN));
+
+    // Brightness 0 keeps the LEDs lit, so they come back with the brightness
+    ASSERT_EQ(ESP_OK, leds.set_brightness(0));
+    ASSERT_EQ(ESP_OK, leds.set_brightness(10));
+    EXPECT_EQ(LedcLedSargent::duty_for(10), ledc_.duty(GREEN));
+    EXPECT_EQ(LedcLedSargent::duty_for(10), ledc_.duty(RED));
+}
+
+/**
+ * @test Verifies that with a fade time, green() is one call that returns
+ *       at once, and the hardware ramps the duty with no further call.
+ */
+TEST_F(LedcLedSargentTest, FadeIsOneCall)
+{
+    LedcLedSargent leds(ledc_, GREEN_LED_PIN, RED_LED_PIN);
+    leds.set_fade_ms(400);
+    ledc_.reset_calls();
+
+    ASSERT_EQ(ESP_OK, leds.green());
+    EXPECT_EQ(1, ledc_.calls());
+    EXPECT_TRUE(ledc_.fading(GREEN));
+    EXPECT_EQ(0u, ledc_.duty(GREEN));
+
+    VirtualClock::delay_ms(100);
+    EXPECT_EQ(FULL / 4, ledc_.duty(GREEN));
+    VirtualClock::delay_ms(100);
+    EXPECT_EQ(FULL / 2, ledc_.duty(GREEN));
+    VirtualClock::delay_ms(200);
+    EXPECT_EQ(FULL, ledc_.duty(GREEN));
+    EXPECT_FALSE(ledc_.fading(GREEN));
+    EXPECT_EQ(1, ledc_.calls()); // Nothing from the CPU during the fade
+
+    // off() fades both down, starting from where each one is
+    ASSERT_EQ(ESP_OK, leds.off());
+    EXPECT_EQ(3, ledc_.calls());
+    VirtualClock::delay_ms(200);
+    EXPECT_NEAR(FULL / 2, ledc_.duty(GREEN), 1); // The ramp rounds each step
+    EXPECT_EQ(0u, ledc_.duty(RED));
+}
+
+/**
+ * @test Verifies that fade() runs its own time, whatever set_fade_ms says,
+ *       and that an interrupted fade picks up from the current duty, as
+ *       on a chip with fade stop, without waiting.
+ */
+TEST_F(LedcLedSargentTest, ExplicitFade)
+{
+    LedcLedSargent leds(ledc_, GREEN_LED_PIN, RED_LED_PIN);
+
+    ASSERT_EQ(ESP_OK, leds.fade(LedcLedSargent::RED, 100, 1000));
+    VirtualClock::delay_ms(500);
+    ASSERT_EQ(ESP_OK, leds.fade(LedcLedSargent::RED, 0, 500));
+    EXPECT_EQ(FULL / 2, ledc_.duty(RED));
+    VirtualClock::delay_ms(250);
+    EXPECT_NEAR(FULL / 4, ledc_.duty(RED), 1); // The ramp rounds each step
+    EXPECT_EQ(0, ledc_.waited_us());
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, leds.fade(LedcLedSargent::GREEN, 200, 10));
+}
+
+/**
+ * @test Verifies the chips without fade stop: a change on a LED that is
+ *       still fading blocks the caller until that fade ends, then applies.
+ *       With no fade running, nothing waits.
+ */
+TEST_F(LedcLedSargentTest, NoFadeStopWaitsForTheFade)
+{
+    ledc_.without_fade_stop(VirtualClock::advance_us);
+    LedcLedSargent leds(ledc_, GREEN_LED_PIN, RED_LED_PIN);
+    leds.set_fade_ms(400);
+
+    ASSERT_EQ(ESP_OK, leds.green());
+    VirtualClock::delay_ms(100);
+    ASSERT_EQ(ESP_OK, leds.off()); // Green is fading: off() waits 300 ms
+    EXPECT_EQ(300000, ledc_.waited_us());
+    EXPECT_EQ(400000, VirtualClock::now_us());
+    EXPECT_EQ(FULL, ledc_.duty(GREEN)); // The fade up ran to its end first
+    EXPECT_TRUE(ledc_.fading(GREEN));
+
+    VirtualClock::delay_ms(400); // Both fades down are over
+    ASSERT_EQ(ESP_OK, leds.red()); // Nothing fading: no wait
+    EXPECT_EQ(300000, ledc_.waited_us());
+}
+
+/**
+ * @test Verifies the LedSargent error rule: a failed setup is remembered,
+ *       and every method returns it without touching the HAL.
+ */
+TEST_F(LedcLedSargentTest, SetupErrorIsReturned)
+{
+    ledc_.fail_timer_config(ESP_ERR_NOT_SUPPORTED);
+    LedcLedSargent leds(ledc_, GREEN_LED_PIN, RED_LED_PIN);
+    ledc_.reset_calls();
+
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, leds.green());
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, leds.red());
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, leds.off());
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, leds.set_brightness(50));
+    EXPECT_EQ(0, ledc_.calls());
+
+    FakeLedcHal ledc(VirtualClock::now_us);
+    LedcLedSargent bad_pin(ledc, GPIO_NUM_MAX, RED_LED_PIN);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, bad_pin.green());
+}
+
+/**
+ * @test Verifies that SumBoss drives it like any ILedSargent, with the
+ *       LEDs dimmed.
+ */
+TEST_F(LedcLedSargentTest, WorksUnderSumBoss)
+{
+    LedcLedSargent leds(ledc_, GREEN_LED_PIN, RED_LED_PIN);
+    ASSERT_EQ(ESP_OK, leds.set_brightness(25));
+    Sum sum;
+    SumBoss boss(sum, leds);
+
+    int result;
+    EXPECT_EQ(ESP_OK, boss.compute(2, 3, result));
+    EXPECT_EQ(LedcLedSargent::duty_for(25), ledc_.duty(GREEN));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, boss.compute(-1, 3, result));
+    EXPECT_EQ(LedcLedSargent::duty_for(25), ledc_.duty(RED));
+}
@@ -0,0 +1,235 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mock_gpio_hal.hpp"
+#include "mock_led_sargent.hpp"
+#include "operand_input.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SaveArg;
+
+// -------------------------------------------------------------------
+// Fake clock — the tests decide what time the ISR sees
+// -------------------------------------------------------------------
+static int64_t fake_now_us = 0;
+static int64_t fake_clock()
+{
+    return fake_now_us;
+}
+
+// Strobe on GPIO 2, a on 4..7, b on 12..15, 5 ms of debounce
+static OperandInputConfig make_config()
+{
+    OperandInputConfig config = {
+        GPIO_NUM_2,
+        {GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_6, GPIO_NUM_7},
+        {GPIO_NUM_12, GPIO_NUM_13, GPIO_NUM_14, GPIO_NUM_15},
+        5000,
+        fake_clock};
+    return config;
+}
+
+/**
+ * @brief Fixture that captures the strobe handler registered by OperandInput.
+ *
+ * Calling fire() is the same as the hardware raising the strobe: the
+ * handler runs with the arg OperandInput registered, exactly like the
+ * GPIO ISR service would call it.
+ */
+class OperandInputTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        fake_now_us = 0;
+        ON_CALL(hal, pin_set_intr(GPIO_NUM_2, GPIO_INTR_POSEDGE, _, _))
+            .WillByDefault(DoAll(SaveArg<2>(&handler), SaveArg<3>(&handler_arg), Return(ESP_OK)));
+        ON_CALL(hal, pin_get_level(_)).WillByDefault(Return(0));
+    }
+
+    // Drives the data pins with a and b, then fires the strobe at time now_us
+    void fire(int a, int b, int64_t now_us)
+    {
+        const OperandInputConfig config = make_config();
+        for (size_t i = 0; i < OperandInputConfig::BITS; i++) {
+            ON_CALL(hal, pin_get_level(config.a_pins[i])).WillByDefault(Return((a >> i) & 1));
+            ON_CALL(hal, pin_get_level(config.b_pins[i])).WillByDefault(Return((b >> i) & 1));
+        }
+        fake_now_us = now_us;
+        handler(handler_arg);
+    }
+
+    NiceMock<MockGpioHal> hal;
+    gpio_isr_t handler = nullptr;
+    void *handler_arg = nullptr;
+};
+
+/**
+ * @test Verifies that the constructor sets every pin as input, arms a
+ *       rising-edge interrupt on the strobe, and that the destructor
+ *       removes it.
+ */
+TEST(OperandInputSetupTest, ConfiguresInputsAndInterrupt)
+{
+    MockGpioHal hal;
+
+    EXPECT_CALL(hal, pin_set_direction(_, GPIO_MODE_INPUT)).Times(9).WillRepeatedly(Return(ESP_OK));
+    EXPECT_CALL(hal, pin_set_intr(GPIO_NUM_2, GPIO_INTR_POSEDGE, _, _)).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(hal, pin_remove_intr(GPIO_NUM_2)).WillOnce(Return(ESP_OK));
+
+    OperandInput input(hal, make_config());
+}
+
+/**
+ * @test Verifies that a failed pin setup leaves the interrupt unarmed and
+ *       makes process() return the setup error.
+ */
+TEST(OperandInputSetupTest, SetupFailureDisablesInput)
+{
+    NiceMock<MockGpioHal> hal;
+    NiceMock<MockLedSargent> led;
+    Sum sum;
+    SumBoss boss(sum, led);
+
+    ON_CALL(hal, pin_set_direction(GPIO_NUM_13, GPIO_MODE_INPUT)).WillByDefault(Return(ESP_ERR_INVALID_ARG));
+    EXPECT_CALL(hal, pin_set_intr(_, _, _, _)).Times(0);
+    EXPECT_CALL(hal, pin_remove_intr(_)).Times(0);
+
+    OperandInput input(hal, make_config());
+
+    int result;
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, input.process(boss, result, 0));
+}
+
+/**
+ * @test Verifies that the strobe reads both operands, bit 0 first.
+ */
+TEST_F(OperandInputTest, StrobeLatchesOperands)
+{
+    OperandInput input(hal, make_config());
+    ASSERT_NE(nullptr, handler);
+
+    fire(3, 12, 0);
+
+    Operands operands;
+    ASSERT_TRUE(input.pop(operands));
+    EXPECT_EQ(3, operands.a);
+    EXPECT_EQ(12, operands.b);
+    EXPECT_FALSE(input.pop(operands));
+}
+
+/**
+ * @test Verifies that edges inside the debounce window are ignored, and
+ *       that the window is measured from the last accepted edge.
+ */
+TEST_F(OperandInputTest, BouncesAreIgnored)
+{
+    OperandInput input(hal, make_config());
+
+    fire(1, 1, 10000);
+    fire(2, 2, 10100); // bounce, 0.1 ms later
+    fire(3, 3, 14999); // still inside the 5 ms window
+    fire(4, 4, 15000); // first edge after the window
+
+    Operands operands;
+    ASSERT_TRUE(input.pop(operands));
+    EXPECT_EQ(1, operands.a);
+    ASSERT_TRUE(input.pop(operands));
+    EXPECT_EQ(4, operands.a);
+    EXPECT_FALSE(input.pop(operands));
+}
+
+/**
+ * @test Verifies that a full ring drops the newest operands and counts
+ *       them, keeping the ones already queued intact.
+ */
+TEST_F(OperandInputTest, FullQueueDropsNewest)
+{
+    OperandInput input(hal, make_config());
+
+    for (size_t i = 0; i < OperandInput::QUEUE_SIZE + 2; i++) {
+        fire(static_cast<int>(i), 0, static_cast<int64_t>(i) * 10000);
+    }
+    EXPECT_EQ(2u, input.dropped());
+
+    Operands operands;
+    for (size_t i = 0; i < OperandInput::QUEUE_SIZE; i++) {
+        ASSERT_TRUE(input.pop(operands));
+        EXPECT_EQ(static_cast<int>(i), operands.a);
+    }
+    EXPECT_FALSE(input.pop(operands));
+}
+
+/**
+ * @test Verifies that process() runs queued operands through SumBoss.
+ */
+TEST_F(OperandInputTest, ProcessComputesQueuedOperands)
+{
+    Sum sum;
+    NiceMock<MockLedSargent> led;
+    SumBoss boss(sum, led);
+    OperandInput input(hal, make_config());
+
+    fire(3, 4, 0);
+    fire(6, 6, 10000);
+
+    EXPECT_CALL(led, green()).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(led, red()).WillOnce(Return(ESP_OK));
+
+    int result = 0;
+    EXPECT_EQ(ESP_OK, input.process(boss, result, 0));
+    EXPECT_EQ(7, result);
+    EXPECT_EQ(ESP_FAIL, input.process(boss, result, 0));
+}
+
+/**
+ * @test Verifies that process() gives up with ESP_ERR_TIMEOUT when no
+ *       operands arrive, without calling SumBoss.
+ */
+TEST_F(OperandInputTest, ProcessTimesOutWhenEmpty)
+{
+    Sum sum;
+    NiceMock<MockLedSargent> led;
+    SumBoss boss(sum, led);
+    OperandInput input(hal, make_config());
+
+    EXPECT_CALL(led, green()).Times(0);
+    EXPECT_CALL(led, red()).Times(0);
+
+    int result;
+    EXPECT_EQ(ESP_ERR_TIMEOUT, input.process(boss, result, 0));
+}
+
+/**
+ * @test Verifies that a notification left over from operands already
+ *       processed doesn't cut the next wait short: process() keeps
+ *       waiting until the whole timeout has passed.
+ */
+TEST_F(OperandInputTest, StaleNotificationDoesNotCutTheWait)
+{
+    Sum sum;
+    NiceMock<MockLedSargent> led;
+    SumBoss boss(sum, led);
+    OperandInput input(hal, make_config());
+
+    // A first call registers this task, so the pushes below notify it
+    int result = 0;
+    EXPECT_EQ(ESP_ERR_TIMEOUT, input.process(boss, result, 0));
+
+    fire(3, 4, 0);
+    fire(1, 2, 10000);
+    // Both are popped without taking a notification
+    EXPECT_EQ(ESP_OK, input.process(boss, result, 0));
+    EXPECT_EQ(ESP_OK, input.process(boss, result, 0));
+    EXPECT_EQ(3, result);
+
+    const TickType_t timeout = pdMS_TO_TICKS(50);
+    TickType_t start = xTaskGetTickCount();
+    EXPECT_EQ(ESP_ERR_TIMEOUT, input.process(boss, result, timeout));
+    EXPECT_GE(xTaskGetTickCount() - start, timeout);
+}
@@ -0,0 +1,145 @@
+#include <stdlib.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_sum.hpp"
+#include "sum.hpp"
+
+// Wide bounds: 12-bit samples, any total a test buffer can reach
+static const SumStreamBounds ADC_BOUNDS = {0, 4095, 0, INT32_MAX};
+
+static std::vector<int16_t> random_samples(size_t count)
+{
+    std::vector<int16_t> samples(count);
+    for (auto &s : samples) {
+        s = static_cast<int16_t>(rand() % 4096);
+    }
+    return samples;
+}
+
+static int64_t serial_sum(const std::vector<int16_t> &samples)
+{
+    int64_t total = 0;
+    for (int16_t s : samples) {
+        total += s;
+    }
+    return total;
+}
+
+/**
+ * @brief Runs each test for several worker counts, including more
+ *        workers than the host may have cores.
+ */
+class ParallelSumTest : public ::testing::TestWithParam<size_t>
+{
+};
+
+/**
+ * @test Verifies that the parallel total matches a serial loop, for sizes
+ *       below the threshold (summed inline), at it, and well above it
+ *       with a remainder that doesn't split evenly.
+ */
+TEST_P(ParallelSumTest, MatchesSerialSum)
+{
+    ParallelSum psum(GetParam());
+    const size_t sizes[] = {0, 1, 1000, 2 * ParallelSum::MIN_SAMPLES_PER_WORKER, 100003};
+
+    srand(3);
+    for (size_t count : sizes) {
+        std::vector<int16_t> samples = random_samples(count);
+        int64_t result = 0;
+
+        EXPECT_EQ(ESP_OK, psum.reduce(samples.data(), count, ADC_BOUNDS, result));
+        EXPECT_EQ(serial_sum(samples), result) << "count " << count;
+    }
+}
+
+/**
+ * @test Verifies that a single invalid sample is caught whichever worker's
+ *       slice it falls in, and that result is -1 like add_constrained_err.
+ */
+TEST_P(ParallelSumTest, InvalidSampleInAnySlice)
+{
+    ParallelSum psum(GetParam());
+    const size_t count = 65536;
+    const size_t positions[] = {0, count / 3, count / 2, count - 1};
+
+    for (size_t bad : positions) {
+        std::vector<int16_t> samples(count, 1);
+        samples[bad] = 5000;
+        int64_t result = 0;
+
+        EXPECT_EQ(ESP_ERR_INVALID_ARG, psum.reduce(samples.data(), count, ADC_BOUNDS, result)) << "at " << bad;
+        EXPECT_EQ(-1, result);
+    }
+}
+
+/**
+ * @test Verifies that the total is checked after combining: every partial
+ *       is within bounds, but their sum is not.
+ */
+TEST_P(ParallelSumTest, TotalOutOfRangeFails)
+{
+    ParallelSum psum(GetParam());
+    std::vector<int16_t> samples(65536, 1);
+    int64_t result = 0;
+
+    EXPECT_EQ(ESP_FAIL, psum.reduce(samples.data(), samples.size(), {0, 10, 0, 65535}, result));
+    EXPECT_EQ(-1, result);
+
+    EXPECT_EQ(ESP_OK, psum.reduce(samples.data(), samples.size(), {0, 10, 0, 65536}, result));
+    EXPECT_EQ(65536, result);
+}
+
+/**
+ * @test Verifies that an invalid sample wins over a bad total, the same
+ *       order add_constrained_err checks in.
+ */
+TEST_P(ParallelSumTest, InvalidSampleWinsOverTotal)
+{
+    ParallelSum psum(GetParam());
+    std::vector<int16_t> samples(65536, 10);
+    samples[100] = 11;
+    int64_t result = 0;
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, psum.reduce(samples.data(), samples.size(), {0, 10, 0, 10}, result));
+}
+
+/**
+ * @test Verifies that the pool can be reused for many jobs in a row.
+ */
+TEST_P(ParallelSumTest, ReusesWorkers)
+{
+    ParallelSum psum(GetParam());
+    std::vector<int16_t> samples(50000, 2);
+
+    for (int i = 0; i < 50; i++) {
+        int64_t result = 0;
+        ASSERT_EQ(ESP_OK, psum.reduce(samples.data(), samples.size(), ADC_BOUNDS, result));
+        ASSERT_EQ(100000, result);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Workers, ParallelSumTest, ::testing::Values(1, 2, 4, 7));
+
+/**
+ * @test With Sum's bounds and a two-sample buffer, the result matches
+ *       add_constrained_err for every pair.
+ */
+TEST(ParallelSumPairTest, AgreesWithAddConstrainedErr)
+{
+    Sum calc;
+    ParallelSum psum(2);
+    for (int a = -2; a <= 12; a++) {
+        for (int b = -2; b <= 12; b++) {
+            const int16_t pair[] = {static_cast<int16_t>(a), static_cast<int16_t>(b)};
+            int expected_result = 0;
+            int64_t result = 0;
+
+            esp_err_t expected = calc.add_constrained_err_isr(a, b, expected_result);
+            EXPECT_EQ(expected, psum.reduce(pair, 2, {0, 10, 0, 10}, result)) << a << " + " << b;
+            EXPECT_EQ(expected_result, result);
+        }
+    }
+}
@@ -0,0 +1,152 @@
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "atomic_led_sink.hpp"
+#include "compute_request.hpp"
+#include "result_fanout.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+// -------------------------------------------------------------------
+// ResultFanout
+// -------------------------------------------------------------------
+// The sinks derive from nothing: all a fanout needs is on_result().
+
+// Keeps every result it gets, with the order of arrival across sinks
+class RecordingSink
+{
+public:
+    RecordingSink(std::vector<const RecordingSink *> *arrivals = nullptr)
+        : arrivals_(arrivals)
+    {
+    }
+
+    void on_result(const SumResult &result)
+    {
+        results.push_back(result);
+        if (arrivals_ != nullptr) {
+            arrivals_->push_back(this);
+        }
+    }
+
+    std::vector<SumResult> results;
+
+private:
+    std::vector<const RecordingSink *> *arrivals_;
+};
+
+// Fails the test if a disabled route ever calls it
+class ForbiddenSink
+{
+public:
+    void on_result(const SumResult &) { ADD_FAILURE() << "a disabled route was called"; }
+};
+
+static SumResult make_result(esp_err_t err)
+{
+    return {1, 2, err == ESP_OK ? 3 : -1, err, true};
+}
+
+/**
+ * @test Verifies that ResultMask::of() puts each error in the class that
+ *       LedPatterns::for_result gives it a blink code for.
+ */
+TEST(ResultFanoutTest, ClassifiesResults)
+{
+    EXPECT_EQ(ResultMask::OK, ResultMask::of(ESP_OK));
+    EXPECT_EQ(ResultMask::OUT_OF_RANGE, ResultMask::of(ESP_FAIL));
+    EXPECT_EQ(ResultMask::INVALID_ARG, ResultMask::of(ESP_ERR_INVALID_ARG));
+    EXPECT_EQ(ResultMask::OTHER_ERROR, ResultMask::of(ESP_ERR_NO_MEM));
+    static_assert(ResultMask::ALL == (ResultMask::OK | ResultMask::ERRORS), "every class is in ALL");
+}
+
+/**
+ * @test Verifies the per-sink filtering: each sink gets exactly the
+ *       results its mask lets through, and the sinks are called in the
+ *       order they were given.
+ */
+TEST(ResultFanoutTest, RoutesByMask)
+{
+    std::vector<const RecordingSink *> arrivals;
+    RecordingSink everything(&arrivals);
+    RecordingSink errors(&arrivals);
+    RecordingSink invalid(&arrivals);
+    ResultFanout fanout(route<ResultMask::ALL>(everything), route<ResultMask::ERRORS>(errors),
+                        route<ResultMask::INVALID_ARG>(invalid));
+
+    fanout.publish(make_result(ESP_OK));
+    fanout.publish(make_result(ESP_FAIL));
+    fanout.publish(make_result(ESP_ERR_INVALID_ARG));
+
+    EXPECT_EQ(3u, everything.results.size());
+    ASSERT_EQ(2u, errors.results.size());
+    EXPECT_EQ(ESP_FAIL, errors.results[0].err);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, errors.results[1].err);
+    ASSERT_EQ(1u, invalid.results.size());
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, invalid.results[0].err);
+
+    std::vector<const RecordingSink *> expected = {&everything,         // ESP_OK
+                                                   &everything, &errors, // ESP_FAIL
+                                                   &everything, &errors, &invalid};
+    EXPECT_EQ(expected, arrivals);
+}
+
+/**
+ * @test Verifies that a disabled route is never called and takes no room:
+ *       it holds no reference, so a fanout of disabled routes is as big as
+ *       an empty one.
+ */
+TEST(ResultFanoutTest, DisabledRouteCostsNothing)
+{
+    typedef ResultRoute<ResultMask::NONE, ForbiddenSink> Disabled;
+    static_assert(std::is_empty<Disabled>::value, "a disabled route keeps nothing");
+    static_assert(sizeof(ResultFanout<Disabled>) == sizeof(ResultFanout<>), "and adds nothing to the fanout");
+
+    ForbiddenSink forbidden;
+    RecordingSink kept;
+    ResultFanout fanout(route<ResultMask::NONE>(forbidden), route<ResultMask::ALL>(kept));
+    fanout.publish(make_result(ESP_OK));
+    fanout.publish(make_result(ESP_FAIL));
+    EXPECT_EQ(2u, kept.results.size());
+}
+
+/**
+ * @test Verifies that SumBoss publishes each compute() result, and one that
+ *       went through process(), with its operands, its sum error and
+ *       whether the LED changed, while compute_isr() publishes nothing.
+ */
+TEST(ResultFanoutTest, SumBossPublishesComputeResults)
+{
+    Sum sum;
+    AtomicLedSink leds;
+    SumBoss boss(sum, leds);
+    RecordingSink all;
+    RecordingSink errors;
+    ResultFanout fanout(route<ResultMask::ALL>(all), route<ResultMask::ERRORS>(errors));
+    boss.set_observer(&fanout);
+
+    int result;
+    EXPECT_EQ(ESP_OK, boss.compute(2, 3, result));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, boss.compute(-1, 3, result));
+    ComputeRequest request = {};
+    request.a = 4;
+    request.b = 5;
+    EXPECT_EQ(ESP_OK, boss.process(request));
+    EXPECT_EQ(ESP_OK, boss.compute_isr(1, 1, result)); // Not published
+
+    ASSERT_EQ(3u, all.results.size());
+    EXPECT_EQ(2, all.results[0].a);
+    EXPECT_EQ(3, all.results[0].b);
+    EXPECT_EQ(5, all.results[0].result);
+    EXPECT_EQ(ESP_OK, all.results[0].err);
+    EXPECT_TRUE(all.results[0].led_changed);
+    EXPECT_EQ(9, all.results[2].result);
+    ASSERT_EQ(1u, errors.results.size());
+    EXPECT_EQ(-1, errors.results[0].a);
+
+    boss.set_observer(nullptr);
+    EXPECT_EQ(ESP_OK, boss.compute(2, 3, result));
+    EXPECT_EQ(3u, all.results.size());
+}
@@ -0,0 +1,135 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "fake_dma_tx.hpp"
+#include "rmt_led_sargent.hpp"
+
+// -------------------------------------------------------------------
+// RmtLedSargent on FakeDmaTx
+// -------------------------------------------------------------------
+// The frame handling is DoubleBufferedTx's, covered with
+// ShiftRegisterGpioHal. These tests only cover what is WS2812: the byte
+// order, the colors and the brightness.
+static const size_t PIXELS = 3;
+
+typedef FakeDmaTx::Frame Frame;
+
+struct Rgb
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+};
+
+// The strip, as FakeDmaTx's decoder: each pixel takes 3 bytes, G, R, B
+class Ws2812Strip
+{
+public:
+    void latch(const Frame &frame)
+    {
+        pixels_.clear();
+        for (size_t i = 0; i + 2 < frame.size(); i += 3) {
+            pixels_.push_back({frame[i + 1], frame[i], frame[i + 2]});
+        }
+    }
+
+    const std::vector<Rgb> &pixels() const { return pixels_; }
+
+private:
+    std::vector<Rgb> pixels_;
+};
+
+class RmtLedSargentTest : public ::testing::Test
+{
+protected:
+    // Every pixel of the strip shows r, g, 0
+    void expect_strip(uint8_t r, uint8_t g)
+    {
+        ASSERT_EQ(PIXELS, strip_.pixels().size());
+        for (size_t p = 0; p < PIXELS; p++) {
+            EXPECT_EQ(r, strip_.pixels()[p].r) << "pixel " << p;
+            EXPECT_EQ(g, strip_.pixels()[p].g) << "pixel " << p;
+            EXPECT_EQ(0, strip_.pixels()[p].b) << "pixel " << p;
+        }
+    }
+
+    Ws2812Strip strip_;
+    FakeDmaTx rmt_{[this](const Frame &frame) { strip_.latch(frame); }};
+};
+
+/**
+ * @test Verifies the frame: 3 bytes per pixel, all off from the
+ *       constructor, then in the WS2812's G, R, B order.
+ */
+TEST_F(RmtLedSargentTest, FramesAreGrb)
+{
+    const uint8_t level = RmtLedSargent::level_for(RmtLedSargent::DEFAULT_BRIGHTNESS);
+    RmtLedSargent leds(rmt_, PIXELS);
+    ASSERT_EQ(ESP_OK, leds.green());
+    rmt_.complete();
+    rmt_.complete();
+
+    ASSERT_EQ(2u, rmt_.frames().size());
+    EXPECT_EQ(Frame(PIXELS * 3, 0), rmt_.frames()[0]);
+    EXPECT_EQ((Frame{level, 0, 0, level, 0, 0, level, 0, 0}), rmt_.frames()[1]);
+}
+
+/**
+ * @test Verifies the LedSargent contract on the colors: green() and red()
+ *       each leave the other color alone, so both lit show yellow, and
+ *       off() clears both.
+ */
+TEST_F(RmtLedSargentTest, ColorsFollowTheContract)
+{
+    RmtLedSargent leds(rmt_, PIXELS);
+    ASSERT_EQ(ESP_OK, leds.set_brightness(100));
+
+    ASSERT_EQ(ESP_OK, leds.green());
+    rmt_.complete();
+    rmt_.complete();
+    expect_strip(0, 255);
+
+    ASSERT_EQ(ESP_OK, leds.red());
+    rmt_.complete();
+    expect_strip(255, 255);
+
+    ASSERT_EQ(ESP_OK, leds.off());
+    rmt_.complete();
+    expect_strip(0, 0);
+}
+
+/**
+ * @test Verifies set_brightness(): it rescales the colors already lit,
+ *       sends nothing while the pixels are off, and refuses more than 100%.
+ */
+TEST_F(RmtLedSargentTest, BrightnessScalesTheColors)
+{
+    RmtLedSargent leds(rmt_, PIXELS);
+    EXPECT_EQ(ESP_OK, leds.set_brightness(50));
+    rmt_.complete();
+    EXPECT_EQ(1u, rmt_.frames().size()); // Only the one from the constructor
+
+    ASSERT_EQ(ESP_OK, leds.red());
+    rmt_.complete();
+    expect_strip(128, 0);
+
+    ASSERT_EQ(ESP_OK, leds.set_brightness(0));
+    rmt_.complete();
+    expect_strip(0, 0);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, leds.set_brightness(101));
+}
+
+/**
+ * @test Verifies the strip length checks: an empty strip and one longer
+ *       than MAX_PIXELS send nothing and return the error.
+ */
+TEST_F(RmtLedSargentTest, RejectsBadStrip)
+{
+    RmtLedSargent empty(rmt_, 0);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, empty.green());
+    RmtLedSargent too_long(rmt_, RmtLedSargent::MAX_PIXELS + 1);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, too_long.set_brightness(50));
+    EXPECT_EQ(0u, rmt_.frames().size() + rmt_.in_flight());
+}
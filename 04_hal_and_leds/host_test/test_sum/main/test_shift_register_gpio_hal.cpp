@@ -0,0 +1,184 @@
+#include "gtest/gtest.h"
+
+#include "fake_dma_tx.hpp"
+#include "led_bank.hpp"
+#include "led_sargent.hpp"
+#include "shift_register_gpio_hal.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+// -------------------------------------------------------------------
+// ShiftRegisterGpioHal on FakeDmaTx
+// -------------------------------------------------------------------
+// Two 74HC595 in a chain: outputs 0-7 on the register wired to the MCU,
+// 8-15 on the next one.
+static const size_t REGISTERS = 2;
+
+typedef FakeDmaTx::Frame Frame;
+
+// The chain, as FakeDmaTx's decoder: each frame is shifted in MSB first,
+// into QA of register 0 and on towards QH of the last one, then latched
+class ShiftChain
+{
+public:
+    explicit ShiftChain(size_t registers)
+        : outputs_(registers * 8, 0)
+    {
+    }
+
+    void latch(const Frame &frame)
+    {
+        std::vector<int> chain = outputs_;
+        for (uint8_t byte : frame) {
+            for (int bit = 7; bit >= 0; bit--) {
+                for (size_t p = chain.size() - 1; p > 0; p--) {
+                    chain[p] = chain[p - 1];
+                }
+                chain[0] = (byte >> bit) & 1;
+            }
+        }
+        outputs_ = chain;
+    }
+
+    // Output n of the chain, as latched by the last frame
+    int output(size_t n) const { return outputs_[n]; }
+
+private:
+    std::vector<int> outputs_;
+};
+
+class ShiftRegisterGpioHalTest : public ::testing::Test
+{
+protected:
+    ShiftChain chain_{REGISTERS};
+    FakeDmaTx spi_{[this](const Frame &frame) { chain_.latch(frame); }};
+};
+
+/**
+ * @test Verifies that the constructor clears every output with one frame.
+ */
+TEST_F(ShiftRegisterGpioHalTest, ClearsTheChainFirst)
+{
+    ShiftRegisterGpioHal hal(spi_, REGISTERS);
+    EXPECT_EQ(16u, hal.outputs());
+    EXPECT_EQ(1u, spi_.in_flight());
+    spi_.complete();
+    ASSERT_EQ(1u, spi_.frames().size());
+    EXPECT_EQ((Frame{0x00, 0x00}), spi_.frames()[0]);
+}
+
+/**
+ * @test Verifies the byte order: each output lands on the right 74HC595
+ *       output once the frame is shifted through the chain, with the
+ *       first byte sent ending up in the last register.
+ */
+TEST_F(ShiftRegisterGpioHalTest, OutputsLandOnTheChain)
+{
+    ShiftRegisterGpioHal hal(spi_, REGISTERS);
+    ASSERT_EQ(ESP_OK, hal.pin_set_level(GPIO_NUM_1, 1));
+    ASSERT_EQ(ESP_OK, hal.pin_set_level(GPIO_NUM_15, 1));
+    spi_.complete();
+    spi_.complete();
+    spi_.complete();
+
+    EXPECT_EQ((Frame{0x80, 0x02}), spi_.frames().back());
+    for (size_t n = 0; n < hal.outputs(); n++) {
+        EXPECT_EQ((n == 1 || n == 15) ? 1 : 0, chain_.output(n)) << "output " << n;
+    }
+    EXPECT_EQ(1, hal.pin_get_level(GPIO_NUM_15));
+    EXPECT_EQ(0, hal.pin_get_level(GPIO_NUM_14));
+}
+
+/**
+ * @test Verifies the double buffering: a write fills the free frame while
+ *       the other is in flight, never one the DMA still reads, and only
+ *       waits when both are in flight.
+ */
+TEST_F(ShiftRegisterGpioHalTest, WritesFillTheFreeFrame)
+{
+    spi_.stall(true); // No transfer ends unless the test says so
+    ShiftRegisterGpioHal hal(spi_, REGISTERS);
+
+    ASSERT_EQ(ESP_OK, hal.pin_set_level(GPIO_NUM_0, 1)); // The other frame
+    EXPECT_EQ(2u, spi_.in_flight());
+
+    // Both in flight: the write waits for the older one, which stalls
+    EXPECT_EQ(ESP_ERR_TIMEOUT, hal.pin_set_level(GPIO_NUM_2, 1));
+    EXPECT_EQ(1, hal.pin_get_level(GPIO_NUM_2)); // Kept for the next frame
+
+    spi_.complete(); // The older one ends
+    ASSERT_EQ(ESP_OK, hal.pin_set_level(GPIO_NUM_3, 1));
+    spi_.complete();
+    spi_.complete();
+
+    ASSERT_EQ(3u, spi_.frames().size());
+    EXPECT_EQ((Frame{0x00, 0x0D}), spi_.frames()[2]); // Outputs 0, 2 and 3
+    EXPECT_EQ(0, spi_.corrupted());
+}
+
+/**
+ * @test Verifies that port_set_levels() sends one frame for any number of
+ *       outputs, so a LedBank on the chain shows a whole state per frame,
+ *       and that LedSargent drives the chain for SumBoss.
+ */
+TEST_F(ShiftRegisterGpioHalTest, DrivesLedBankAndLedSargent)
+{
+    ShiftRegisterGpioHal hal(spi_, REGISTERS);
+    LedBank<GPIO_NUM_0, GPIO_NUM_7, GPIO_NUM_8, GPIO_NUM_12> bank(hal);
+    ASSERT_EQ(ESP_OK, bank.show(0b1011));
+    spi_.complete();
+    spi_.complete();
+    EXPECT_EQ(2u, spi_.frames().size()); // The clear, then the whole state
+    EXPECT_EQ((Frame{0x10, 0x81}), spi_.frames()[1]); // Pins 0, 7 and 12
+
+    LedSargent leds(hal, GPIO_NUM_4, GPIO_NUM_5);
+    Sum sum;
+    SumBoss boss(sum, leds);
+    int result;
+    EXPECT_EQ(ESP_OK, boss.compute(2, 3, result));
+    spi_.complete();
+    EXPECT_EQ(1, chain_.output(4));
+    EXPECT_EQ(1, chain_.output(0)); // The bank's LEDs are still on
+}
+
+/**
+ * @test Verifies the checks: a chain of 0 or more than MAX_REGISTERS, a pin
+ *       past the chain, a direction that isn't an output, and a device
+ *       that can't take the first frame.
+ */
+TEST_F(ShiftRegisterGpioHalTest, RejectsBadSetup)
+{
+    ShiftRegisterGpioHal empty(spi_, 0);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, empty.pin_set_direction(GPIO_NUM_0, GPIO_MODE_OUTPUT));
+    ShiftRegisterGpioHal too_long(spi_, ShiftRegisterGpioHal::MAX_REGISTERS + 1);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, too_long.port_set_levels(1, 0));
+    EXPECT_EQ(0u, spi_.frames().size() + spi_.in_flight());
+
+    ShiftRegisterGpioHal hal(spi_, REGISTERS);
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, hal.pin_set_direction(GPIO_NUM_16, GPIO_MODE_OUTPUT));
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, hal.pin_set_direction(GPIO_NUM_0, GPIO_MODE_INPUT));
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, hal.pin_set_direction(GPIO_NUM_0, GPIO_MODE_DISABLE));
+    EXPECT_EQ(ESP_OK, hal.pin_set_direction(GPIO_NUM_0, GPIO_MODE_OUTPUT_OD));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, hal.port_set_levels(1ull << 16, 0));
+    EXPECT_EQ(ESP_ERR_NOT_SUPPORTED, hal.pin_set_intr(GPIO_NUM_0, GPIO_INTR_ANYEDGE, nullptr, nullptr));
+
+    FakeDmaTx full(FakeDmaTx::Decoder(), 0);
+    ShiftRegisterGpioHal broken(full, REGISTERS);
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, broken.pin_set_direction(GPIO_NUM_0, GPIO_MODE_OUTPUT));
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, broken.pin_set_level(GPIO_NUM_0, 1));
+}
+
+/**
+ * @test Verifies that destroying the HAL waits for its frames to leave the
+ *       DMA, since they live inside the object.
+ */
+TEST_F(ShiftRegisterGpioHalTest, DestructorWaitsForTheDma)
+{
+    {
+        ShiftRegisterGpioHal hal(spi_, REGISTERS);
+        ASSERT_EQ(ESP_OK, hal.pin_set_level(GPIO_NUM_0, 1));
+        EXPECT_EQ(2u, spi_.in_flight());
+    }
+    EXPECT_EQ(0u, spi_.in_flight());
+    EXPECT_EQ(0, spi_.corrupted());
+}
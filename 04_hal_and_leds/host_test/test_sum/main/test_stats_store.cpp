@@ -0,0 +1,278 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "esp_private/partition_linux.h"
+#include "nvs_flash.h"
+
+#include "mock_led_sargent.hpp"
+#include "mock_sum.hpp"
+#include "stats_store.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+#include "virtual_clock.hpp"
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+// -------------------------------------------------------------------
+// StatsStore — on the NVS host implementation
+// -------------------------------------------------------------------
+// On the linux target, NVS runs on an emulated flash partition that
+// counts every write operation (CONFIG_ESP_PARTITION_ENABLE_STATS), so
+// the tests can check what actually reaches flash.
+
+class StatsStoreTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        VirtualClock::reset();
+        nvs_flash_erase();
+        ASSERT_EQ(ESP_OK, nvs_flash_init());
+    }
+
+    void TearDown() override { nvs_flash_deinit(); }
+
+    static StatsStoreConfig config(uint32_t commit_every, int64_t commit_interval_us)
+    {
+        return {"test_stats", "sum_stats", commit_every, commit_interval_us, VirtualClock::now_us};
+    }
+
+    // Flash write operations since the last call
+    static size_t flash_writes()
+    {
+        size_t writes = esp_partition_get_write_ops();
+        esp_partition_clear_stats();
+        return writes;
+    }
+};
+
+/**
+ * @test Verifies that a store with nothing in NVS starts from zero, and
+ *       that flushing it with nothing recorded writes nothing.
+ */
+TEST_F(StatsStoreTest, FirstBootStartsFromZero)
+{
+    StatsStore store(config(10, 0));
+    flash_writes(); // nvs_open creates the namespace
+
+    SumStats stats = store.totals();
+    EXPECT_EQ(0u, stats.successes);
+    EXPECT_EQ(0u, stats.out_of_range);
+    EXPECT_EQ(0u, stats.invalid_args);
+    EXPECT_EQ(0u, stats.other_errors);
+    EXPECT_EQ(0u, stats.led_errors);
+
+    EXPECT_EQ(ESP_OK, store.flush());
+    EXPECT_EQ(0u, store.commits());
+    EXPECT_EQ(0u, flash_writes());
+}
+
+/**
+ * @test Verifies that records stay in RAM until commit_every of them are
+ *       pending, and that the commit is then a single blob write.
+ */
+TEST_F(StatsStoreTest, CommitsOnCountThreshold)
+{
+    StatsStore store(config(10, 0));
+    flash_writes();
+
+    for (int i = 0; i < 9; i++) {
+        store.record(ESP_OK, true);
+        EXPECT_EQ(ESP_OK, store.commit_if_due());
+    }
+    EXPECT_EQ(0u, store.commits());
+    EXPECT_EQ(9u, store.pending());
+    EXPECT_EQ(0u, flash_writes());
+
+    store.record(ESP_OK, true);
+    EXPECT_EQ(ESP_OK, store.commit_if_due());
+    EXPECT_EQ(1u, store.commits());
+    EXPECT_EQ(0u, store.pending());
+    EXPECT_GT(flash_writes(), 0u);
+}
+
+/**
+ * @test Verifies that pending records are committed once commit_interval_us
+ *       has passed since the last commit, and not a microsecond earlier.
+ */
+TEST_F(StatsStoreTest, CommitsOnTimeThreshold)
+{
+    StatsStore store(config(0, 60 * 1000 * 1000));
+    flash_writes();
+
+    store.record(ESP_FAIL, true);
+    VirtualClock::delay_ms(59999);
+    EXPECT_EQ(ESP_OK, store.commit_if_due());
+    EXPECT_EQ(0u, store.commits());
+    EXPECT_EQ(0u, flash_writes());
+
+    VirtualClock::delay_ms(1);
+    EXPECT_EQ(ESP_OK, store.commit_if_due());
+    EXPECT_EQ(1u, store.commits());
+    EXPECT_GT(flash_writes(), 0u);
+
+    // The interval counts from the last commit, and nothing is pending
+    VirtualClock::delay_ms(120000);
+    EXPECT_EQ(ESP_OK, store.commit_if_due());
+    EXPECT_EQ(1u, store.commits());
+    EXPECT_EQ(0u, flash_writes());
+}
+
+/**
+ * @test Verifies that every counter survives a restart, both after an
+ *       explicit flush() and through the destructor's flush.
+ */
+TEST_F(StatsStoreTest, CountersSurviveARestart)
+{
+    {
+        StatsStore store(config(0, 0));
+        store.record(ESP_OK, true);
+        store.record(ESP_OK, false);
+        store.record(ESP_FAIL, true);
+        store.record(ESP_ERR_INVALID_ARG, true);
+        store.record(ESP_ERR_TIMEOUT, false);
+        EXPECT_EQ(ESP_OK, store.flush());
+        store.record(ESP_OK, true); // Left for the destructor
+    }
+
+    StatsStore store(config(0, 0));
+    SumStats stats = store.totals();
+    EXPECT_EQ(3u, stats.successes);
+    EXPECT_EQ(1u, stats.out_of_range);
+    EXPECT_EQ(1u, stats.invalid_args);
+    EXPECT_EQ(1u, stats.other_errors);
+    EXPECT_EQ(2u, stats.led_errors);
+    EXPECT_EQ(0u, store.pending());
+}
+
+/**
+ * @test Verifies that the shutdown handler flushes the installed store,
+ *       and does nothing once that store is gone.
+ */
+TEST_F(StatsStoreTest, ShutdownHookFlushes)
+{
+    {
+        StatsStore store(config(0, 0));
+        ASSERT_EQ(ESP_OK, store.install_shutdown_hook());
+        store.record(ESP_OK, true);
+        store.record(ESP_OK, true);
+
+        StatsStore::on_shutdown(); // What esp_restart() would run
+        EXPECT_EQ(1u, store.commits());
+        EXPECT_EQ(0u, store.pending());
+    }
+    StatsStore::on_shutdown(); // Uninstalled by the destructor: no-op
+
+    StatsStore store(config(0, 0));
+    EXPECT_EQ(2u, store.totals().successes);
+}
+
+/**
+ * @test Verifies that a blob with another layout under the same key is
+ *       ignored, and replaced by the first commit.
+ */
+TEST_F(StatsStoreTest, AnotherLayoutStartsFromZero)
+{
+    nvs_handle_t handle;
+    ASSERT_EQ(ESP_OK, nvs_open("test_stats", NVS_READWRITE, &handle));
+    const uint32_t old_layout[2] = {7, 7};
+    ASSERT_EQ(ESP_OK, nvs_set_blob(handle, "sum_stats", old_layout, sizeof(old_layout)));
+    ASSERT_EQ(ESP_OK, nvs_commit(handle));
+    nvs_close(handle);
+
+    {
+        StatsStore store(config(0, 0));
+        EXPECT_EQ(0u, store.totals().successes);
+        store.record(ESP_OK, true);
+    }
+
+    StatsStore store(config(0, 0));
+    EXPECT_EQ(1u, store.totals().successes);
+}
+
+/**
+ * @test Verifies that SumBoss counts every outcome: what Sum returned, and
+ *       whether the LED call worked. compute_isr() counts too, but never
+ *       commits.
+ */
+TEST_F(StatsStoreTest, SumBossCountsEveryOutcome)
+{
+    NiceMock<MockSum> mock_sum;
+    NiceMock<MockLedSargent> mock_led;
+    SumBoss boss(mock_sum, mock_led);
+    StatsStore store(config(1, 0));
+    boss.set_stats(&store);
+
+    EXPECT_CALL(mock_sum, add_constrained_err(_, _, _))
+        .WillOnce(Return(ESP_OK))
+        .WillOnce(Return(ESP_FAIL))
+        .WillOnce(Return(ESP_ERR_INVALID_ARG))
+        .WillOnce(Return(ESP_ERR_TIMEOUT));
+    EXPECT_CALL(mock_led, red()).WillOnce(Return(ESP_FAIL)).WillRepeatedly(Return(ESP_OK));
+
+    int result;
+    boss.compute(1, 2, result);
+    boss.compute(1, 2, result);
+    boss.compute(1, 2, result);
+    boss.compute(1, 2, result);
+    EXPECT_EQ(4u, store.commits()); // commit_every = 1
+
+    EXPECT_CALL(mock_sum, add_constrained_err_isr(_, _, _)).WillOnce(Return(ESP_OK));
+    boss.compute_isr(1, 2, result);
+    EXPECT_EQ(4u, store.commits());
+    EXPECT_EQ(1u, store.pending());
+
+    SumStats stats = store.totals();
+    EXPECT_EQ(2u, stats.successes);
+    EXPECT_EQ(1u, stats.out_of_range);
+    EXPECT_EQ(1u, stats.invalid_args);
+    EXPECT_EQ(1u, stats.other_errors);
+    EXPECT_EQ(1u, stats.led_errors);
+
+    boss.set_stats(nullptr);
+}
+
+/**
+ * @test Verifies the point of batching: 1000 computes committed every 100
+ *       records cost a small fraction of the flash writes that committing
+ *       every record does, and both end with the same counters in NVS.
+ */
+TEST_F(StatsStoreTest, BatchingCutsFlashWrites)
+{
+    Sum sum;
+    NiceMock<MockLedSargent> mock_led;
+    SumBoss boss(sum, mock_led);
+    const int COMPUTES = 1000;
+
+    size_t writes[2];
+    const uint32_t commit_every[2] = {1, 100};
+    for (int run = 0; run < 2; run++) {
+        {
+            StatsStore store(config(commit_every[run], 0));
+            boss.set_stats(&store);
+            flash_writes();
+            int result;
+            for (int i = 0; i < COMPUTES; i++) {
+                boss.compute(i % 12, 1, result); // 10 + 1 is out of range, 11 is invalid
+            }
+            boss.set_stats(nullptr);
+            EXPECT_EQ(COMPUTES / commit_every[run], store.commits());
+            writes[run] = flash_writes();
+        }
+
+        {
+            StatsStore reloaded(config(0, 0));
+            EXPECT_EQ(834u, reloaded.totals().successes);
+            EXPECT_EQ(83u, reloaded.totals().out_of_range);
+            EXPECT_EQ(83u, reloaded.totals().invalid_args);
+        }
+
+        nvs_flash_deinit();
+        nvs_flash_erase();
+        ASSERT_EQ(ESP_OK, nvs_flash_init());
+    }
+
+    EXPECT_LT(writes[1] * 20, writes[0]) << "batched " << writes[1] << ", unbatched " << writes[0];
+}
@@ -1,32 +1,11 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
-#include "i_led_sargent.hpp"
-#include "i_sum.hpp"
+#include "mock_led_sargent.hpp"
+#include "mock_sum.hpp"
 #include "sum.hpp"
 #include "sum_boss.hpp"
 
-// Mock class for ISum
-class MockSum : public ISum
-{
-public:
-    // Mock each virtual method from ISum.
-    // MOCK_METHOD macro syntax: (return_type, method_name, (parameters), (override))
-
-    MOCK_METHOD(int, add, (int a, int b), (override));
-    MOCK_METHOD(int, add_constrained, (int a, int b), (override));
-    MOCK_METHOD(esp_err_t, add_constrained_err, (int a, int b, int &result), (override));
-};
-
-// Mock class for ILedSargent
-class MockLedSargent : public ILedSargent
-{
-public:
-    MOCK_METHOD(esp_err_t, green, (), (override));
-    MOCK_METHOD(esp_err_t, red, (), (override));
-    MOCK_METHOD(esp_err_t, off, (), (override));
-};
-
 // Bring commonly used GMock matchers and actions into scope.
 // This makes test code more readable (e.g., using _ instead of testing::_).
 using ::testing::_;             // Wildcard matcher — matches any value
@@ -112,6 +91,43 @@ TEST(SumBossTest, PropagatesRedIgnoresLedError)
     EXPECT_EQ(ESP_FAIL, err);
 }
 
+// compute_isr() — same decisions as compute(), through the no-log variant of Sum
+TEST(SumBossTest, ComputeIsrUsesIsrVariant)
+{
+    NiceMock<MockSum> mock_sum;
+    NiceMock<MockLedSargent> mock_led;
+    SumBoss boss(mock_sum, mock_led);
+
+    // The logging variant must never be called from the ISR path
+    EXPECT_CALL(mock_sum, add_constrained_err(_, _, _)).Times(0);
+    EXPECT_CALL(mock_sum, add_constrained_err_isr(3, 4, _)).WillOnce(DoAll(SetArgReferee<2>(7), Return(ESP_OK)));
+    EXPECT_CALL(mock_led, green()).WillOnce(Return(ESP_OK));
+    EXPECT_CALL(mock_led, red()).Times(0);
+
+    int result;
+    esp_err_t err = boss.compute_isr(3, 4, result);
+
+    EXPECT_EQ(ESP_OK, err);
+    EXPECT_EQ(7, result);
+}
+
+TEST(SumBossTest, ComputeIsrCallsRedOnError)
+{
+    NiceMock<MockSum> mock_sum;
+    NiceMock<MockLedSargent> mock_led;
+    SumBoss boss(mock_sum, mock_led);
+
+    EXPECT_CALL(mock_sum, add_constrained_err(_, _, _)).Times(0);
+    EXPECT_CALL(mock_sum, add_constrained_err_isr(6, 6, _)).WillOnce(Return(ESP_FAIL));
+    EXPECT_CALL(mock_led, green()).Times(0);
+    EXPECT_CALL(mock_led, red()).WillOnce(Return(ESP_ERR_INVALID_ARG));
+
+    int result;
+    esp_err_t err = boss.compute_isr(6, 6, result);
+
+    EXPECT_EQ(ESP_FAIL, err); // same rule as compute(): the sum error wins
+}
+
 // Integration tests — real Sum, mocked LED
 TEST(SumBossRealSumTest, CallsGreenOnSuccess)
 {
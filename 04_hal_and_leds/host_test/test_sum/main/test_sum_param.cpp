@@ -52,6 +52,21 @@ TEST_P(SumParamTest, AddConstrainedErr)
     EXPECT_EQ(result, params.result);
 }
 
+/**
+ * @test Verifies that add_constrained_err_isr, the no-log variant used on the
+ * ISR path, gives exactly the same result and error as add_constrained_err.
+ */
+TEST_P(SumParamTest, AddConstrainedErrIsr)
+{
+    const auto &params = GetParam();
+    int result = 0xDEADBEEF; // Dummy value
+
+    esp_err_t err = calc.add_constrained_err_isr(params.a, params.b, result);
+
+    EXPECT_EQ(err, params.error);
+    EXPECT_EQ(result, params.result);
+}
+
 /**
  * @test Verifies that the add_constrained_err(int a, int b, int &result) function
  * correctly handles invalid input values.
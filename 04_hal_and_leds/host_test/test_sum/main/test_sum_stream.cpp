@@ -0,0 +1,173 @@
+#include <stdlib.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "sum.hpp"
+#include "sum_stream.hpp"
+
+// 12-bit ADC samples, running sum kept within +/- 1,000,000
+static const SumStreamBounds ADC_BOUNDS = {0, 4095, 0, 1000000};
+
+// Straightforward reference: one sample at a time, no vectors
+static std::vector<int32_t> reference_prefix(const std::vector<int16_t> &samples)
+{
+    std::vector<int32_t> out;
+    int32_t total = 0;
+    for (int16_t s : samples) {
+        total += s;
+        out.push_back(total);
+    }
+    return out;
+}
+
+static std::vector<int16_t> random_samples(size_t count, int max)
+{
+    std::vector<int16_t> samples(count);
+    for (auto &s : samples) {
+        s = static_cast<int16_t>(rand() % (max + 1));
+    }
+    return samples;
+}
+
+// ======================================================================
+// Prefix sums
+// ======================================================================
+
+/**
+ * @test Verifies that a whole buffer in one chunk gives the same prefix
+ *       sums as the scalar reference, for sizes around the 4-sample block.
+ */
+TEST(SumStreamTest, MatchesReferenceForAllSizes)
+{
+    srand(1);
+    for (size_t count = 0; count <= 19; count++) {
+        std::vector<int16_t> samples = random_samples(count, 4095);
+        std::vector<int32_t> prefix(count);
+        SumStream stream(ADC_BOUNDS);
+
+        size_t accepted = 0;
+        ASSERT_EQ(ESP_OK, stream.feed(samples.data(), count, prefix.data(), accepted));
+        EXPECT_EQ(count, accepted);
+        EXPECT_EQ(reference_prefix(samples), prefix) << "count " << count;
+        EXPECT_EQ(count, stream.position());
+    }
+}
+
+/**
+ * @test Verifies that state carries across chunks: splitting a buffer at
+ *       any point, like the two halves of a ring buffer, gives the same
+ *       result as feeding it whole.
+ */
+TEST(SumStreamTest, StateCarriesAcrossChunks)
+{
+    srand(2);
+    std::vector<int16_t> samples = random_samples(37, 4095);
+    std::vector<int32_t> expected = reference_prefix(samples);
+
+    for (size_t split = 0; split <= samples.size(); split++) {
+        std::vector<int32_t> prefix(samples.size());
+        SumStream stream(ADC_BOUNDS);
+        size_t accepted = 0;
+
+        ASSERT_EQ(ESP_OK, stream.feed(samples.data(), split, prefix.data(), accepted));
+        ASSERT_EQ(
+            ESP_OK,
+            stream.feed(samples.data() + split, samples.size() - split, prefix.data() + split, accepted));
+
+        EXPECT_EQ(expected, prefix) << "split at " << split;
+        EXPECT_EQ(expected.back(), stream.total());
+    }
+}
+
+// ======================================================================
+// Violations
+// ======================================================================
+
+/**
+ * @test Verifies that a sample out of range stops the stream with
+ *       ESP_ERR_INVALID_ARG at the exact index, for every position.
+ */
+TEST(SumStreamTest, SampleOutOfRangeStopsAtIndex)
+{
+    for (size_t bad = 0; bad < 11; bad++) {
+        std::vector<int16_t> samples(11, 1);
+        samples[bad] = -1;
+        std::vector<int32_t> prefix(samples.size(), 0);
+        SumStream stream(ADC_BOUNDS);
+        size_t accepted = 0;
+
+        EXPECT_EQ(ESP_ERR_INVALID_ARG, stream.feed(samples.data(), samples.size(), prefix.data(), accepted));
+        EXPECT_EQ(bad, accepted);
+        EXPECT_EQ(bad, stream.violation_index());
+        EXPECT_EQ(static_cast<int32_t>(bad), stream.total()); // only the samples before it count
+    }
+}
+
+/**
+ * @test Verifies that the running sum leaving its bounds stops the stream
+ *       with ESP_FAIL, and that the index counts from the stream start,
+ *       not from the chunk.
+ */
+TEST(SumStreamTest, SumOutOfRangeReportsStreamIndex)
+{
+    SumStream stream({0, 100, 0, 250});
+    const int16_t first[] = {100, 100};
+    const int16_t second[] = {10, 20, 30, 40};
+    int32_t prefix[4];
+    size_t accepted = 0;
+
+    ASSERT_EQ(ESP_OK, stream.feed(first, 2, prefix, accepted));
+    EXPECT_EQ(ESP_FAIL, stream.feed(second, 4, prefix, accepted)); // 200+10+20+30 = 260 > 250
+
+    EXPECT_EQ(2u, accepted);
+    EXPECT_EQ(4u, stream.violation_index());
+    EXPECT_EQ(230, stream.total());
+}
+
+/**
+ * @test Verifies that a stopped stream ignores further chunks until reset().
+ */
+TEST(SumStreamTest, ViolationLatchesUntilReset)
+{
+    SumStream stream({0, 10, 0, 10});
+    const int16_t bad[] = {11};
+    const int16_t good[] = {1, 2};
+    int32_t prefix[2];
+    size_t accepted = 0;
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, stream.feed(bad, 1, prefix, accepted));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, stream.feed(good, 2, prefix, accepted));
+    EXPECT_EQ(0u, accepted);
+
+    stream.reset();
+    EXPECT_EQ(ESP_OK, stream.feed(good, 2, prefix, accepted));
+    EXPECT_EQ(3, stream.total());
+    EXPECT_EQ(SumStream::NO_VIOLATION, stream.violation_index());
+}
+
+/**
+ * @test With Sum's own bounds, a two-sample stream gives the same error
+ *       as add_constrained_err for the same pair.
+ */
+TEST(SumStreamTest, AgreesWithAddConstrainedErr)
+{
+    Sum calc;
+    for (int a = -2; a <= 12; a++) {
+        for (int b = -2; b <= 12; b++) {
+            SumStream stream({0, 10, 0, 10});
+            const int16_t pair[] = {static_cast<int16_t>(a), static_cast<int16_t>(b)};
+            int32_t prefix[2];
+            size_t accepted = 0;
+            int result = 0;
+
+            esp_err_t expected = calc.add_constrained_err_isr(a, b, result);
+            esp_err_t err = stream.feed(pair, 2, prefix, accepted);
+
+            EXPECT_EQ(expected, err) << a << " + " << b;
+            if (err == ESP_OK) {
+                EXPECT_EQ(result, stream.total());
+            }
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+
+#include "gtest/gtest-spi.h"
+#include "gtest/gtest.h"
+
+#include "timing_listener.hpp"
+
+// -------------------------------------------------------------------
+// TimingListener
+// -------------------------------------------------------------------
+// Each test drives its own listener by hand, on the running test's
+// TestInfo. The listener installed in main.cpp times these tests too,
+// so the budgets that fail here only exist in the local listener.
+
+static const ::testing::TestInfo &current_test()
+{
+    return *::testing::UnitTest::GetInstance()->current_test_info();
+}
+
+/**
+ * @test Verifies the pattern syntax: '*' and '?', anchored at both ends.
+ */
+TEST(TimingListenerTest, MatchesPatterns)
+{
+    EXPECT_TRUE(TimingListener::matches("*", "SumTest.Add"));
+    EXPECT_TRUE(TimingListener::matches("SumTest.*", "SumTest.Add"));
+    EXPECT_TRUE(TimingListener::matches("*/SumParamTest.*/?", "ValidInputs/SumParamTest.AddConstrainedErr/3"));
+    EXPECT_TRUE(TimingListener::matches("*Sum*Add*", "SumTest.Add"));
+    EXPECT_FALSE(TimingListener::matches("SumTest.*", "SumBossTest.Compute"));
+    EXPECT_FALSE(TimingListener::matches("SumTest.Add", "SumTest.AddMore"));
+    EXPECT_FALSE(TimingListener::matches("?", ""));
+}
+
+/**
+ * @test Verifies that the first matching pattern gives the budget, and
+ *       that malformed entries are skipped.
+ */
+TEST(TimingListenerTest, FirstPatternWins)
+{
+    TimingListener listener(nullptr, "ParallelSumTest.*=2000:broken:=5:Sum*=x:*=500");
+    EXPECT_EQ(2000000, listener.pattern_budget_us("ParallelSumTest.OneWorker"));
+    EXPECT_EQ(500000, listener.pattern_budget_us("SumTest.Add"));
+
+    TimingListener none(nullptr, nullptr);
+    EXPECT_EQ(-1, none.pattern_budget_us("SumTest.Add"));
+}
+
+/**
+ * @test Verifies that a test slower than its budget fails, and that the
+ *       budget is on wall time: sleeping costs wall time, not CPU time.
+ */
+TEST(TimingListenerTest, FailsOverBudget)
+{
+    TimingListener listener(nullptr, "TimingListenerTest.*=1");
+    listener.OnTestStart(current_test());
+    usleep(20000);
+    EXPECT_NONFATAL_FAILURE(listener.OnTestEnd(current_test()), "over its time budget of 1.000 ms");
+
+    ASSERT_EQ(1u, listener.timings().size());
+    const TestTiming &timing = listener.timings()[0];
+    EXPECT_TRUE(timing.over_budget);
+    EXPECT_EQ(1000, timing.budget_us);
+    EXPECT_GE(timing.wall_us, 20000);
+    EXPECT_LT(timing.cpu_us, timing.wall_us);
+}
+
+/**
+ * @test Verifies that TEST_TIME_BUDGET_MS in the test body wins over the
+ *       pattern list.
+ */
+TEST(TimingListenerTest, AnnotationWinsOverPatterns)
+{
+    TEST_TIME_BUDGET_MS(60000);
+
+    TimingListener listener(nullptr, "*=1");
+    listener.OnTestStart(current_test());
+    usleep(5000);
+    listener.OnTestEnd(current_test());
+
+    ASSERT_EQ(1u, listener.timings().size());
+    EXPECT_EQ(60000000, listener.timings()[0].budget_us);
+    EXPECT_FALSE(listener.timings()[0].over_budget);
+}
+
+class TimingListenerParamTest : public ::testing::TestWithParam<int>
+{
+};
+
+/**
+ * @test Verifies the JSON file: one entry per parameter instance, with
+ *       the printed parameter, the times and the total.
+ */
+TEST_P(TimingListenerParamTest, WritesJson)
+{
+    char path[] = "/tmp/timing_listener_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    {
+        TimingListener listener(path, "*=60000");
+        for (int i = 0; i < 2; i++) {
+            listener.OnTestStart(current_test());
+            listener.OnTestEnd(current_test());
+        }
+        listener.OnTestProgramEnd(*::testing::UnitTest::GetInstance());
+    }
+
+    FILE *f = fopen(path, "r");
+    ASSERT_NE(nullptr, f);
+    std::string json;
+    char buffer[256];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        json.append(buffer, n);
+    }
+    fclose(f);
+    unlink(path);
+
+    EXPECT_NE(std::string::npos, json.find("\"suite\": \"Budgets/TimingListenerParamTest\""));
+    EXPECT_NE(std::string::npos, json.find("\"name\": \"WritesJson/0\", \"param\": \"42\""));
+    EXPECT_NE(std::string::npos, json.find("\"result\": \"passed\""));
+    EXPECT_NE(std::string::npos, json.find("\"cpu_us\": "));
+    EXPECT_NE(std::string::npos, json.find("\"budget_us\": 60000000, \"over_budget\": false"));
+    EXPECT_NE(std::string::npos, json.find("\"total\": {\"tests\": 2, "));
+}
+
+INSTANTIATE_TEST_SUITE_P(Budgets, TimingListenerParamTest, ::testing::Values(42));
@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "atomic_led_sink.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+#include "trace_replay.hpp"
+
+// -------------------------------------------------------------------
+// MappedTrace, MappedResults and TraceReplay
+// -------------------------------------------------------------------
+// Each test gets its own files in a temporary directory.
+
+class TraceReplayTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char dir[] = "/tmp/trace_replay_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir));
+        dir_ = dir;
+    }
+
+    void TearDown() override
+    {
+        for (const std::string &file : files_) {
+            unlink(file.c_str());
+        }
+        rmdir(dir_.c_str());
+    }
+
+    std::string path(const char *name)
+    {
+        files_.push_back(dir_ + "/" + name);
+        return files_.back();
+    }
+
+    // Writes a file with any header, so broken ones can be made too
+    void write_file(const std::string &file, const TraceHeader &header, const void *records, size_t size)
+    {
+        FILE *f = fopen(file.c_str(), "wb");
+        ASSERT_NE(nullptr, f);
+        fwrite(&header, sizeof(header), 1, f);
+        if (size != 0) {
+            fwrite(records, 1, size, f);
+        }
+        fclose(f);
+    }
+
+    std::string write_trace(const char *name, const std::vector<BatchPair> &pairs)
+    {
+        std::string file = path(name);
+        TraceHeader header = {};
+        memcpy(header.magic, TraceHeader::TRACE_MAGIC, sizeof(header.magic));
+        header.version = TraceHeader::VERSION;
+        header.record_size = sizeof(BatchPair);
+        header.count = pairs.size();
+        write_file(file, header, pairs.data(), pairs.size() * sizeof(BatchPair));
+        return file;
+    }
+
+    std::string dir_;
+    std::vector<std::string> files_;
+};
+
+/**
+ * @test Verifies that a trace maps with its records in place.
+ */
+TEST_F(TraceReplayTest, OpensATrace)
+{
+    std::string file = write_trace("trace.bin", {{1, 2}, {3, 4}, {-5, 60}});
+
+    MappedTrace trace;
+    ASSERT_EQ(ESP_OK, trace.open(file.c_str()));
+    ASSERT_EQ(3u, trace.count());
+    EXPECT_EQ(3, trace.records()[1].a);
+    EXPECT_EQ(60, trace.records()[2].b);
+
+    trace.close();
+    EXPECT_EQ(0u, trace.count());
+    EXPECT_EQ(nullptr, trace.records());
+}
+
+/**
+ * @test Verifies that every way a file can fail to be a trace has its own
+ *       error, and leaves the trace empty.
+ */
+TEST_F(TraceReplayTest, RejectsBrokenTraces)
+{
+    MappedTrace trace;
+    EXPECT_EQ(ESP_ERR_NOT_FOUND, trace.open(path("missing.bin").c_str()));
+
+    TraceHeader header = {};
+    memcpy(header.magic, TraceHeader::TRACE_MAGIC, sizeof(header.magic));
+    header.version = TraceHeader::VERSION;
+    header.record_size = sizeof(BatchPair);
+    header.count = 2;
+    const BatchPair pairs[2] = {{1, 1}, {2, 2}};
+
+    std::string file = path("broken.bin");
+    write_file(file, header, pairs, sizeof(BatchPair)); // One record short
+    EXPECT_EQ(ESP_ERR_INVALID_SIZE, trace.open(file.c_str()));
+
+    TraceHeader wrong = header;
+    wrong.version = TraceHeader::VERSION + 1;
+    write_file(file, wrong, pairs, sizeof(pairs));
+    EXPECT_EQ(ESP_ERR_INVALID_VERSION, trace.open(file.c_str()));
+
+    wrong = header;
+    memcpy(wrong.magic, TraceHeader::RESULTS_MAGIC, sizeof(wrong.magic));
+    write_file(file, wrong, pairs, sizeof(pairs));
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, trace.open(file.c_str()));
+
+    wrong = header;
+    wrong.record_size = 4;
+    write_file(file, wrong, pairs, sizeof(pairs));
+    EXPECT_EQ(ESP_ERR_INVALID_SIZE, trace.open(file.c_str()));
+
+    EXPECT_EQ(0u, trace.count());
+}
+
+/**
+ * @test Verifies that a replay gives, for every record, what Sum gives,
+ *       and that the error classes add up. Both paths agree.
+ */
+TEST_F(TraceReplayTest, ReplayMatchesSum)
+{
+    std::vector<BatchPair> pairs;
+    for (int a = -2; a <= 12; a++) {
+        for (int b = -2; b <= 12; b++) {
+            pairs.push_back({a, b});
+        }
+    }
+
+    Sum sum;
+    AtomicLedSink leds;
+    SumBoss boss(sum, leds);
+    for (TraceReplay::Path path : {TraceReplay::COMPUTE, TraceReplay::COMPUTE_ISR}) {
+        std::vector<BatchReply> out(pairs.size());
+        ReplayReport report;
+        TraceReplay(boss, path).run(pairs.data(), pairs.size(), out.data(), report);
+
+        uint64_t expected_ok = 0;
+        for (size_t i = 0; i < pairs.size(); i++) {
+            int expected;
+            esp_err_t err = sum.add_constrained_err_isr(pairs[i].a, pairs[i].b, expected);
+            EXPECT_EQ(err, out[i].err) << pairs[i].a << " + " << pairs[i].b;
+            EXPECT_EQ(expected, out[i].result) << pairs[i].a << " + " << pairs[i].b;
+            expected_ok += (err == ESP_OK);
+        }
+
+        EXPECT_EQ(pairs.size(), report.records);
+        EXPECT_EQ(66u, expected_ok); // Pairs from 0 to 10 whose sum is at most 10
+        EXPECT_EQ(expected_ok, report.successes);
+        EXPECT_EQ(report.records,
+                  report.successes + report.out_of_range + report.invalid_args + report.other_errors);
+        EXPECT_EQ(0u, report.other_errors);
+        EXPECT_GT(report.seconds, 0.0);
+    }
+}
+
+/**
+ * @test Verifies the whole file path: a trace replayed into a results
+ *       file, read back from disk after close(), matches the replay.
+ */
+TEST_F(TraceReplayTest, ResultsFileRoundTrip)
+{
+    const size_t COUNT = 100000; // Several pages, and not a whole number of them
+    std::vector<BatchPair> pairs(COUNT);
+    for (size_t i = 0; i < COUNT; i++) {
+        pairs[i] = {static_cast<int32_t>(i % 13), static_cast<int32_t>(i % 7)};
+    }
+    std::string trace_file = write_trace("trace.bin", pairs);
+    std::string results_file = path("results.bin");
+
+    MappedTrace trace;
+    ASSERT_EQ(ESP_OK, trace.open(trace_file.c_str()));
+    MappedResults results;
+    ASSERT_EQ(ESP_OK, results.create(results_file.c_str(), trace.count()));
+
+    Sum sum;
+    AtomicLedSink leds;
+    SumBoss boss(sum, leds);
+    ReplayReport report;
+    TraceReplay(boss, TraceReplay::COMPUTE_ISR).run(trace.records(), trace.count(), results.records(), report);
+    ASSERT_EQ(ESP_OK, results.close());
+
+    FILE *f = fopen(results_file.c_str(), "rb");
+    ASSERT_NE(nullptr, f);
+    TraceHeader header;
+    ASSERT_EQ(1u, fread(&header, sizeof(header), 1, f));
+    EXPECT_EQ(0, memcmp(header.magic, TraceHeader::RESULTS_MAGIC, sizeof(header.magic)));
+    EXPECT_EQ(TraceHeader::VERSION, header.version);
+    EXPECT_EQ(sizeof(BatchReply), header.record_size);
+    ASSERT_EQ(COUNT, header.count);
+
+    std::vector<BatchReply> replies(COUNT);
+    ASSERT_EQ(COUNT, fread(replies.data(), sizeof(BatchReply), COUNT, f));
+    fclose(f);
+
+    uint64_t ok = 0;
+    for (size_t i = 0; i < COUNT; i++) {
+        int expected;
+        ASSERT_EQ(sum.add_constrained_err_isr(pairs[i].a, pairs[i].b, expected), replies[i].err) << "record " << i;
+        ASSERT_EQ(expected, replies[i].result) << "record " << i;
+        ok += (replies[i].err == ESP_OK);
+    }
+    EXPECT_EQ(report.successes, ok);
+}
@@ -0,0 +1,272 @@
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "atomic_led_sink.hpp"
+#include "chase_lev_deque.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+#include "work_stealing_executor.hpp"
+
+// -------------------------------------------------------------------
+// ChaseLevDeque
+// -------------------------------------------------------------------
+
+using SmallDeque = ChaseLevDeque<size_t, 8>;
+using TinyDeque = ChaseLevDeque<size_t, 4>;
+
+/**
+ * @test Verifies that the owner pops newest first and thieves steal
+ *       oldest first.
+ */
+TEST(ChaseLevDequeTest, OwnerIsLifoThiefIsFifo)
+{
+    SmallDeque deque;
+    for (size_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(deque.push(i));
+    }
+
+    size_t item = 0;
+    EXPECT_TRUE(deque.pop(item));
+    EXPECT_EQ(3u, item);
+    EXPECT_EQ(SmallDeque::Steal::Success, deque.steal(item));
+    EXPECT_EQ(0u, item);
+    EXPECT_EQ(2u, deque.size());
+}
+
+/**
+ * @test Verifies that push() fails on a full deque instead of overwriting,
+ *       and that an empty deque reports Empty to both ends.
+ */
+TEST(ChaseLevDequeTest, FullAndEmpty)
+{
+    TinyDeque deque;
+    for (size_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(deque.push(i));
+    }
+    EXPECT_FALSE(deque.push(4));
+
+    size_t item = 0;
+    for (size_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(deque.pop(item));
+    }
+    EXPECT_FALSE(deque.pop(item));
+    EXPECT_EQ(TinyDeque::Steal::Empty, deque.steal(item));
+}
+
+/**
+ * @test Verifies that with the owner popping and three thieves stealing
+ *       at the same time, every item is taken exactly once.
+ */
+TEST(ChaseLevDequeTest, ConcurrentStealTakesEachItemOnce)
+{
+    const size_t ITEMS = 1024;
+    ChaseLevDeque<size_t, ITEMS> deque;
+    for (size_t i = 0; i < ITEMS; i++) {
+        ASSERT_TRUE(deque.push(i));
+    }
+
+    std::vector<std::atomic<int>> taken(ITEMS);
+    for (auto &t : taken) {
+        t = 0;
+    }
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; t++) {
+        thieves.emplace_back([&] {
+            size_t item;
+            while (true) {
+                auto result = deque.steal(item);
+                if (result == ChaseLevDeque<size_t, ITEMS>::Steal::Empty) {
+                    return;
+                }
+                if (result == ChaseLevDeque<size_t, ITEMS>::Steal::Success) {
+                    taken[item]++;
+                }
+            }
+        });
+    }
+
+    size_t item;
+    while (deque.pop(item)) {
+        taken[item]++;
+    }
+    for (auto &thief : thieves) {
+        thief.join();
+    }
+    // pop() may fail on a lost race for the last item: a thief has it then
+    while (deque.pop(item)) {
+        taken[item]++;
+    }
+
+    for (size_t i = 0; i < ITEMS; i++) {
+        EXPECT_EQ(1, taken[i].load()) << "item " << i;
+    }
+}
+
+// -------------------------------------------------------------------
+// WorkStealingExecutor
+// -------------------------------------------------------------------
+
+struct CountingBatch
+{
+    std::vector<std::atomic<int>> runs;
+    explicit CountingBatch(size_t count)
+        : runs(count)
+    {
+        for (auto &r : runs) {
+            r = 0;
+        }
+    }
+    static void job(void *ctx, size_t index) { static_cast<CountingBatch *>(ctx)->runs[index]++; }
+};
+
+/**
+ * @test Verifies that every index runs exactly once, including batches
+ *       bigger than all the deques together (several rounds).
+ */
+TEST(WorkStealingExecutorTest, RunsEveryJobOnce)
+{
+    WorkStealingExecutor executor(4);
+    const size_t sizes[] = {0, 1, 7, 4 * WorkStealingExecutor::DEQUE_CAPACITY + 3};
+
+    for (size_t count : sizes) {
+        CountingBatch batch(count);
+        EXPECT_EQ(ESP_OK, executor.run(CountingBatch::job, &batch, count));
+        for (size_t i = 0; i < count; i++) {
+            ASSERT_EQ(1, batch.runs[i].load()) << "count " << count << ", index " << i;
+        }
+    }
+}
+
+/**
+ * @test Verifies that jobs all dealt to worker 0 are stolen by the idle
+ *       workers: more than one thread runs them and steals() counts it.
+ */
+TEST(WorkStealingExecutorTest, IdleWorkersSteal)
+{
+    WorkStealingExecutor executor(4);
+    const size_t COUNT = 200;
+
+    struct Batch
+    {
+        std::mutex mutex;
+        std::set<std::thread::id> threads;
+    } batch;
+
+    EXPECT_EQ(
+        ESP_OK,
+        executor.run(
+            [](void *ctx, size_t) {
+                Batch *batch = static_cast<Batch *>(ctx);
+                {
+                    std::lock_guard<std::mutex> lock(batch->mutex);
+                    batch->threads.insert(std::this_thread::get_id());
+                }
+                // Slow enough for the others to wake up and find work
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            },
+            &batch,
+            COUNT,
+            WorkStealingExecutor::Placement::FirstWorker));
+
+    EXPECT_GT(batch.threads.size(), 1u);
+    EXPECT_GT(executor.steals(), 0u);
+}
+
+/**
+ * @test Verifies that a throwing job doesn't stop the batch: every other
+ *       job still runs, run() rethrows the first exception, and the pool
+ *       takes the next batch.
+ */
+TEST(WorkStealingExecutorTest, ExceptionIsRethrownAfterBatch)
+{
+    WorkStealingExecutor executor(4);
+    const size_t COUNT = 1000;
+    CountingBatch batch(COUNT);
+
+    EXPECT_THROW(
+        executor.run(
+            [](void *ctx, size_t index) {
+                CountingBatch::job(ctx, index);
+                if (index % 100 == 7) {
+                    throw std::runtime_error("job failed");
+                }
+            },
+            &batch,
+            COUNT),
+        std::runtime_error);
+
+    for (size_t i = 0; i < COUNT; i++) {
+        ASSERT_EQ(1, batch.runs[i].load()) << "index " << i;
+    }
+
+    CountingBatch next(COUNT);
+    EXPECT_EQ(ESP_OK, executor.run(CountingBatch::job, &next, COUNT));
+    EXPECT_EQ(1, next.runs[COUNT - 1].load());
+}
+
+/**
+ * @test Verifies that shutdown() joins the workers, can be called twice,
+ *       and makes run() fail without running anything.
+ */
+TEST(WorkStealingExecutorTest, RunAfterShutdownFails)
+{
+    WorkStealingExecutor executor(2);
+    CountingBatch batch(10);
+
+    executor.shutdown();
+    executor.shutdown();
+
+    EXPECT_EQ(ESP_ERR_INVALID_STATE, executor.run(CountingBatch::job, &batch, 10));
+    EXPECT_EQ(0, batch.runs[0].load());
+}
+
+/**
+ * @test Verifies that a null job is rejected.
+ */
+TEST(WorkStealingExecutorTest, NullJobIsInvalid)
+{
+    WorkStealingExecutor executor(2);
+
+    EXPECT_EQ(ESP_ERR_INVALID_ARG, executor.run(nullptr, nullptr, 10));
+}
+
+/**
+ * @test Verifies that a batch of SumBoss::compute jobs gets the same
+ *       results as calling it serially, and that the LED sink saw one
+ *       call per job.
+ */
+TEST(WorkStealingExecutorTest, ComputeBatchMatchesSerial)
+{
+    WorkStealingExecutor executor(4);
+    Sum sum;
+    AtomicLedSink leds;
+    SumBoss boss(sum, leds);
+
+    std::vector<ComputeJob> jobs;
+    uint32_t valid = 0;
+    for (int a = -1; a <= 11; a++) {
+        for (int b = -1; b <= 11; b++) {
+            jobs.push_back({a, b, 0, ESP_OK});
+            if (a >= 0 && b >= 0 && a + b <= 10) {
+                valid++;
+            }
+        }
+    }
+
+    EXPECT_EQ(ESP_OK, executor.compute(boss, jobs.data(), jobs.size()));
+
+    for (const ComputeJob &job : jobs) {
+        int expected = 0;
+        EXPECT_EQ(sum.add_constrained_err(job.a, job.b, expected), job.err);
+        EXPECT_EQ(expected, job.result);
+    }
+    EXPECT_EQ(valid, leds.greens());
+    EXPECT_EQ(jobs.size() - valid, leds.reds());
+}
@@ -0,0 +1,184 @@
+#include "timing_listener.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+TimingListener::TimingListener(const char *json_path, const char *budgets)
+    : json_path_(json_path != nullptr ? json_path : "")
+    , wall_start_us_(0)
+    , cpu_start_us_(0)
+{
+    // "pattern=ms:pattern=ms", malformed entries are ignored
+    std::string list = budgets != nullptr ? budgets : "";
+    size_t start = 0;
+    while (start < list.size()) {
+        size_t end = list.find(':', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        std::string entry = list.substr(start, end - start);
+        size_t equals = entry.rfind('=');
+        if (equals != std::string::npos && equals > 0) {
+            char *rest;
+            long long ms = strtoll(entry.c_str() + equals + 1, &rest, 10);
+            if (*rest == '\0' && rest != entry.c_str() + equals + 1 && ms >= 0) {
+                budgets_.push_back({entry.substr(0, equals), static_cast<int64_t>(ms) * 1000});
+            }
+        }
+        start = end + 1;
+    }
+}
+
+int64_t TimingListener::wall_now_us()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+int64_t TimingListener::cpu_now_us()
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+bool TimingListener::matches(const char *pattern, const char *name)
+{
+    // Iterative glob match, backtracking to the last '*' on a mismatch
+    const char *star = nullptr;
+    const char *resume = nullptr;
+    while (*name != '\0') {
+        if (*pattern == '?' || *pattern == *name) {
+            pattern++;
+            name++;
+        }
+        else if (*pattern == '*') {
+            star = pattern++;
+            resume = name;
+        }
+        else if (star != nullptr) {
+            pattern = star + 1;
+            name = ++resume;
+        }
+        else {
+            return false;
+        }
+    }
+    while (*pattern == '*') {
+        pattern++;
+    }
+    return *pattern == '\0';
+}
+
+int64_t TimingListener::pattern_budget_us(const std::string &full_name) const
+{
+    for (const Budget &budget : budgets_) {
+        if (matches(budget.pattern.c_str(), full_name.c_str())) {
+            return budget.budget_us;
+        }
+    }
+    return -1;
+}
+
+void TimingListener::OnTestStart(const ::testing::TestInfo &)
+{
+    wall_start_us_ = wall_now_us();
+    cpu_start_us_ = cpu_now_us();
+}
+
+void TimingListener::OnTestEnd(const ::testing::TestInfo &info)
+{
+    TestTiming timing;
+    timing.wall_us = wall_now_us() - wall_start_us_;
+    timing.cpu_us = cpu_now_us() - cpu_start_us_;
+    timing.suite = info.test_suite_name();
+    timing.name = info.name();
+    timing.param = info.value_param() != nullptr ? info.value_param() : "";
+
+    // The test's own budget wins over the pattern list
+    timing.budget_us = pattern_budget_us(timing.suite + "." + timing.name);
+    const ::testing::TestResult &result = *info.result();
+    for (int i = 0; i < result.test_property_count(); i++) {
+        const ::testing::TestProperty &property = result.GetTestProperty(i);
+        if (std::string(property.key()) == BUDGET_PROPERTY) {
+            timing.budget_us = strtoll(property.value(), nullptr, 10) * 1000;
+        }
+    }
+
+    timing.skipped = result.Skipped();
+    timing.over_budget = !timing.skipped && timing.budget_us >= 0 && timing.wall_us > timing.budget_us;
+    if (timing.over_budget) {
+        // End events reach the listeners in reverse order, so this runs
+        // before the default printer reports the test
+        char message[96];
+        snprintf(message, sizeof(message), "Test took %.3f ms, over its time budget of %.3f ms",
+                 timing.wall_us / 1000.0, timing.budget_us / 1000.0);
+        ADD_FAILURE_AT(info.file(), info.line()) << message;
+    }
+    timing.passed = result.Passed();
+    timings_.push_back(timing);
+}
+
+void TimingListener::OnTestProgramEnd(const ::testing::UnitTest &)
+{
+    if (!json_path_.empty() && !write_json()) {
+        fprintf(stderr, "TimingListener: can't write %s\n", json_path_.c_str());
+    }
+}
+
+static void write_json_string(FILE *f, const std::string &s)
+{
+    fputc('"', f);
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') {
+            fprintf(f, "\\%c", c);
+        }
+        else if (c < 0x20) {
+            fprintf(f, "\\u%04x", c);
+        }
+        else {
+            fputc(c, f);
+        }
+    }
+    fputc('"', f);
+}
+
+bool TimingListener::write_json() const
+{
+    FILE *f = fopen(json_path_.c_str(), "w");
+    if (f == nullptr) {
+        return false;
+    }
+
+    int64_t wall_us = 0;
+    int64_t cpu_us = 0;
+    int over_budget = 0;
+    fprintf(f, "{\n  \"tests\": [");
+    for (size_t i = 0; i < timings_.size(); i++) {
+        const TestTiming &t = timings_[i];
+        fprintf(f, "%s\n    {\"suite\": ", i == 0 ? "" : ",");
+        write_json_string(f, t.suite);
+        fprintf(f, ", \"name\": ");
+        write_json_string(f, t.name);
+        if (!t.param.empty()) {
+            fprintf(f, ", \"param\": ");
+            write_json_string(f, t.param);
+        }
+        fprintf(f, ", \"result\": \"%s\", \"wall_us\": %lld, \"cpu_us\": %lld",
+                t.skipped ? "skipped" : (t.passed ? "passed" : "failed"), static_cast<long long>(t.wall_us),
+                static_cast<long long>(t.cpu_us));
+        if (t.budget_us >= 0) {
+            fprintf(f, ", \"budget_us\": %lld, \"over_budget\": %s", static_cast<long long>(t.budget_us),
+                    t.over_budget ? "true" : "false");
+        }
+        fprintf(f, "}");
+        wall_us += t.wall_us;
+        cpu_us += t.cpu_us;
+        over_budget += t.over_budget;
+    }
+    fprintf(f, "\n  ],\n  \"total\": {\"tests\": %zu, \"wall_us\": %lld, \"cpu_us\": %lld, \"over_budget\": %d}\n}\n",
+            timings_.size(), static_cast<long long>(wall_us), static_cast<long long>(cpu_us), over_budget);
+    return fclose(f) == 0;
+}
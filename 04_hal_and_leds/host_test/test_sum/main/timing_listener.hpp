@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// -------------------------------------------------------------------
+// Per-test timing and time budgets
+// TimingListener times every test, and every instance of a
+// parameterized one, in wall time and in process CPU time (all threads,
+// so ParallelSum's workers count). A test that takes longer than its
+// budget, in wall time, fails.
+//
+// A budget comes from the test itself, with TEST_TIME_BUDGET_MS(ms) in
+// its body, or else from a list of full-name patterns, the same syntax
+// as --gtest_filter, each with a budget in ms; the first match wins:
+//
+//     TEST_TIME_BUDGETS='ParallelSumTest.*=2000:*=500'
+//
+// With a JSON path, the timings are written there when the run ends.
+// -------------------------------------------------------------------
+
+// Sets the wall-time budget of the running test, in ms
+#define TEST_TIME_BUDGET_MS(ms) ::testing::Test::RecordProperty(TimingListener::BUDGET_PROPERTY, (ms))
+
+struct TestTiming
+{
+    std::string suite;
+    std::string name;
+    std::string param;  // Printed value of a parameterized test, or empty
+    int64_t wall_us;
+    int64_t cpu_us;
+    int64_t budget_us;  // -1 without a budget
+    bool passed;
+    bool skipped;
+    bool over_budget;
+};
+
+class TimingListener : public ::testing::EmptyTestEventListener
+{
+public:
+    static constexpr const char *BUDGET_PROPERTY = "time_budget_ms";
+
+    // Both may be nullptr: no JSON file, no budgets besides the annotations
+    TimingListener(const char *json_path, const char *budgets);
+
+    void OnTestStart(const ::testing::TestInfo &info) override;
+    void OnTestEnd(const ::testing::TestInfo &info) override;
+    void OnTestProgramEnd(const ::testing::UnitTest &unit_test) override;
+
+    const std::vector<TestTiming> &timings() const { return timings_; }
+
+    // Budget of a test from the pattern list alone, -1 if none matches
+    int64_t pattern_budget_us(const std::string &full_name) const;
+
+    // '*' matches any run of characters, '?' any one character
+    static bool matches(const char *pattern, const char *name);
+
+private:
+    struct Budget
+    {
+        std::string pattern;
+        int64_t budget_us;
+    };
+
+    static int64_t wall_now_us();
+    static int64_t cpu_now_us();
+    bool write_json() const;
+
+    std::string json_path_;
+    std::vector<Budget> budgets_;
+    std::vector<TestTiming> timings_;
+    int64_t wall_start_us_;
+    int64_t cpu_start_us_;
+};
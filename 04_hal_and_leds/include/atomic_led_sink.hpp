@@ -0,0 +1,57 @@
+// atomic_led_sink.hpp
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include "i_led_sargent.hpp"
+
+/**
+ * @brief Thread-safe ILedSargent that counts LED calls instead of driving pins.
+ *
+ * Used as the LED side of SumBoss when many threads compute at once, on
+ * the host. Every call is one atomic increment, so it never serializes
+ * the workers.
+ */
+class AtomicLedSink : public ILedSargent
+{
+public:
+    enum State
+    {
+        OFF,
+        GREEN,
+        RED,
+    };
+
+    AtomicLedSink() = default;
+
+    esp_err_t green() override
+    {
+        greens_.fetch_add(1, std::memory_order_relaxed);
+        state_.store(GREEN, std::memory_order_relaxed);
+        return ESP_OK;
+    }
+    esp_err_t red() override
+    {
+        reds_.fetch_add(1, std::memory_order_relaxed);
+        state_.store(RED, std::memory_order_relaxed);
+        return ESP_OK;
+    }
+    esp_err_t off() override
+    {
+        offs_.fetch_add(1, std::memory_order_relaxed);
+        state_.store(OFF, std::memory_order_relaxed);
+        return ESP_OK;
+    }
+
+    uint32_t greens() const { return greens_.load(std::memory_order_relaxed); }
+    uint32_t reds() const { return reds_.load(std::memory_order_relaxed); }
+    uint32_t offs() const { return offs_.load(std::memory_order_relaxed); }
+    State state() const { return state_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> greens_{0};
+    std::atomic<uint32_t> reds_{0};
+    std::atomic<uint32_t> offs_{0};
+    std::atomic<State> state_{OFF};
+};
@@ -0,0 +1,169 @@
+// batch_protocol.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// One record of a request
+struct BatchPair
+{
+    int32_t a;
+    int32_t b;
+};
+
+// One record of a reply
+struct BatchReply
+{
+    int32_t result;
+    int32_t err; // esp_err_t
+};
+
+/**
+ * @brief Framed binary batches of SumBoss work, for a UART or a pipe.
+ *
+ * Every frame is little-endian, as both the chips and the usual hosts are:
+ *
+ *     offset  size        field
+ *     0       2           magic, 'S' 'B'
+ *     2       1           type, REQUEST or REPLY
+ *     3       1           seq, copied from the request to its reply
+ *     4       2           count, 0..MAX_BATCH records
+ *     6       2           reserved, 0
+ *     8       8 * count   records: (a, b) in a request, (result, err) in a reply
+ *     8 + 8n  4           CRC-32 (esp_rom_crc32_le) of everything before it
+ *
+ * A byte stream has no frame boundaries, so the receiver looks for the
+ * magic, checks the header, and only accepts a frame whose CRC matches.
+ * Anything else is skipped one byte at a time until the next magic.
+ */
+struct BatchProtocol
+{
+    static constexpr uint8_t MAGIC_0 = 'S';
+    static constexpr uint8_t MAGIC_1 = 'B';
+    static constexpr uint8_t REQUEST = 1;
+    static constexpr uint8_t REPLY = 2;
+
+    static constexpr size_t HEADER_SIZE = 8;
+    static constexpr size_t RECORD_SIZE = 8;
+    static constexpr size_t CRC_SIZE = 4;
+    static constexpr size_t MAX_BATCH = 256;
+    static constexpr size_t MAX_FRAME_SIZE = HEADER_SIZE + MAX_BATCH * RECORD_SIZE + CRC_SIZE;
+
+    static constexpr size_t frame_size(size_t count) { return HEADER_SIZE + count * RECORD_SIZE + CRC_SIZE; }
+
+    // Write a frame into out, which must hold frame_size(count) bytes.
+    // Return its size, or 0 if count is over MAX_BATCH.
+    static size_t encode_request(uint8_t seq, const BatchPair *pairs, size_t count, uint8_t *out);
+    static size_t encode_reply(uint8_t seq, const BatchReply *replies, size_t count, uint8_t *out);
+
+    // Like the encoders, for records already written in place at
+    // frame + HEADER_SIZE: adds the header and the CRC around them.
+    static size_t seal(uint8_t type, uint8_t seq, size_t count, uint8_t *frame);
+};
+
+/**
+ * @brief Fixed-size byte ring between a stream and BatchParser.
+ *
+ * The stream reads straight into free_span(), and the parser reads frames
+ * where they landed, across the wrap if needed. Bytes are copied once,
+ * from the driver into the ring, and never assembled into a frame buffer.
+ * Single-threaded: one task both fills and drains it.
+ */
+class ByteRing
+{
+public:
+    static constexpr size_t SIZE = 4096; // Power of two, holds at least one MAX_FRAME_SIZE frame
+
+    ByteRing()
+        : head_(0)
+        , tail_(0)
+    {
+    }
+
+    size_t size() const { return head_ - tail_; }
+    size_t space() const { return SIZE - size(); }
+
+    // The largest contiguous free region, for the stream to read into.
+    // Fill some of it, then call produce() with how much.
+    uint8_t *free_span(size_t &length)
+    {
+        size_t offset = head_ % SIZE;
+        size_t to_end = SIZE - offset;
+        length = space() < to_end ? space() : to_end;
+        return &data_[offset];
+    }
+    void produce(size_t length) { head_ += length; }
+
+    // Copies in, for callers that already have the bytes. Returns how many fit.
+    size_t write(const uint8_t *data, size_t length);
+
+    // Bytes from offset on, counted from the oldest byte
+    uint8_t at(size_t offset) const { return data_[(tail_ + offset) % SIZE]; }
+    void copy_out(size_t offset, void *out, size_t length) const;
+
+    // CRC-32 of length bytes from offset, read in place
+    uint32_t crc32(size_t offset, size_t length) const;
+
+    void consume(size_t length) { tail_ += length; }
+    void clear() { tail_ = head_; }
+
+private:
+    uint8_t data_[SIZE];
+    size_t head_; // Free-running, wraps with size_t
+    size_t tail_;
+};
+
+/**
+ * @brief A frame that BatchParser found in a ByteRing, read in place.
+ *
+ * Valid until the ring is consumed past it.
+ */
+struct BatchFrame
+{
+    uint8_t type;
+    uint8_t seq;
+    uint16_t count;
+    const ByteRing *ring;
+
+    BatchPair pair(size_t i) const
+    {
+        BatchPair pair;
+        ring->copy_out(BatchProtocol::HEADER_SIZE + i * BatchProtocol::RECORD_SIZE, &pair, sizeof(pair));
+        return pair;
+    }
+    BatchReply reply(size_t i) const
+    {
+        BatchReply reply;
+        ring->copy_out(BatchProtocol::HEADER_SIZE + i * BatchProtocol::RECORD_SIZE, &reply, sizeof(reply));
+        return reply;
+    }
+    size_t size() const { return BatchProtocol::frame_size(count); }
+};
+
+/**
+ * @brief Finds frames in a ByteRing.
+ */
+class BatchParser
+{
+public:
+    BatchParser()
+        : skipped_(0)
+        , bad_crc_(0)
+    {
+    }
+
+    // Drops whatever can't start a frame, then returns true if a whole,
+    // valid frame sits at the start of the ring. The caller reads it and
+    // then calls ring.consume(frame.size()). false means more bytes are
+    // needed.
+    bool next(ByteRing &ring, BatchFrame &frame);
+
+    // Bytes dropped while looking for a frame, bad CRCs included
+    uint32_t skipped() const { return skipped_; }
+    // Frames with a good header and a bad CRC
+    uint32_t bad_crc() const { return bad_crc_; }
+
+private:
+    uint32_t skipped_;
+    uint32_t bad_crc_;
+};
@@ -0,0 +1,56 @@
+// batch_server.hpp
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#include "batch_protocol.hpp"
+#include "i_byte_stream.hpp"
+#include "sum_boss.hpp"
+
+/**
+ * @brief Feeds SumBoss from batches that arrive on a byte stream.
+ *
+ * Each REQUEST frame is answered with one REPLY frame carrying the same
+ * seq and one (result, err) per pair, in order. The stream is read
+ * straight into a ByteRing and the pairs are read where they landed; the
+ * replies are written in place inside the outgoing frame. Nothing is
+ * allocated, and the only copies are the driver's.
+ *
+ * SumBoss::compute logs every failed sum. When the stream is the console
+ * (UART0, or stdout on the linux target), turn logging off first, or the
+ * log lines end up in the middle of the replies.
+ */
+class BatchServer
+{
+public:
+    BatchServer(IByteStream &stream, SumBoss &boss);
+
+    BatchServer(const BatchServer &) = delete;
+    BatchServer &operator=(const BatchServer &) = delete;
+
+    // Waits up to timeout_ms for bytes, then answers every complete request
+    // in the ring. Returns ESP_OK if bytes arrived, ESP_ERR_TIMEOUT if none
+    // did, ESP_ERR_INVALID_STATE once the stream is closed, or ESP_FAIL if
+    // a reply couldn't be written.
+    esp_err_t poll(uint32_t timeout_ms);
+
+    // Requests answered, and the pairs in them
+    uint32_t frames() const { return frames_; }
+    uint64_t pairs() const { return pairs_; }
+
+    // Skipped bytes and bad CRCs
+    const BatchParser &parser() const { return parser_; }
+
+private:
+    esp_err_t answer(const BatchFrame &request);
+
+    IByteStream &stream_;
+    SumBoss &boss_;
+    ByteRing ring_;
+    BatchParser parser_;
+    alignas(4) uint8_t tx_[BatchProtocol::MAX_FRAME_SIZE];
+    uint32_t frames_;
+    uint64_t pairs_;
+};
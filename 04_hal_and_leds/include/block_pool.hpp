@@ -0,0 +1,189 @@
+// block_pool.hpp
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <sched.h>
+#else
+#include "freertos/FreeRTOS.h"
+#endif
+
+/**
+ * @brief Lock-free pool of CAPACITY fixed-size blocks for objects of type T.
+ *
+ * The blocks live inside the pool object, so a pool declared static never
+ * touches the heap. Free blocks are kept on lock-free stacks (Treiber
+ * stacks): allocate() and deallocate() are one compare-and-swap each in
+ * the common case, never block, and are safe from any task or ISR.
+ *
+ * With CACHES > 1, there is one free stack per core (CACHES is usually
+ * portNUM_PROCESSORS). A core allocates from its own stack and frees into
+ * it, so the two cores don't fight over the same cache line. When its
+ * stack is empty, it takes a block from another core's. A task that
+ * migrates mid-call only costs that locality, not correctness.
+ *
+ * Each stack head packs a 16-bit block index with a 16-bit tag that
+ * changes on every update, so a head that was popped and pushed back
+ * between a load and a CAS (the ABA problem) isn't mistaken for the
+ * same one. The whole head is 32 bits, so it is one native CAS where the
+ * CPU has atomic instructions: Xtensa (S32C1I) and RISC-V with the A
+ * extension (C6, H2, P4...). ESP32-C2 and C3 have no A extension. There
+ * the compiler calls __atomic_compare_exchange_4, which ESP-IDF implements
+ * with a short critical section. The pool is then no longer lock-free:
+ * every call briefly masks interrupts instead. It still never sleeps, so
+ * it stays safe from an ISR, but the one-CAS figures above don't hold.
+ */
+template <typename T, size_t CAPACITY, size_t CACHES = 1>
+class BlockPool
+{
+    static_assert(CAPACITY > 0 && CAPACITY < 0xFFFF, "CAPACITY must fit a 16-bit index");
+    static_assert(CACHES > 0, "CACHES must be at least 1");
+
+public:
+    BlockPool()
+    {
+        for (size_t c = 0; c < CACHES; c++) {
+            caches_[c].head.store(NIL, std::memory_order_relaxed);
+        }
+        // Deal the blocks round-robin, block 0 ends up on top of cache 0
+        for (size_t i = CAPACITY; i-- > 0;) {
+            push(caches_[i % CACHES], static_cast<uint16_t>(i));
+        }
+    }
+
+    BlockPool(const BlockPool &) = delete;
+    BlockPool &operator=(const BlockPool &) = delete;
+
+    // Returns an uninitialized block big enough for a T, or nullptr if the pool is exhausted
+    void *allocate()
+    {
+        size_t home = cache_index();
+        for (size_t k = 0; k < CACHES; k++) {
+            uint16_t index = pop(caches_[(home + k) % CACHES]);
+            if (index != NIL_INDEX) {
+                return blocks_[index].bytes;
+            }
+        }
+        return nullptr;
+    }
+
+    // nullptr is accepted and ignored, like free()
+    esp_err_t deallocate(void *block)
+    {
+        if (block == nullptr) {
+            return ESP_OK;
+        }
+        if (!owns(block)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        push(caches_[cache_index()], index_of(block));
+        return ESP_OK;
+    }
+
+    // allocate() + placement new. nullptr if the pool is exhausted.
+    template <typename... Args>
+    T *create(Args &&...args)
+    {
+        void *block = allocate();
+        if (block == nullptr) {
+            return nullptr;
+        }
+        return new (block) T(std::forward<Args>(args)...);
+    }
+
+    // ~T() + deallocate()
+    esp_err_t destroy(T *object)
+    {
+        if (object == nullptr) {
+            return ESP_OK;
+        }
+        if (!owns(object)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        object->~T();
+        return deallocate(object);
+    }
+
+    // True if block is the start of one of this pool's blocks
+    bool owns(const void *block) const
+    {
+        uintptr_t address = reinterpret_cast<uintptr_t>(block);
+        uintptr_t first = reinterpret_cast<uintptr_t>(&blocks_[0]);
+        uintptr_t end = reinterpret_cast<uintptr_t>(&blocks_[CAPACITY]);
+        return address >= first && address < end && (address - first) % sizeof(Block) == 0;
+    }
+
+    static constexpr size_t capacity() { return CAPACITY; }
+
+private:
+    static constexpr uint32_t NIL_INDEX = 0xFFFF;
+    static constexpr uint32_t NIL = NIL_INDEX; // Empty stack, tag 0
+
+    union Block
+    {
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    struct alignas(64) Cache
+    {
+        std::atomic<uint32_t> head; // tag << 16 | index of the top block
+    };
+
+    static size_t cache_index()
+    {
+        if (CACHES == 1) {
+            return 0;
+        }
+#if CONFIG_IDF_TARGET_LINUX
+        int cpu = sched_getcpu();
+        return cpu < 0 ? 0 : static_cast<size_t>(cpu) % CACHES;
+#else
+        return static_cast<size_t>(xPortGetCoreID()) % CACHES;
+#endif
+    }
+
+    uint16_t index_of(const void *block) const
+    {
+        uintptr_t offset = reinterpret_cast<uintptr_t>(block) - reinterpret_cast<uintptr_t>(&blocks_[0]);
+        return static_cast<uint16_t>(offset / sizeof(Block));
+    }
+
+    static uint32_t next_head(uint32_t old, uint32_t index) { return ((old + 0x10000u) & 0xFFFF0000u) | index; }
+
+    void push(Cache &cache, uint16_t index)
+    {
+        uint32_t old = cache.head.load(std::memory_order_relaxed);
+        do {
+            next_[index].store(static_cast<uint16_t>(old & 0xFFFF), std::memory_order_relaxed);
+        } while (!cache.head.compare_exchange_weak(
+            old, next_head(old, index), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    uint16_t pop(Cache &cache)
+    {
+        uint32_t old = cache.head.load(std::memory_order_acquire);
+        while ((old & 0xFFFF) != NIL_INDEX) {
+            uint16_t index = static_cast<uint16_t>(old & 0xFFFF);
+            // May be stale if another thread popped index meanwhile: the
+            // tag changed then, so the CAS below fails and we retry
+            uint16_t next = next_[index].load(std::memory_order_relaxed);
+            if (cache.head.compare_exchange_weak(
+                    old, next_head(old, next), std::memory_order_acquire, std::memory_order_acquire)) {
+                return index;
+            }
+        }
+        return NIL_INDEX;
+    }
+
+    Cache caches_[CACHES];
+    std::atomic<uint16_t> next_[CAPACITY];
+    Block blocks_[CAPACITY];
+};
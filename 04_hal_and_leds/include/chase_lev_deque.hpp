@@ -0,0 +1,115 @@
+// chase_lev_deque.hpp
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Fixed-capacity Chase-Lev work-stealing deque.
+ *
+ * One owner thread pushes and pops at the bottom (LIFO, cache-warm work
+ * first). Any other thread steals from the top (FIFO, the oldest work).
+ * This is the C11 formulation from Lê, Pop, Cohen and Zappa Nardelli,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (2013),
+ * without the growable buffer: push() fails when the deque is full.
+ *
+ * T must be trivially copyable; the executor stores job indices.
+ * reset() may only be called while no other thread touches the deque.
+ */
+template <typename T, size_t CAPACITY>
+class ChaseLevDeque
+{
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+public:
+    enum class Steal
+    {
+        Success,
+        Empty,
+        Retry, // Lost a race with the owner or another thief, the deque may still have work
+    };
+
+    ChaseLevDeque() { reset(); }
+
+    ChaseLevDeque(const ChaseLevDeque &) = delete;
+    ChaseLevDeque &operator=(const ChaseLevDeque &) = delete;
+
+    // Owner only
+    bool push(T item)
+    {
+        int32_t b = bottom_.load(std::memory_order_relaxed);
+        int32_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= static_cast<int32_t>(CAPACITY)) {
+            return false;
+        }
+        buffer_[b & MASK].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Owner only
+    bool pop(T &item)
+    {
+        int32_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int32_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = buffer_[b & MASK].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last item: race the thieves for it
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread
+    Steal steal(T &item)
+    {
+        int32_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int32_t b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return Steal::Empty;
+        }
+        item = buffer_[t & MASK].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return Steal::Retry;
+        }
+        return Steal::Success;
+    }
+
+    // Approximate when other threads are active
+    size_t size() const
+    {
+        int32_t b = bottom_.load(std::memory_order_relaxed);
+        int32_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    // Quiescent only. Also keeps the 32-bit indices far from overflow.
+    void reset()
+    {
+        top_.store(0, std::memory_order_relaxed);
+        bottom_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int32_t MASK = static_cast<int32_t>(CAPACITY - 1);
+
+    // top_ and bottom_ in separate cache lines: thieves hammer one, the owner the other
+    alignas(64) std::atomic<int32_t> top_;
+    alignas(64) std::atomic<int32_t> bottom_;
+    alignas(64) std::atomic<T> buffer_[CAPACITY];
+};
@@ -0,0 +1,35 @@
+// compute_request.hpp
+#pragma once
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "block_pool.hpp"
+
+/**
+ * @brief One queued SumBoss::compute call and its completion.
+ *
+ * Front-ends that hand work to SumBoss later (queues, async APIs) take
+ * these from compute_request_pool() instead of the heap. SumBoss::process
+ * fills result and err, then calls on_done, if set. on_done may give the
+ * request back to the pool; nothing touches it afterwards.
+ */
+struct ComputeRequest
+{
+    int a;
+    int b;
+    int result;
+    esp_err_t err;
+    void (*on_done)(ComputeRequest &request, void *ctx);
+    void *ctx;
+};
+
+#if CONFIG_IDF_TARGET_LINUX
+using ComputeRequestPool = BlockPool<ComputeRequest, CONFIG_HAL_AND_LEDS_REQUEST_POOL_SIZE>;
+#else
+using ComputeRequestPool = BlockPool<ComputeRequest, CONFIG_HAL_AND_LEDS_REQUEST_POOL_SIZE, portNUM_PROCESSORS>;
+#endif
+
+// The component's pool, CONFIG_HAL_AND_LEDS_REQUEST_POOL_SIZE requests in static storage.
+// Built before app_main, so even the first call may come from an ISR.
+ComputeRequestPool &compute_request_pool();
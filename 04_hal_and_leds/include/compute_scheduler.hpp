@@ -0,0 +1,195 @@
+// compute_scheduler.hpp
+#pragma once
+
+#include <coroutine>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "block_pool.hpp"
+#include "compute_request.hpp"
+#include "sum_boss.hpp"
+
+/**
+ * @brief One block of coroutine_frame_pool(), big enough for one frame.
+ */
+struct CoroutineFrame
+{
+    alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) unsigned char bytes[CONFIG_HAL_AND_LEDS_COROUTINE_FRAME_SIZE];
+};
+
+#if CONFIG_IDF_TARGET_LINUX
+using CoroutineFramePool = BlockPool<CoroutineFrame, CONFIG_HAL_AND_LEDS_COROUTINE_FRAMES>;
+#else
+using CoroutineFramePool = BlockPool<CoroutineFrame, CONFIG_HAL_AND_LEDS_COROUTINE_FRAMES, portNUM_PROCESSORS>;
+#endif
+
+// The frames of every ComputeTask, CONFIG_HAL_AND_LEDS_COROUTINE_FRAMES of
+// them in static storage
+CoroutineFramePool &coroutine_frame_pool();
+
+/**
+ * @brief What co_await scheduler.compute_async(a, b) gives back.
+ *
+ * err is what SumBoss::compute returned: the sum error, or the LED error
+ * when the sum succeeded but the LED didn't change.
+ */
+struct ComputeResult
+{
+    esp_err_t err;
+    int result;
+};
+
+/**
+ * @brief A coroutine that a ComputeScheduler runs.
+ *
+ * Any function returning ComputeTask is a coroutine that can co_await
+ * compute_async(). It doesn't start when called: it is handed to
+ * ComputeScheduler::spawn(), which runs it on the scheduler's task, and
+ * its frame goes back to the pool when it returns.
+ *
+ * The frame comes from coroutine_frame_pool(), never from the heap. A
+ * frame bigger than CONFIG_HAL_AND_LEDS_COROUTINE_FRAME_SIZE, or an empty
+ * pool, gives an invalid task, which spawn() rejects.
+ */
+class ComputeTask
+{
+public:
+    struct promise_type
+    {
+        ComputeTask get_return_object()
+        {
+            return ComputeTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        static ComputeTask get_return_object_on_allocation_failure() { return ComputeTask(); }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; } // Frees the frame
+        void return_void() {}
+        void unhandled_exception();
+
+        static void *operator new(size_t size) noexcept;
+        static void operator delete(void *frame) noexcept;
+    };
+
+    ComputeTask() = default;
+    ComputeTask(ComputeTask &&other) noexcept;
+    ComputeTask &operator=(ComputeTask &&other) noexcept;
+    ~ComputeTask(); // Frees the frame of a task that was never spawned
+
+    ComputeTask(const ComputeTask &) = delete;
+    ComputeTask &operator=(const ComputeTask &) = delete;
+
+    bool valid() const { return handle_ != nullptr; }
+
+private:
+    friend class ComputeScheduler;
+
+    explicit ComputeTask(std::coroutine_handle<promise_type> handle)
+        : handle_(handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief Runs ComputeTask coroutines on one FreeRTOS task, and the
+ *        SumBoss::compute calls they await.
+ *
+ *     ComputeTask show(ComputeScheduler &scheduler)
+ *     {
+ *         ComputeResult r = co_await scheduler.compute_async(3, 4);
+ *         if (r.err == ESP_OK) {
+ *             r = co_await scheduler.compute_async(r.result, 5);
+ *         }
+ *     }
+ *
+ *     scheduler.start();
+ *     scheduler.spawn(show(scheduler));
+ *
+ * co_await compute_async() suspends the coroutine and queues a
+ * ComputeRequest. The scheduler's task runs SumBoss::process() on it,
+ * which returns once the LED call did, and its on_done resumes the
+ * coroutine with the result. The request lives in the coroutine frame:
+ * nothing is allocated per call. The queue is a static FreeRTOS queue,
+ * one item per coroutine, so queueing never waits.
+ *
+ * Either start() the task, or call run_ready() from a task of your own,
+ * not both. The coroutines only run on the task that runs the scheduler,
+ * so they need no locks between them. spawn() may be called from any
+ * task.
+ */
+class ComputeScheduler
+{
+public:
+    static constexpr size_t QUEUE_LENGTH = CONFIG_HAL_AND_LEDS_COROUTINE_FRAMES + 1; // And stop()
+
+    class ComputeAwaiter
+    {
+    public:
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> caller) noexcept;
+        ComputeResult await_resume() const noexcept { return {request_.err, request_.result}; }
+
+    private:
+        friend class ComputeScheduler;
+
+        ComputeAwaiter(ComputeScheduler &scheduler, int a, int b);
+
+        ComputeScheduler &scheduler_;
+        ComputeRequest request_;
+    };
+
+    explicit ComputeScheduler(SumBoss &boss);
+    ~ComputeScheduler(); // Calls stop()
+
+    ComputeScheduler(const ComputeScheduler &) = delete;
+    ComputeScheduler &operator=(const ComputeScheduler &) = delete;
+
+    // Creates the scheduler's task. ESP_ERR_INVALID_STATE if it runs already.
+    esp_err_t start(UBaseType_t priority = 5, uint32_t stack_size = 4096);
+
+    // Runs what was queued before it, then ends the task. Coroutines still
+    // suspended after that stay suspended, their frames taken.
+    void stop();
+
+    // Queues a coroutine to start on the scheduler. ESP_ERR_NO_MEM for an
+    // invalid task (no frame for it) or a full queue; the task is freed.
+    esp_err_t spawn(ComputeTask task);
+
+    // Only from a coroutine running on this scheduler
+    ComputeAwaiter compute_async(int a, int b) { return ComputeAwaiter(*this, a, b); }
+
+    // Runs everything queued, until the queue is empty, on the calling
+    // task, and returns how many items ran. For tests and for apps with a
+    // loop of their own, instead of start().
+    size_t run_ready();
+
+private:
+    // A coroutine to start, a request to compute, or neither for stop()
+    struct Item
+    {
+        ComputeRequest *request;
+        void *coroutine;
+    };
+
+    bool post(const Item &item);
+    bool dispatch(const Item &item); // false for stop()
+    static void on_computed(ComputeRequest &request, void *ctx);
+    static void task_main(void *arg);
+
+    SumBoss &boss_;
+    StaticQueue_t queue_buffer_;
+    uint8_t queue_storage_[QUEUE_LENGTH * sizeof(Item)];
+    QueueHandle_t queue_;
+    TaskHandle_t task_;
+    StaticSemaphore_t stopped_buffer_;
+    SemaphoreHandle_t stopped_;
+};
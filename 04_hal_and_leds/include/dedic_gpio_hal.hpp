@@ -0,0 +1,86 @@
+// dedic_gpio_hal.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "soc/soc_caps.h"
+
+#if SOC_DEDICATED_GPIO_SUPPORTED
+#include "driver/dedic_gpio.h"
+#endif
+
+#include "gpio_hal.hpp"
+#include "i_gpio_hal.hpp"
+
+/**
+ * @brief IGpioHal backed by a dedicated GPIO bundle.
+ *
+ * On chips with dedicated GPIO (ESP32-S2/S3/C3/C6...) the pins passed to
+ * the constructor are mapped onto one output bundle, in order: pins[0] is
+ * bit 0 of the mask, pins[1] is bit 1, and so on. Writing a mapped pin is
+ * then a single CPU instruction instead of a trip through gpio_set_level.
+ *
+ * On chips without a bundle (ESP32, the linux target), or if the bundle
+ * can't be allocated, every call falls back to GpioHal. Pins that were not
+ * mapped always go through GpioHal too.
+ *
+ * The constructor makes every mapped pin an output: the bundle's out_en
+ * does it, or the fallback when there is no bundle. pin_set_direction()
+ * on a mapped pin then only checks the pin and the mode: the pad stays an
+ * output, so any other mode is ESP_ERR_NOT_SUPPORTED. Calling
+ * gpio_set_direction() on it again would route the pad back to the plain
+ * GPIO output and cut it off from the bundle.
+ *
+ * The bundle is bound to the core that created it: construct this object
+ * on the same core that will write the LEDs.
+ */
+class DedicGpioHal : public IGpioHal
+{
+public:
+    // Dedicated GPIO channels available per core on every supported chip
+    static constexpr size_t MAX_PINS = 8;
+
+    DedicGpioHal(const gpio_num_t *pins, size_t count);
+    // Same, with the given fallback instead of a GpioHal of its own
+    DedicGpioHal(const gpio_num_t *pins, size_t count, IGpioHal &fallback);
+    ~DedicGpioHal() override;
+
+    DedicGpioHal(const DedicGpioHal &) = delete;
+    DedicGpioHal &operator=(const DedicGpioHal &) = delete;
+
+    // A mapped pin is already an output: returns the result of its setup,
+    // or ESP_ERR_NOT_SUPPORTED for any other mode
+    esp_err_t pin_set_direction(gpio_num_t pin, gpio_mode_t mode) override;
+    esp_err_t pin_set_level(gpio_num_t pin, uint32_t level) override;
+
+    // Inputs and interrupts are not part of the output bundle, they always use GpioHal
+    int pin_get_level(gpio_num_t pin) override { return fallback_.pin_get_level(pin); }
+    esp_err_t pin_set_intr(gpio_num_t pin, gpio_int_type_t type, gpio_isr_t handler, void *arg) override
+    {
+        return fallback_.pin_set_intr(pin, type, handler, arg);
+    }
+    esp_err_t pin_remove_intr(gpio_num_t pin) override { return fallback_.pin_remove_intr(pin); }
+
+    // Mask API — bit N of mask/value refers to pins[N] given to the constructor
+
+    // Returns the bundle bit for the pin, or 0 if the pin is not mapped
+    uint32_t pin_mask(gpio_num_t pin) const;
+
+    // Writes every pin selected by mask with the matching bit of value
+    esp_err_t write_mask(uint32_t mask, uint32_t value);
+
+    // True if writes go through the dedicated bundle, false if they fall back to GpioHal
+    bool has_bundle() const;
+
+private:
+    GpioHal own_fallback_; // Used by the first constructor only
+    IGpioHal &fallback_;
+    gpio_num_t pins_[MAX_PINS];
+    size_t count_;
+    esp_err_t init_err_; // result of the pad setup of the mapped pins in the constructor
+
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    dedic_gpio_bundle_handle_t bundle_ = nullptr;
+#endif
+};
@@ -0,0 +1,99 @@
+// double_buffered_tx.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "i_dma_tx.hpp"
+
+/**
+ * @brief Two frames of up to MAX_BYTES, sent in turn over an IDmaTx.
+ *
+ *     DoubleBufferedTx<8> frames(spi, 10);
+ *     frames.send(len, [&](uint8_t *frame) { ... fill len bytes ... });
+ *
+ * send() fills the frame that isn't on the wire, queues it and returns.
+ * While one frame goes out, the next send() fills the other, so a frame
+ * is never written while the peripheral still reads it. Only when both
+ * are in flight does send() wait, for the older one to end, and then for
+ * no more than the wait_ms given to the constructor.
+ *
+ * The frames live inside the object, and the destructor waits for both to
+ * be handed back. When the peripheral reads them by DMA, the object must
+ * sit in DMA-capable memory (internal RAM, not PSRAM).
+ */
+template <size_t MAX_BYTES>
+class DoubleBufferedTx
+{
+public:
+    DoubleBufferedTx(IDmaTx &tx, uint32_t wait_ms)
+        : tx_(tx)
+        , wait_ms_(wait_ms)
+        , frames_()
+        , in_flight_()
+        , next_(0)
+    {
+    }
+
+    ~DoubleBufferedTx()
+    {
+        for (int i = 0; i < 2 && (in_flight_[0] || in_flight_[1]); i++) {
+            reclaim();
+        }
+    }
+
+    DoubleBufferedTx(const DoubleBufferedTx &) = delete;
+    DoubleBufferedTx &operator=(const DoubleBufferedTx &) = delete;
+
+    // Calls fill(frame) on the free frame, then queues its first len bytes.
+    // ESP_ERR_INVALID_SIZE above MAX_BYTES, ESP_ERR_TIMEOUT if both frames
+    // stayed in flight, else what IDmaTx::queue_tx() returned. Nothing is
+    // sent on an error: the caller's next send() carries its state.
+    template <typename Fill>
+    esp_err_t send(size_t len, Fill fill)
+    {
+        if (len > MAX_BYTES) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        // The frames are queued in turn and end in order: when this one is
+        // still in flight, it is the older of the two, the next to end
+        if (in_flight_[next_]) {
+            esp_err_t ret = reclaim();
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+
+        uint8_t *frame = frames_[next_];
+        fill(frame);
+        esp_err_t ret = tx_.queue_tx(frame, len);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        in_flight_[next_] = true;
+        next_ ^= 1;
+        return ESP_OK;
+    }
+
+private:
+    esp_err_t reclaim()
+    {
+        const uint8_t *done = nullptr;
+        esp_err_t ret = tx_.wait_tx(&done, wait_ms_);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        for (int i = 0; i < 2; i++) {
+            if (done == frames_[i]) {
+                in_flight_[i] = false;
+            }
+        }
+        return ESP_OK;
+    }
+
+    IDmaTx &tx_;
+    uint32_t wait_ms_;
+    alignas(4) uint8_t frames_[2][MAX_BYTES];
+    bool in_flight_[2];
+    int next_; // The frame the next send() fills
+};
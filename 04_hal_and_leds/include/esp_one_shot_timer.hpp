@@ -0,0 +1,31 @@
+// esp_one_shot_timer.hpp
+#pragma once
+
+#include "esp_timer.h"
+
+#include "i_one_shot_timer.hpp"
+
+/**
+ * @brief IOneShotTimer on esp_timer (chip targets only).
+ *
+ * The callback runs in the esp_timer task, so it may take a mutex and
+ * call the LED driver. Every EspOneShotTimer is one esp_timer: many users
+ * can share one instance, and LedSequencer does, for all its patterns.
+ */
+class EspOneShotTimer : public IOneShotTimer
+{
+public:
+    explicit EspOneShotTimer(const char *name);
+    ~EspOneShotTimer() override;
+
+    EspOneShotTimer(const EspOneShotTimer &) = delete;
+    EspOneShotTimer &operator=(const EspOneShotTimer &) = delete;
+
+    esp_err_t attach(Callback callback, void *arg) override;
+    esp_err_t start_once(uint64_t timeout_us) override;
+    void stop() override;
+
+private:
+    const char *name_;
+    esp_timer_handle_t timer_;
+};
@@ -0,0 +1,23 @@
+// fd_stream.hpp
+#pragma once
+
+#include "i_byte_stream.hpp"
+
+/**
+ * @brief IByteStream over two file descriptors (linux target only).
+ *
+ * stdin and stdout, a pipe, a socket or a pty: anything read() and
+ * write() work on. The descriptors stay owned by the caller.
+ */
+class FdStream : public IByteStream
+{
+public:
+    FdStream(int read_fd, int write_fd);
+
+    int read(uint8_t *data, size_t length, uint32_t timeout_ms) override;
+    int write(const uint8_t *data, size_t length) override;
+
+private:
+    int read_fd_;
+    int write_fd_;
+};
@@ -12,4 +12,27 @@ public:
         return gpio_set_direction(gpio_num, mode);
     }
     esp_err_t pin_set_level(gpio_num_t gpio_num, uint32_t level) override { return gpio_set_level(gpio_num, level); }
+    int pin_get_level(gpio_num_t gpio_num) override { return gpio_get_level(gpio_num); }
+    esp_err_t pin_set_intr(gpio_num_t gpio_num, gpio_int_type_t type, gpio_isr_t handler, void *arg) override
+    {
+        // The per-pin ISR service is shared by the whole app: if someone
+        // already installed it, that's fine.
+        esp_err_t ret = gpio_install_isr_service(0);
+        if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+            return ret;
+        }
+        ret = gpio_set_intr_type(gpio_num, type);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        return gpio_isr_handler_add(gpio_num, handler, arg);
+    }
+    esp_err_t pin_remove_intr(gpio_num_t gpio_num) override
+    {
+        esp_err_t ret = gpio_isr_handler_remove(gpio_num);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        return gpio_set_intr_type(gpio_num, GPIO_INTR_DISABLE);
+    }
 };
\ No newline at end of file
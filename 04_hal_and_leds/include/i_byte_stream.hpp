@@ -0,0 +1,23 @@
+// i_byte_stream.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A byte pipe to whatever drives BatchServer: a UART on the chips,
+ *        file descriptors on the linux target.
+ */
+class IByteStream
+{
+public:
+    virtual ~IByteStream() = default;
+
+    // Waits up to timeout_ms for at least one byte, then reads what's there,
+    // up to length. Returns the number of bytes, 0 on timeout, or -1 if the
+    // stream is closed or broken.
+    virtual int read(uint8_t *data, size_t length, uint32_t timeout_ms) = 0;
+
+    // Writes all of data. Returns length, or -1 on error.
+    virtual int write(const uint8_t *data, size_t length) = 0;
+};
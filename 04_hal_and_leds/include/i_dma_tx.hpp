@@ -0,0 +1,29 @@
+// i_dma_tx.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+/**
+ * @brief A write-only peripheral that sends queued buffers on its own.
+ *
+ * queue_tx() hands a buffer to the peripheral and returns at once; the
+ * CPU is free while the bytes go out, by DMA or from the driver's ISR.
+ * The buffer belongs to the transfer until wait_tx() gives it back, and
+ * transfers end in the order they were queued. SpiDevice (74HC595 chains)
+ * and RmtChannel (WS2812 pixels) implement it on the chips, FakeDmaTx in
+ * the host tests. DoubleBufferedTx keeps a pair of frames going over it.
+ */
+class IDmaTx
+{
+public:
+    virtual ~IDmaTx() = default;
+    // Starts sending len bytes of data. ESP_ERR_INVALID_STATE when too
+    // many transfers are queued already.
+    virtual esp_err_t queue_tx(const uint8_t *data, size_t len) = 0;
+    // Waits up to timeout_ms for the oldest queued transfer to end and
+    // returns its buffer in data. ESP_ERR_TIMEOUT if it didn't end.
+    virtual esp_err_t wait_tx(const uint8_t **data, uint32_t timeout_ms) = 0;
+};
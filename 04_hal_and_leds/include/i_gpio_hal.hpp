@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 #include "esp_err.h"
 #include "driver/gpio.h"
 
@@ -9,4 +11,29 @@ public:
     virtual ~IGpioHal() = default;
     virtual esp_err_t pin_set_direction(gpio_num_t pin, gpio_mode_t mode) = 0;
     virtual esp_err_t pin_set_level(gpio_num_t pin, uint32_t level) = 0;
+    virtual int pin_get_level(gpio_num_t pin) = 0;
+    // Calls handler(arg) from interrupt context on each edge of the given type
+    virtual esp_err_t pin_set_intr(gpio_num_t pin, gpio_int_type_t type, gpio_isr_t handler, void *arg) = 0;
+    virtual esp_err_t pin_remove_intr(gpio_num_t pin) = 0;
+
+    // Drives every pin of clear_mask low, then every pin of set_mask high;
+    // bit N is GPIO N, so a pin in both ends up high. This default writes
+    // them one at a time; backends with set/clear registers override it
+    // with one write per register.
+    virtual esp_err_t port_set_levels(uint64_t set_mask, uint64_t clear_mask)
+    {
+        for (uint64_t bits = clear_mask & ~set_mask; bits != 0; bits &= bits - 1) {
+            esp_err_t ret = pin_set_level(static_cast<gpio_num_t>(__builtin_ctzll(bits)), 0);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+        for (uint64_t bits = set_mask; bits != 0; bits &= bits - 1) {
+            esp_err_t ret = pin_set_level(static_cast<gpio_num_t>(__builtin_ctzll(bits)), 1);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+        return ESP_OK;
+    }
 };
\ No newline at end of file
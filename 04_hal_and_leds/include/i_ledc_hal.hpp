@@ -0,0 +1,35 @@
+// i_ledc_hal.hpp
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+/**
+ * @brief The part of the LEDC peripheral that LedcLedSargent uses.
+ *
+ * One timer shared by every channel, and channels that each drive one pin
+ * with a duty cycle of duty_bits bits. fade_to() hands a ramp to the
+ * hardware and returns at once: the CPU sets the target and is free while
+ * the LED dims or brightens. A fade in progress is stopped by the next
+ * set_duty() or fade_to() on its channel, on chips that can stop one. On
+ * the others that call waits until the fade ends. LedcHal implements it on the chips,
+ * FakeLedcHal in the host tests.
+ */
+class ILedcHal
+{
+public:
+    virtual ~ILedcHal() = default;
+    // Configures the shared timer. Must come before any channel.
+    virtual esp_err_t timer_config(uint32_t freq_hz, uint32_t duty_bits) = 0;
+    // Routes a channel to a pin, on the shared timer, with duty 0
+    virtual esp_err_t channel_config(uint32_t channel, gpio_num_t pin) = 0;
+    // Applies a duty at once, stopping a fade in progress on the channel
+    // (or, without fade stop, after waiting for it to end)
+    virtual esp_err_t set_duty(uint32_t channel, uint32_t duty) = 0;
+    // Starts a hardware fade from the current duty to duty over time_ms,
+    // taking over from a fade in progress the same way set_duty() does
+    virtual esp_err_t fade_to(uint32_t channel, uint32_t duty, uint32_t time_ms) = 0;
+    virtual uint32_t get_duty(uint32_t channel) = 0;
+};
@@ -0,0 +1,26 @@
+// i_one_shot_timer.hpp
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+/**
+ * @brief A one-shot timer that calls back once per start_once().
+ *
+ * EspOneShotTimer implements it with esp_timer on the chips, VirtualTimer
+ * on VirtualClock in the host tests.
+ */
+class IOneShotTimer
+{
+public:
+    typedef void (*Callback)(void *arg);
+
+    virtual ~IOneShotTimer() = default;
+    // Sets what the timer calls. Must come before start_once().
+    virtual esp_err_t attach(Callback callback, void *arg) = 0;
+    // Fires once, timeout_us from now. Replaces a start that hasn't fired yet.
+    virtual esp_err_t start_once(uint64_t timeout_us) = 0;
+    // A timer that isn't running is fine
+    virtual void stop() = 0;
+};
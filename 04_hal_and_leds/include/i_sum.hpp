@@ -9,4 +9,6 @@ public:
     virtual int add(int a, int b) = 0;
     virtual int add_constrained(int a, int b) = 0;
     virtual esp_err_t add_constrained_err(int a, int b, int &result) = 0;
+    // Same as add_constrained_err, but never logs: safe to call from an ISR
+    virtual esp_err_t add_constrained_err_isr(int a, int b, int &result) = 0;
 };
\ No newline at end of file
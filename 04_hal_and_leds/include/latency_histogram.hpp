@@ -0,0 +1,54 @@
+// latency_histogram.hpp
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Fixed-memory log-linear histogram of latencies (HDR-style).
+ *
+ * Values are 32-bit, in whatever unit the caller records (microseconds,
+ * CPU cycles...). Each power of two is split into SUB_BUCKETS linear
+ * buckets, so a reported percentile is never more than 1/SUB_BUCKETS
+ * (~3%) above the real value. Values below 2 * SUB_BUCKETS are exact.
+ *
+ * record() is lock-free and never allocates, so it can run on the compute
+ * path, ISRs included. Percentiles and reset() are meant for a reporting
+ * task: a record() racing with reset() may survive it, nothing worse.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 5;
+    static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKETS = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    void record(uint32_t value);
+    void reset();
+
+    uint32_t count() const;
+    uint32_t max() const;
+
+    // Smallest recorded bucket holding at least percent% of the samples,
+    // reported as the highest value of that bucket. 0 if empty.
+    uint32_t percentile(double percent) const;
+
+    uint32_t p50() const { return percentile(50.0); }
+    uint32_t p99() const { return percentile(99.0); }
+    uint32_t p999() const { return percentile(99.9); }
+
+    // Bucket math, public so the tests can check it directly
+    static size_t bucket_index(uint32_t value);
+    static uint32_t bucket_highest(size_t index);
+
+private:
+    std::atomic<uint32_t> buckets_[BUCKETS];
+    std::atomic<uint32_t> count_;
+    std::atomic<uint32_t> max_;
+};
@@ -0,0 +1,129 @@
+// led_bank.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "i_gpio_hal.hpp"
+#include "i_led_sargent.hpp"
+
+/**
+ * @brief A row of LEDs on pins fixed at compile time, written all at once.
+ *
+ *     LedBank<GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_18, GPIO_NUM_19> status(gpio_hal);
+ *     status.show(0b0101);   // LEDs 0 and 2 on, 1 and 3 off
+ *
+ * Bit N of a state is the LED on the Nth pin of the list. pin_mask() turns
+ * a state into a GPIO mask; with the pins known at compile time, a
+ * constant state gives a constant mask, and any state is a few shifts and
+ * ORs. Every write is then one IGpioHal::port_set_levels() call, which
+ * LlGpioHal does with one write to the clear register and one to the set
+ * register, whatever the number of LEDs.
+ *
+ * The pins are set up as outputs in the constructor. As in LedSargent, a
+ * failed setup is remembered and returned by every method, which then
+ * writes nothing.
+ */
+template <gpio_num_t... Pins>
+class LedBank
+{
+public:
+    static constexpr size_t COUNT = sizeof...(Pins);
+    static constexpr gpio_num_t PINS[] = {Pins...};
+    // Every LED of the bank, as a state
+    static constexpr uint32_t ALL = (COUNT == 32) ? 0xFFFFFFFFu : (1u << (COUNT % 32)) - 1;
+
+    static_assert(COUNT > 0 && COUNT <= 32, "a bank has 1 to 32 LEDs");
+    static_assert(((Pins >= 0 && Pins < GPIO_NUM_MAX && Pins < 64) && ...), "every pin must be a GPIO");
+
+    // The GPIO mask of the LEDs in state: bit PINS[N] for each bit N
+    static constexpr uint64_t pin_mask(uint32_t state)
+    {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < COUNT; i++) {
+            if ((state >> i) & 1u) {
+                mask |= 1ull << PINS[i];
+            }
+        }
+        return mask;
+    }
+
+    // pin_mask(ALL)
+    static constexpr uint64_t ALL_PINS = ((1ull << Pins) | ...);
+
+    static_assert(static_cast<size_t>(__builtin_popcountll(ALL_PINS)) == COUNT, "a pin appears twice");
+
+    explicit LedBank(IGpioHal &gpio_hal)
+        : gpio_hal_(gpio_hal)
+        , init_err_(ESP_OK)
+    {
+        for (gpio_num_t pin : PINS) {
+            esp_err_t ret = gpio_hal_.pin_set_direction(pin, GPIO_MODE_OUTPUT);
+            if (ret != ESP_OK && init_err_ == ESP_OK) {
+                init_err_ = ret;
+            }
+        }
+    }
+
+    // Lights the LEDs of state and turns the others off, in one port write.
+    // ESP_ERR_INVALID_ARG for a bit past the last LED.
+    esp_err_t show(uint32_t state) { return write(state, ALL & ~state); }
+
+    // Light or turn off some LEDs, leaving the others as they are
+    esp_err_t set(uint32_t leds) { return write(leds, 0); }
+    esp_err_t clear(uint32_t leds) { return write(0, leds); }
+
+    // The LEDs lit by the last writes that succeeded
+    uint32_t state() const { return state_; }
+
+private:
+    esp_err_t write(uint32_t on, uint32_t off)
+    {
+        if (init_err_ != ESP_OK) {
+            return init_err_;
+        }
+        if (((on | off) & ~ALL) != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        esp_err_t ret = gpio_hal_.port_set_levels(pin_mask(on), pin_mask(off));
+        if (ret == ESP_OK) {
+            state_ = (state_ & ~off) | on;
+        }
+        return ret;
+    }
+
+    IGpioHal &gpio_hal_;
+    esp_err_t init_err_; // result of the pin setup in the constructor
+    uint32_t state_ = 0;
+};
+
+/**
+ * @brief LedSargent on a two-LED LedBank: green is LED 0, red is LED 1.
+ *
+ * Keeps the ILedSargent contract, so it drops into SumBoss: green() and
+ * red() light one LED and leave the other alone, off() turns both off in
+ * one port write.
+ */
+template <gpio_num_t Green, gpio_num_t Red>
+class LedBankSargent : public ILedSargent
+{
+public:
+    using Bank = LedBank<Green, Red>;
+
+    static constexpr uint32_t GREEN = 1u << 0;
+    static constexpr uint32_t RED = 1u << 1;
+
+    explicit LedBankSargent(IGpioHal &gpio_hal)
+        : bank_(gpio_hal)
+    {
+    }
+
+    esp_err_t green() override { return bank_.set(GREEN); }
+    esp_err_t red() override { return bank_.set(RED); }
+    esp_err_t off() override { return bank_.show(0); }
+
+    Bank &bank() { return bank_; }
+
+private:
+    Bank bank_;
+};
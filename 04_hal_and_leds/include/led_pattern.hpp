@@ -0,0 +1,83 @@
+// led_pattern.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+/**
+ * @brief One step of a blink pattern: a colour held for ms milliseconds.
+ */
+struct LedStep
+{
+    enum Color : uint8_t
+    {
+        OFF,
+        GREEN,
+        RED,
+    };
+
+    Color color;
+    uint16_t ms;
+};
+
+/**
+ * @brief A blink pattern: a constant table of steps, played by LedSequencer.
+ *
+ * Patterns are meant to be constexpr tables, so playing one allocates
+ * nothing and the table stays in flash. repeat is how many times the
+ * steps are played, 0 for forever. A pattern with a higher priority
+ * preempts the one showing; the preempted one resumes where it stopped.
+ */
+struct LedPattern
+{
+    const LedStep *steps;
+    uint8_t count;
+    uint8_t priority;
+    uint8_t repeat;
+};
+
+/**
+ * @brief The blink codes of SumBoss results.
+ *
+ * The longer a code, the more it matters: errors outrank a success, an
+ * invalid argument outranks a result out of range, and the heartbeat
+ * outranks nothing.
+ */
+struct LedPatterns
+{
+    // A short green flash
+    static constexpr LedStep OK_STEPS[] = {{LedStep::GREEN, 300}, {LedStep::OFF, 100}};
+    // ESP_FAIL: one long red blink, twice
+    static constexpr LedStep OUT_OF_RANGE_STEPS[] = {{LedStep::RED, 800}, {LedStep::OFF, 400}};
+    // ESP_ERR_INVALID_ARG: two short red blinks and a pause, twice
+    static constexpr LedStep INVALID_ARG_STEPS[] = {
+        {LedStep::RED, 150}, {LedStep::OFF, 150}, {LedStep::RED, 150}, {LedStep::OFF, 600}};
+    // Anything else: fast red blinking
+    static constexpr LedStep OTHER_ERROR_STEPS[] = {{LedStep::RED, 100}, {LedStep::OFF, 100}};
+    // Alive and idle: a blip of green every 3 seconds, forever
+    static constexpr LedStep HEARTBEAT_STEPS[] = {{LedStep::GREEN, 50}, {LedStep::OFF, 2950}};
+
+    // {steps, count, priority, repeat}
+    static constexpr LedPattern OK = {OK_STEPS, sizeof(OK_STEPS) / sizeof(LedStep), 1, 1};
+    static constexpr LedPattern OUT_OF_RANGE = {OUT_OF_RANGE_STEPS, sizeof(OUT_OF_RANGE_STEPS) / sizeof(LedStep), 2, 2};
+    static constexpr LedPattern INVALID_ARG = {INVALID_ARG_STEPS, sizeof(INVALID_ARG_STEPS) / sizeof(LedStep), 3, 2};
+    static constexpr LedPattern OTHER_ERROR = {OTHER_ERROR_STEPS, sizeof(OTHER_ERROR_STEPS) / sizeof(LedStep), 4, 5};
+    static constexpr LedPattern HEARTBEAT = {HEARTBEAT_STEPS, sizeof(HEARTBEAT_STEPS) / sizeof(LedStep), 0, 0};
+
+    // The code of a SumBoss result
+    static const LedPattern &for_result(esp_err_t err)
+    {
+        switch (err) {
+        case ESP_OK:
+            return OK;
+        case ESP_FAIL:
+            return OUT_OF_RANGE;
+        case ESP_ERR_INVALID_ARG:
+            return INVALID_ARG;
+        default:
+            return OTHER_ERROR;
+        }
+    }
+};
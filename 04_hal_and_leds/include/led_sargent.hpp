@@ -17,4 +17,5 @@ private:
     IGpioHal &gpio_hal_;
     gpio_num_t green_;
     gpio_num_t red_;
+    esp_err_t init_err_; // result of the pin setup in the constructor
 };
\ No newline at end of file
@@ -0,0 +1,94 @@
+// led_sequencer.hpp
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "i_led_sargent.hpp"
+#include "i_one_shot_timer.hpp"
+#include "led_pattern.hpp"
+
+/**
+ * @brief Plays LedPattern tables on an ILedSargent from one timer.
+ *
+ * Nothing blocks: play() shows the first step and arms the timer, and
+ * each timer callback moves to the next step and arms it again. No task
+ * sits in vTaskDelay between steps.
+ *
+ * Up to MAX_PATTERNS play at once over the same timer. Only the one with
+ * the highest priority shows, the latest started among equals; the
+ * others are paused on their current step, with what was left of it,
+ * and resume when it ends. A full sequencer makes room by dropping its
+ * lowest-priority pattern, if it is lower than the new one.
+ *
+ * Patterns are referenced, not copied: they must outlive their playing,
+ * which constexpr tables do. play() and stop() take a mutex that the
+ * callback also takes, so they must not be called from an ISR.
+ *
+ * The destructor stops the timer under that mutex, and waits for a
+ * callback the timer had already dispatched to return: it finds the
+ * sequencer stopping and leaves the LEDs alone. The timer must outlive
+ * the sequencer.
+ */
+class LedSequencer
+{
+public:
+    static constexpr size_t MAX_PATTERNS = 4;
+
+    // now_us is the clock the timer runs on (esp_timer_get_time on target)
+    LedSequencer(ILedSargent &leds, IOneShotTimer &timer, int64_t (*now_us)());
+    ~LedSequencer();
+
+    LedSequencer(const LedSequencer &) = delete;
+    LedSequencer &operator=(const LedSequencer &) = delete;
+
+    // Starts a pattern, or restarts it if it is already playing.
+    // ESP_ERR_INVALID_ARG for an empty pattern or a step of 0 ms,
+    // ESP_ERR_NO_MEM if no pattern of a lower priority can make room.
+    // If the pattern shows at once, a failed LED call is returned too.
+    esp_err_t play(const LedPattern &pattern);
+
+    // Stops a pattern, playing or paused. The next one resumes.
+    void stop(const LedPattern &pattern);
+    void stop_all();
+
+    // The pattern on the LEDs, nullptr when idle
+    const LedPattern *showing() const;
+    size_t playing() const;
+
+    // The timer's callback, arg is the sequencer
+    static void on_timer(void *arg);
+
+private:
+    struct Slot
+    {
+        const LedPattern *pattern; // nullptr when free
+        uint8_t step;
+        uint8_t repeats_left;      // 0 with pattern->repeat 0: forever
+        int64_t remaining_us;      // Left of the current step, while paused
+        uint32_t order;            // Start order, newest wins among equals
+    };
+
+    void advance(int64_t now);
+    void reschedule(int64_t now);
+    int best_slot() const;
+    esp_err_t show(LedStep::Color color);
+    esp_err_t arm(int64_t now);
+
+    ILedSargent &leds_;
+    IOneShotTimer &timer_;
+    int64_t (*now_us_)();
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;  // Signalled when the last callback in flight leaves
+    std::atomic<int> callbacks_{0}; // In on_timer(), counted before they take mutex_
+    Slot slots_[MAX_PATTERNS];
+    int active_;          // Slot on the LEDs, -1 when idle
+    int64_t deadline_us_; // End of the active slot's current step
+    uint32_t next_order_;
+    int shown_;           // LedStep::Color on the LEDs, -1 before the first show
+    bool stopping_;       // Set by the destructor: callbacks return at once
+    esp_err_t init_err_;  // result of timer.attach() in the constructor
+};
@@ -0,0 +1,37 @@
+// ledc_hal.hpp
+#pragma once
+
+#include "i_ledc_hal.hpp"
+
+/**
+ * @brief ILedcHal on the ESP-IDF LEDC driver (chip targets only).
+ *
+ * Uses the low-speed group, which every chip has, and LEDC_TIMER_0 for
+ * all channels. timer_config() also installs the driver's fade service;
+ * if someone else already installed it, that one is shared.
+ *
+ * set_duty() and fade_to() stop the fade in progress on the channel with
+ * ledc_fade_stop(). Chips without it (SOC_LEDC_SUPPORT_FADE_STOP unset,
+ * such as the ESP32) can't stop a fade. There the driver makes the call
+ * wait until the fade in progress ends.
+ *
+ * The linux target has no LEDC driver: the host tests use FakeLedcHal.
+ */
+class LedcHal : public ILedcHal
+{
+public:
+    LedcHal();
+    ~LedcHal() override;
+
+    LedcHal(const LedcHal &) = delete;
+    LedcHal &operator=(const LedcHal &) = delete;
+
+    esp_err_t timer_config(uint32_t freq_hz, uint32_t duty_bits) override;
+    esp_err_t channel_config(uint32_t channel, gpio_num_t pin) override;
+    esp_err_t set_duty(uint32_t channel, uint32_t duty) override;
+    esp_err_t fade_to(uint32_t channel, uint32_t duty, uint32_t time_ms) override;
+    uint32_t get_duty(uint32_t channel) override;
+
+private:
+    bool fade_installed_; // True if this object installed the fade service
+};
@@ -0,0 +1,67 @@
+// ledc_led_sargent.hpp
+#pragma once
+
+#include <stdint.h>
+
+#include "i_led_sargent.hpp"
+#include "i_ledc_hal.hpp"
+
+/**
+ * @brief ILedSargent on two LEDC channels: brightness and hardware fades.
+ *
+ * Same contract as LedSargent: green() and red() light one LED and leave
+ * the other alone, off() turns both off. The LEDs are lit at the
+ * brightness set with set_brightness(), and with set_fade_ms() every
+ * change becomes a hardware fade. Either way each call is one or two
+ * register writes, and the CPU has nothing to do until the next change:
+ * no task wakes up to step a blink or a ramp.
+ *
+ * Like LedSargent, the setup is done once, in the constructor. If it
+ * fails, every method returns that error without touching the HAL.
+ */
+class LedcLedSargent : public ILedSargent
+{
+public:
+    static constexpr uint32_t FREQ_HZ = 5000;  // Well above what the eye sees as flicker
+    static constexpr uint32_t DUTY_BITS = 10;  // Supported at 5 kHz on every chip
+    static constexpr uint32_t MAX_DUTY = (1u << DUTY_BITS) - 1;
+    static constexpr uint32_t GREEN_CHANNEL = 0;
+    static constexpr uint32_t RED_CHANNEL = 1;
+
+    enum Led
+    {
+        GREEN,
+        RED,
+    };
+
+    LedcLedSargent(ILedcHal &ledc_hal, gpio_num_t green, gpio_num_t red);
+
+    esp_err_t green() override;
+    esp_err_t red() override;
+    esp_err_t off() override;
+
+    // 0 to 100%, for the LEDs lit from now on and for those already lit.
+    // ESP_ERR_INVALID_ARG above 100.
+    esp_err_t set_brightness(uint8_t percent);
+
+    // Fade time of green(), red(), off() and set_brightness(). 0, the
+    // default, switches at once.
+    void set_fade_ms(uint32_t fade_ms) { fade_ms_ = fade_ms; }
+
+    // One fade of one LED to percent over time_ms, whatever set_fade_ms says.
+    // Returns at once. The LED counts as lit, for set_brightness(), if
+    // percent isn't 0.
+    esp_err_t fade(Led led, uint8_t percent, uint32_t time_ms);
+
+    // Duty for a brightness, rounded to the nearest step
+    static uint32_t duty_for(uint8_t percent) { return (percent * MAX_DUTY + 50) / 100; }
+
+private:
+    esp_err_t apply(Led led, uint32_t duty, uint32_t time_ms);
+
+    ILedcHal &ledc_hal_;
+    uint32_t duty_;      // Duty of a lit LED, from set_brightness()
+    uint32_t fade_ms_;
+    bool lit_[2];        // Indexed by Led, set by green()/red(), cleared by off()
+    esp_err_t init_err_; // result of the timer and channel setup in the constructor
+};
@@ -0,0 +1,45 @@
+// ll_gpio_hal.hpp
+#pragma once
+
+#include "gpio_hal.hpp"
+#include "i_gpio_hal.hpp"
+
+/**
+ * @brief IGpioHal that writes the GPIO registers directly through hal/gpio_ll.h.
+ *
+ * pin_set_level skips the argument checks of the driver: the pin number is
+ * trusted. Pins are validated once, by pin_set_direction (which still goes
+ * through the driver), and LedSargent refuses to write pins whose setup
+ * failed. Only pass pins here that went through pin_set_direction first.
+ *
+ * pin_set_level never logs, so this is the backend to use on the ISR path.
+ * It lives in its own source file so the linker fragment can place its code
+ * and vtable in IRAM/DRAM (CONFIG_HAL_AND_LEDS_COMPUTE_IN_IRAM).
+ *
+ * port_set_levels writes many pins at once through the W1TC/W1TS
+ * registers, with the same trust in the pins.
+ *
+ * pin_get_level reads the input register the same way. Interrupt setup is
+ * not on the hot path and goes through GpioHal.
+ *
+ * The linux target has no GPIO registers, so there it behaves like GpioHal.
+ */
+class LlGpioHal : public IGpioHal
+{
+public:
+    LlGpioHal() = default;
+    esp_err_t pin_set_direction(gpio_num_t gpio_num, gpio_mode_t mode) override;
+    esp_err_t pin_set_level(gpio_num_t gpio_num, uint32_t level) override;
+    int pin_get_level(gpio_num_t gpio_num) override;
+    // One write to the clear register, then one to the set register
+    // (two of each on chips with more than 32 GPIOs), for every pin at once
+    esp_err_t port_set_levels(uint64_t set_mask, uint64_t clear_mask) override;
+    esp_err_t pin_set_intr(gpio_num_t gpio_num, gpio_int_type_t type, gpio_isr_t handler, void *arg) override
+    {
+        return driver_.pin_set_intr(gpio_num, type, handler, arg);
+    }
+    esp_err_t pin_remove_intr(gpio_num_t gpio_num) override { return driver_.pin_remove_intr(gpio_num); }
+
+private:
+    GpioHal driver_;
+};
@@ -0,0 +1,94 @@
+// operand_input.hpp
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "i_gpio_hal.hpp"
+#include "sum_boss.hpp"
+
+/**
+ * @brief A pair of operands latched from the input pins.
+ */
+struct Operands
+{
+    int a;
+    int b;
+};
+
+/**
+ * @brief Pins and timing for OperandInput.
+ *
+ * The operands are read in parallel from the data pins, LSB first, when
+ * the strobe pin rises. With 4 bits per operand, the inputs cover 0..15,
+ * so both valid and out-of-range values for Sum can be entered.
+ */
+struct OperandInputConfig
+{
+    static constexpr size_t BITS = 4;
+
+    gpio_num_t strobe;       // Rising edge latches a and b
+    gpio_num_t a_pins[BITS]; // Operand a, bit 0 first
+    gpio_num_t b_pins[BITS]; // Operand b, bit 0 first
+    int64_t debounce_us;     // Edges closer than this to the last accepted one are bounces
+    int64_t (*now_us)();     // Time source, usable from an ISR (esp_timer_get_time on target)
+};
+
+/**
+ * @brief Interrupt-driven input stage that feeds SumBoss.
+ *
+ * The strobe interrupt debounces the edge, reads both operands and pushes
+ * them into a single-producer/single-consumer ring. No lock is taken: the
+ * ISR only moves the head, the consumer only moves the tail. The consumer
+ * task sleeps in process() until the ISR notifies it, so nothing polls the
+ * pins between events.
+ *
+ * If the ring is full, the new operands are dropped and counted.
+ */
+class OperandInput
+{
+public:
+    static constexpr size_t QUEUE_SIZE = 8; // Power of two
+
+    OperandInput(IGpioHal &gpio_hal, const OperandInputConfig &config);
+    ~OperandInput();
+
+    OperandInput(const OperandInput &) = delete;
+    OperandInput &operator=(const OperandInput &) = delete;
+
+    // Waits up to timeout for operands, then runs them through boss.compute().
+    // Returns ESP_ERR_TIMEOUT if nothing arrived, or the result of compute().
+    // A notification left over from operands already popped doesn't cut
+    // the wait short.
+    esp_err_t process(SumBoss &boss, int &result, TickType_t timeout);
+
+    // Takes the oldest operands without waiting. Consumer side only.
+    bool pop(Operands &out);
+
+    // Operands lost because the ring was full
+    uint32_t dropped() const;
+
+    // Strobe interrupt handler, registered through IGpioHal::pin_set_intr
+    static void on_strobe(void *arg);
+
+private:
+    int read_operand(const gpio_num_t *pins);
+    void push_from_isr(const Operands &operands);
+
+    IGpioHal &gpio_hal_;
+    OperandInputConfig config_;
+    esp_err_t init_err_;
+
+    Operands queue_[QUEUE_SIZE];
+    std::atomic<uint32_t> head_{0}; // Written by the ISR only
+    std::atomic<uint32_t> tail_{0}; // Written by the consumer only
+    std::atomic<uint32_t> dropped_{0};
+    std::atomic<TaskHandle_t> waiter_{nullptr};
+
+    int64_t last_edge_us_;
+    bool has_last_edge_;
+};
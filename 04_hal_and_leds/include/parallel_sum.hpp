@@ -0,0 +1,111 @@
+// parallel_sum.hpp
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#else
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#endif
+
+#include "sum_stream.hpp"
+
+/**
+ * @brief Parallel constrained sum of a sample buffer.
+ *
+ * The buffer is split into one contiguous slice per worker. Each worker
+ * writes its partial sum into its own cache line, then the partials are
+ * combined with add_constrained_err's rules: any sample outside
+ * [sample_min, sample_max] is ESP_ERR_INVALID_ARG, a total outside
+ * [sum_min, sum_max] is ESP_FAIL, and result is -1 on any error. Unlike
+ * SumStream, only the total is checked, not every running sum. Partials
+ * are 64-bit, so they can't overflow before the check.
+ *
+ * On the chips, the workers are two FreeRTOS tasks pinned to PRO_CPU and
+ * APP_CPU (one task on single-core chips). On the linux target, where the
+ * FreeRTOS simulator runs one task at a time, they are a pool of threads.
+ *
+ * Buffers under 2 * MIN_SAMPLES_PER_WORKER samples are summed by the
+ * caller directly: waking the workers would cost more than it saves.
+ * reduce() may only be called by one task at a time.
+ *
+ * On the chips, if the semaphore or a worker task can't be created, the
+ * workers already running are stopped in the constructor and reduce()
+ * returns ESP_ERR_NO_MEM.
+ */
+class ParallelSum
+{
+public:
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr size_t MAX_WORKERS = 16;
+    static constexpr size_t MIN_SAMPLES_PER_WORKER = 4096;
+
+    // workers = 0 uses every core (the number of CPUs on the chip, the
+    // hardware threads on the host). The count is capped by what exists.
+    explicit ParallelSum(size_t workers = 0);
+    ~ParallelSum();
+
+    ParallelSum(const ParallelSum &) = delete;
+    ParallelSum &operator=(const ParallelSum &) = delete;
+
+    esp_err_t reduce(const int16_t *samples, size_t count, const SumStreamBounds &bounds, int64_t &result);
+
+    size_t workers() const { return workers_; }
+
+private:
+    // One per worker, alone in its cache line so workers never share one
+    struct alignas(CACHE_LINE) Partial
+    {
+        int64_t sum;
+        bool invalid;
+    };
+    static_assert(sizeof(Partial) == CACHE_LINE, "Partial must fill exactly one cache line");
+
+    void run_slice(size_t worker);
+    static Partial sum_range(const int16_t *samples, size_t begin, size_t end, const SumStreamBounds &bounds);
+
+    size_t workers_;
+    Partial partials_[MAX_WORKERS];
+
+    // Current job, written by reduce() before the workers are woken
+    const int16_t *samples_;
+    size_t count_;
+    SumStreamBounds bounds_;
+    std::atomic<bool> stop_;
+    esp_err_t init_err_; // result of creating the workers in the constructor
+
+#if CONFIG_IDF_TARGET_LINUX
+    void thread_main(size_t worker);
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_;
+    size_t pending_;
+#else
+    struct Worker
+    {
+        ParallelSum *self;
+        size_t index;
+    };
+    static void task_main(void *arg);
+    // Stops the workers_ tasks created and frees done_. Safe to call twice.
+    void stop_workers();
+
+    Worker worker_args_[portNUM_PROCESSORS];
+    TaskHandle_t tasks_[portNUM_PROCESSORS];
+    SemaphoreHandle_t done_;
+#endif
+};
@@ -0,0 +1,145 @@
+// result_fanout.hpp
+#pragma once
+
+#include <stdint.h>
+#include <tuple>
+
+#include "esp_err.h"
+
+/**
+ * @brief One compute() result, as SumBoss publishes it.
+ */
+struct SumResult
+{
+    int a;
+    int b;
+    int result;       // Only meaningful when err is ESP_OK
+    esp_err_t err;    // The error of the sum, not of the LEDs
+    bool led_changed; // The LED call that showed it succeeded
+};
+
+/**
+ * @brief Result classes, as bits, for the masks of ResultRoute.
+ *
+ * Same split as LedPatterns::for_result: ESP_FAIL is an out-of-range
+ * sum, ESP_ERR_INVALID_ARG a negative operand.
+ */
+struct ResultMask
+{
+    static constexpr uint32_t NONE = 0;
+    static constexpr uint32_t OK = 1u << 0;
+    static constexpr uint32_t OUT_OF_RANGE = 1u << 1;
+    static constexpr uint32_t INVALID_ARG = 1u << 2;
+    static constexpr uint32_t OTHER_ERROR = 1u << 3;
+    static constexpr uint32_t ERRORS = OUT_OF_RANGE | INVALID_ARG | OTHER_ERROR;
+    static constexpr uint32_t ALL = OK | ERRORS;
+
+    static constexpr uint32_t of(esp_err_t err)
+    {
+        switch (err) {
+        case ESP_OK:
+            return OK;
+        case ESP_FAIL:
+            return OUT_OF_RANGE;
+        case ESP_ERR_INVALID_ARG:
+            return INVALID_ARG;
+        default:
+            return OTHER_ERROR;
+        }
+    }
+};
+
+/**
+ * @brief What SumBoss::set_observer() takes: anything that wants results.
+ */
+class IResultObserver
+{
+public:
+    virtual ~IResultObserver() = default;
+    virtual void on_result(const SumResult &result) = 0;
+};
+
+/**
+ * @brief One sink of a ResultFanout, and the result classes it gets.
+ *
+ * Sink is any type with a void on_result(const SumResult &) method; it
+ * doesn't derive from anything, so the call is direct and can be inlined.
+ * With Mask == ResultMask::NONE the route is disabled: it keeps no
+ * reference and the fanout compiles it out.
+ */
+template <uint32_t Mask, typename Sink>
+struct ResultRoute
+{
+    static constexpr uint32_t MASK = Mask;
+
+    explicit ResultRoute(Sink &sink)
+        : sink(sink)
+    {
+    }
+
+    Sink &sink;
+};
+
+template <typename Sink>
+struct ResultRoute<ResultMask::NONE, Sink>
+{
+    static constexpr uint32_t MASK = ResultMask::NONE;
+
+    explicit ResultRoute(Sink &) {}
+};
+
+template <uint32_t Mask, typename Sink>
+ResultRoute<Mask, Sink> route(Sink &sink)
+{
+    return ResultRoute<Mask, Sink>(sink);
+}
+
+/**
+ * @brief Publishes each result to a fixed set of sinks, known at compile time.
+ *
+ * The routes are a std::tuple inside the object: no heap, no list to walk,
+ * and no virtual call per sink. SumBoss makes one virtual call, to
+ * on_result(); from there, each route is a mask test and a direct call.
+ * A mask can come from Kconfig, so a sink switched off in menuconfig
+ * costs nothing:
+ *
+ *     ResultFanout fanout(route<ResultMask::ALL>(stats_sink),
+ *                         route<ResultMask::ERRORS>(uart_logger),
+ *                         route<CONFIG_X_DISPLAY ? ResultMask::ALL : ResultMask::NONE>(display));
+ *     sum_boss.set_observer(&fanout);
+ *
+ * The sinks run on the caller of compute(), one after the other, in the
+ * order given, so each must be quick.
+ */
+template <typename... Routes>
+class ResultFanout final : public IResultObserver
+{
+public:
+    explicit ResultFanout(Routes... routes)
+        : routes_(routes...)
+    {
+    }
+
+    void on_result(const SumResult &result) override { publish(result); }
+
+    // Same as on_result, without the virtual call, for code that holds the fanout
+    void publish(const SumResult &result)
+    {
+        const uint32_t mask = ResultMask::of(result.err);
+        std::apply([&](Routes &...each) { (deliver(each, mask, result), ...); }, routes_);
+    }
+
+private:
+    template <typename Route>
+    static void deliver([[maybe_unused]] Route &route, [[maybe_unused]] uint32_t mask,
+                        [[maybe_unused]] const SumResult &result)
+    {
+        if constexpr (Route::MASK != ResultMask::NONE) {
+            if ((Route::MASK & mask) != 0) {
+                route.sink.on_result(result);
+            }
+        }
+    }
+
+    std::tuple<Routes...> routes_;
+};
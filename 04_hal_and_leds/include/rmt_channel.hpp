@@ -0,0 +1,68 @@
+// rmt_channel.hpp
+#pragma once
+
+#include "driver/gpio.h"
+#include "driver/rmt_encoder.h"
+#include "driver/rmt_tx.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "i_dma_tx.hpp"
+
+/**
+ * @brief IDmaTx on the ESP-IDF RMT TX driver, for WS2812 pixels (chip
+ *        targets only).
+ *
+ * One TX channel at RESOLUTION_HZ, with DMA on the chips whose RMT has it
+ * (SOC_RMT_SUPPORT_DMA), and an encoder made of the driver's bytes
+ * encoder, for the WS2812 bits, and its copy encoder, for the reset code
+ * after them, which latches the colors. A frame is 3 bytes per pixel, in
+ * G, R, B order. The encoder reads the frame while it goes out, which is why
+ * the buffer is only handed back by wait_tx(). Up to QUEUE_SIZE transfers
+ * are queued at once.
+ *
+ * A failed setup is kept and returned by queue_tx(), as LedSargent does
+ * with its pins. The linux target has no RMT driver: the host tests use
+ * FakeDmaTx.
+ */
+class RmtChannel : public IDmaTx
+{
+public:
+    static constexpr int QUEUE_SIZE = 2;
+    static constexpr uint32_t RESOLUTION_HZ = 10 * 1000 * 1000; // 0.1 us per tick
+
+    explicit RmtChannel(gpio_num_t pin);
+    ~RmtChannel() override;
+
+    RmtChannel(const RmtChannel &) = delete;
+    RmtChannel &operator=(const RmtChannel &) = delete;
+
+    esp_err_t queue_tx(const uint8_t *data, size_t len) override;
+    esp_err_t wait_tx(const uint8_t **data, uint32_t timeout_ms) override;
+
+private:
+    // The WS2812 encoder: the pixels through bytes, then the reset through copy
+    struct Ws2812Encoder
+    {
+        rmt_encoder_t base; // First: the driver only sees this part
+        rmt_encoder_t *bytes;
+        rmt_encoder_t *copy;
+        int state; // 0 while encoding the pixels, 1 for the reset code
+        rmt_symbol_word_t reset;
+    };
+
+    esp_err_t init_encoder();
+    static size_t encode(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *data, size_t size, rmt_encode_state_t *ret_state);
+    static esp_err_t reset_encoder(rmt_encoder_t *encoder);
+    static esp_err_t del_encoder(rmt_encoder_t *encoder);
+    static bool on_trans_done(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *ctx);
+
+    rmt_channel_handle_t channel_;
+    Ws2812Encoder encoder_;
+    StaticSemaphore_t done_buffer_;
+    SemaphoreHandle_t done_; // Given once per transfer that ended, from the ISR
+    const uint8_t *queued_[QUEUE_SIZE]; // The buffers in flight, oldest at head_
+    int head_;
+    int count_;
+    esp_err_t init_err_; // result of the channel and encoder setup in the constructor
+};
@@ -0,0 +1,65 @@
+// rmt_led_sargent.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "double_buffered_tx.hpp"
+#include "i_dma_tx.hpp"
+#include "i_led_sargent.hpp"
+
+/**
+ * @brief ILedSargent on WS2812 RGB pixels, sent by the RMT peripheral.
+ *
+ * Same contract as LedSargent, on the colors of the pixels: green() and
+ * red() light one color and leave the other alone, off() turns both off.
+ * With both lit the pixels show yellow. Every pixel of the strip shows
+ * the same color, at the brightness set with set_brightness().
+ *
+ * Every change builds a frame, 3 bytes per pixel in G, R, B order, and
+ * sends it through a DoubleBufferedTx on the RMT channel, then returns:
+ * the peripheral times the bits out.
+ *
+ * The constructor turns every pixel off. If that fails, or if the strip
+ * is empty or longer than MAX_PIXELS, every method returns the error.
+ */
+class RmtLedSargent : public ILedSargent
+{
+public:
+    static constexpr size_t MAX_PIXELS = 64;
+    static constexpr size_t BYTES_PER_PIXEL = 3;      // G, R, B: the WS2812 order
+    static constexpr uint32_t WAIT_MS = 10;           // 64 pixels go out in about 2 ms
+    static constexpr uint8_t DEFAULT_BRIGHTNESS = 10; // percent: a WS2812 at full dazzles
+
+    enum Led
+    {
+        GREEN,
+        RED,
+    };
+
+    // rmt is the channel of the strip, RmtChannel on the chips
+    explicit RmtLedSargent(IDmaTx &rmt, size_t pixels = 1);
+
+    esp_err_t green() override;
+    esp_err_t red() override;
+    esp_err_t off() override;
+
+    // 0 to 100%, for the colors lit from now on and for those already lit.
+    // ESP_ERR_INVALID_ARG above 100.
+    esp_err_t set_brightness(uint8_t percent);
+
+    size_t pixels() const { return pixels_; }
+
+    // Color level for a brightness, rounded to the nearest step
+    static uint8_t level_for(uint8_t percent) { return static_cast<uint8_t>((percent * 255 + 50) / 100); }
+
+private:
+    esp_err_t show(bool green, bool red);
+    esp_err_t push();
+
+    size_t pixels_;
+    uint8_t level_; // Of a lit color, from set_brightness()
+    bool lit_[2];   // Indexed by Led
+    DoubleBufferedTx<MAX_PIXELS * BYTES_PER_PIXEL> frames_; // Its destructor waits for the frames in flight
+    esp_err_t init_err_; // result of the setup in the constructor
+};
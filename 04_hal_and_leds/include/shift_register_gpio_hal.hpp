@@ -0,0 +1,62 @@
+// shift_register_gpio_hal.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "double_buffered_tx.hpp"
+#include "i_dma_tx.hpp"
+#include "i_gpio_hal.hpp"
+
+/**
+ * @brief IGpioHal on a chain of 74HC595 shift registers, fed over SPI.
+ *
+ * The "pins" are the outputs of the chain: pin N is output Q(N % 8) of
+ * the (N / 8)th register, counted from the one wired to the MCU. So
+ * LedSargent, LedBank or anything else written for IGpioHal drives 8 LEDs
+ * per register, with three MCU pins for the whole panel.
+ *
+ * The outputs are kept in a CPU-side state. Every write updates it and
+ * sends it as one frame through a DoubleBufferedTx on the SPI device,
+ * then returns: the SPI DMA clocks the bits out, and a write only waits
+ * when both frames are still in flight, for no more than WAIT_MS.
+ * port_set_levels() changes any number of outputs in one frame.
+ *
+ * The frames live inside the object, which must then sit in DMA-capable
+ * memory (internal RAM, not PSRAM). All outputs are cleared in the
+ * constructor. Interrupts and inputs don't exist on a 74HC595:
+ * pin_get_level returns the state last written.
+ */
+class ShiftRegisterGpioHal : public IGpioHal
+{
+public:
+    static constexpr size_t MAX_REGISTERS = 8; // 64 outputs, what a port mask reaches
+    static constexpr uint32_t WAIT_MS = 10;    // A 64-bit frame takes a few microseconds
+
+    // spi is the SPI device of the chain, SpiDevice on the chips
+    ShiftRegisterGpioHal(IDmaTx &spi, size_t registers);
+
+    ShiftRegisterGpioHal(const ShiftRegisterGpioHal &) = delete;
+    ShiftRegisterGpioHal &operator=(const ShiftRegisterGpioHal &) = delete;
+
+    // Only checks the pin and the mode: every output of a 74HC595 is an
+    // output, so a mode without the output bit is ESP_ERR_NOT_SUPPORTED
+    esp_err_t pin_set_direction(gpio_num_t pin, gpio_mode_t mode) override;
+    esp_err_t pin_set_level(gpio_num_t pin, uint32_t level) override;
+    int pin_get_level(gpio_num_t pin) override;
+    esp_err_t pin_set_intr(gpio_num_t, gpio_int_type_t, gpio_isr_t, void *) override { return ESP_ERR_NOT_SUPPORTED; }
+    esp_err_t pin_remove_intr(gpio_num_t) override { return ESP_ERR_NOT_SUPPORTED; }
+    // One frame, whatever the number of outputs changed
+    esp_err_t port_set_levels(uint64_t set_mask, uint64_t clear_mask) override;
+
+    size_t outputs() const { return registers_ * 8; }
+
+private:
+    bool valid(gpio_num_t pin) const { return pin >= 0 && static_cast<size_t>(pin) < outputs(); }
+    esp_err_t push();
+
+    size_t registers_;
+    uint8_t state_[MAX_REGISTERS]; // state_[r] bit q is output Q(q) of register r
+    DoubleBufferedTx<MAX_REGISTERS> frames_; // Its destructor waits for the frames in flight
+    esp_err_t init_err_; // result of the setup in the constructor
+};
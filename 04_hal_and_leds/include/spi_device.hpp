@@ -0,0 +1,41 @@
+// spi_device.hpp
+#pragma once
+
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+
+#include "i_dma_tx.hpp"
+
+/**
+ * @brief IDmaTx on the ESP-IDF SPI master driver (chip targets only).
+ *
+ * Initializes the bus with a DMA channel, MOSI and SCLK only, and adds one
+ * device on it in mode 0. The CS line is the device's latch: it rises at
+ * the end of every transfer, which is what a 74HC595 needs on its RCLK
+ * pin. Up to QUEUE_SIZE transfers are queued at once.
+ *
+ * A failed bus or device setup is kept and returned by queue_tx(), as
+ * LedSargent does with its pins. The linux target has no SPI driver: the
+ * host tests use FakeDmaTx.
+ */
+class SpiDevice : public IDmaTx
+{
+public:
+    static constexpr int QUEUE_SIZE = 2;
+
+    SpiDevice(spi_host_device_t host, gpio_num_t mosi, gpio_num_t sclk, gpio_num_t latch, int clock_hz);
+    ~SpiDevice() override;
+
+    SpiDevice(const SpiDevice &) = delete;
+    SpiDevice &operator=(const SpiDevice &) = delete;
+
+    esp_err_t queue_tx(const uint8_t *data, size_t len) override;
+    esp_err_t wait_tx(const uint8_t **data, uint32_t timeout_ms) override;
+
+private:
+    spi_host_device_t host_;
+    spi_device_handle_t device_;
+    spi_transaction_t transactions_[QUEUE_SIZE]; // Owned by the driver while queued
+    int next_;
+    esp_err_t init_err_; // result of the bus and device setup in the constructor
+};
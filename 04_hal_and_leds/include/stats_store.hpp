@@ -0,0 +1,129 @@
+// stats_store.hpp
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "nvs.h"
+
+/**
+ * @brief SumBoss counters, as stored in NVS.
+ */
+struct SumStats
+{
+    uint32_t successes;    // Sum returned ESP_OK
+    uint32_t out_of_range; // Sum returned ESP_FAIL
+    uint32_t invalid_args; // Sum returned ESP_ERR_INVALID_ARG
+    uint32_t other_errors; // Any other Sum error
+    uint32_t led_errors;   // The green() or red() call failed
+};
+
+/**
+ * @brief When StatsStore writes to flash.
+ *
+ * A commit happens once commit_every records are pending, or once
+ * commit_interval_us have passed since the last commit with anything
+ * pending, whichever comes first. 0 disables that trigger. With neither,
+ * only flush() and the shutdown hook write.
+ */
+struct StatsStoreConfig
+{
+    const char *nvs_namespace;  // At most 15 characters
+    const char *key;            // At most 15 characters
+    uint32_t commit_every;      // Pending records that trigger a commit
+    int64_t commit_interval_us; // Time since the last commit that triggers one
+    int64_t (*now_us)();        // Time source (esp_timer_get_time on target)
+};
+
+/**
+ * @brief SumStats that survive a reboot, written to NVS in batches.
+ *
+ * record() only touches RAM: a few relaxed atomic increments, safe from
+ * any task or ISR. The counters reach flash in commit_if_due(), flush()
+ * or the shutdown hook, each commit as one blob write of the whole
+ * SumStats, so a batch of records costs the same flash wear as a single
+ * one. A commit with nothing pending writes nothing.
+ *
+ * The constructor opens the namespace and loads the last committed
+ * counters. Like LedSargent, it remembers the first error, and every
+ * method that touches NVS returns it. record() keeps counting in RAM
+ * either way. A blob written by another layout of SumStats is ignored and
+ * the counters start from zero.
+ *
+ * nvs_flash_init() must have been called before the constructor.
+ */
+class StatsStore
+{
+public:
+    // Bumped when SumStats changes
+    static constexpr uint32_t LAYOUT_VERSION = 1;
+
+    explicit StatsStore(const StatsStoreConfig &config);
+    // Flushes, then closes the handle
+    ~StatsStore();
+
+    StatsStore(const StatsStore &) = delete;
+    StatsStore &operator=(const StatsStore &) = delete;
+
+    // Counts one compute: what Sum returned, and whether the LED call worked
+    void record(esp_err_t sum_err, bool led_ok)
+    {
+        std::atomic<uint32_t> &counter = sum_err == ESP_OK                ? successes_
+                                         : sum_err == ESP_FAIL            ? out_of_range_
+                                         : sum_err == ESP_ERR_INVALID_ARG ? invalid_args_
+                                                                          : other_errors_;
+        counter.fetch_add(1, std::memory_order_relaxed);
+        if (!led_ok) {
+            led_errors_.fetch_add(1, std::memory_order_relaxed);
+        }
+        pending_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Commits if a threshold was reached. Task context only. If another
+    // task is committing at the same moment, returns ESP_OK without waiting.
+    esp_err_t commit_if_due();
+
+    // Commits whatever is pending. Task context only. Blocks while another
+    // task is committing, then commits what is left.
+    esp_err_t flush();
+
+    // Flushes this store from esp_restart() (atexit() on the linux target).
+    // One store at a time: the last one installed wins, and destroying it
+    // uninstalls it.
+    esp_err_t install_shutdown_hook();
+
+    // Committed counters plus the ones still in RAM
+    SumStats totals() const;
+
+    // Records not committed yet
+    uint32_t pending() const { return pending_.load(std::memory_order_relaxed); }
+
+    // Blob writes since construction
+    uint32_t commits() const { return commits_.load(std::memory_order_relaxed); }
+
+    // The shutdown handler itself, public so the tests can play a restart
+    static void on_shutdown();
+
+private:
+    esp_err_t load();
+    esp_err_t commit(bool force);
+
+    static StatsStore *hooked_;
+
+    StatsStoreConfig config_;
+    nvs_handle_t handle_;
+    esp_err_t init_err_;
+
+    std::atomic<uint32_t> successes_{0};
+    std::atomic<uint32_t> out_of_range_{0};
+    std::atomic<uint32_t> invalid_args_{0};
+    std::atomic<uint32_t> other_errors_{0};
+    std::atomic<uint32_t> led_errors_{0};
+    std::atomic<uint32_t> pending_{0};
+
+    std::mutex committing_;  // Held by the task writing the blob
+    int64_t last_commit_us_; // Only touched while holding committing_
+    std::atomic<uint32_t> commits_{0};
+};
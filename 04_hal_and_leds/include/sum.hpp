@@ -9,4 +9,5 @@ public:
     int add(int a, int b) override;
     int add_constrained(int a, int b) override;
     esp_err_t add_constrained_err(int a, int b, int &result) override;
+    esp_err_t add_constrained_err_isr(int a, int b, int &result) override;
 };
\ No newline at end of file
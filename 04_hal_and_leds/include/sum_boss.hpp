@@ -1,7 +1,15 @@
 #pragma once
 
+#include <stdint.h>
+
+#include "compute_request.hpp"
 #include "i_led_sargent.hpp"
 #include "i_sum.hpp"
+#include "latency_histogram.hpp"
+
+class IResultObserver;
+class LedSequencer;
+class StatsStore;
 
 class SumBoss
 {
@@ -11,7 +19,52 @@ public:
 
     esp_err_t compute(int a, int b, int &result);
 
+    // Same as compute, but with no logging anywhere on the path.
+    // Call it from an ISR only with an ISR-safe IGpioHal (e.g. LlGpioHal)
+    // and, for IRAM-safe interrupts, CONFIG_HAL_AND_LEDS_COMPUTE_IN_IRAM.
+    esp_err_t compute_isr(int a, int b, int &result);
+
+    // compute() for a queued request: fills request.result and request.err,
+    // then calls request.on_done, if set. Returns request.err.
+    esp_err_t process(ComputeRequest &request);
+
+    // Records, for every compute, the time from the request until the LED
+    // call returned successfully. now() can be any monotonic clock that's
+    // safe on the compute path (esp_timer_get_time, a cycle counter...);
+    // the histogram stores the difference truncated to 32 bits, so a
+    // wrapping 32-bit counter works too. Pass nullptr to stop recording.
+    void set_latency_histogram(LatencyHistogram *histogram, int64_t (*now)());
+
+    // Counts every compute into stats. compute() also lets the store commit
+    // to NVS when a threshold is reached; compute_isr() only counts, and a
+    // task must call stats->commit_if_due() for those to reach flash. A
+    // failed commit is retried on the next one and doesn't change what
+    // compute() returns. Pass nullptr to stop counting.
+    void set_stats(StatsStore *stats);
+
+    // Shows compute() results as blink codes (LedPatterns::for_result)
+    // played by sequencer, instead of a steady LED. compute() returns the
+    // error of play() when the sum succeeded, like it returns the error of
+    // green(). compute_isr() keeps the steady LEDs: play() takes a mutex.
+    // Pass nullptr to go back to steady LEDs.
+    void set_sequencer(LedSequencer *sequencer);
+
+    // Publishes every compute() result to observer, after the LEDs and the
+    // stats. Give it a ResultFanout to reach several sinks for one virtual
+    // call. compute_isr() doesn't publish: the sinks may log or block.
+    // Pass nullptr to stop publishing.
+    void set_observer(IResultObserver *observer);
+
 private:
+    esp_err_t show_result(esp_err_t ret, bool use_sequencer, bool &led_changed);
+    int64_t latency_start();
+    void latency_end(int64_t start, bool led_changed);
+
     ISum &sum_;
     ILedSargent &led_sargent_;
+    LatencyHistogram *latency_;
+    int64_t (*now_)();
+    StatsStore *stats_;
+    LedSequencer *sequencer_;
+    IResultObserver *observer_;
 };
\ No newline at end of file
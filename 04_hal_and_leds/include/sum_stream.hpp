@@ -0,0 +1,68 @@
+// sum_stream.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+/**
+ * @brief Bounds for SumStream, the streaming version of add_constrained's rule.
+ *
+ * Sum's own rule, applied to a stream, is {0, 10, 0, 10}. sum_min/sum_max
+ * must leave room for 4 int16 samples before int32 overflows (|bound| <=
+ * INT32_MAX - 4 * 32768).
+ */
+struct SumStreamBounds
+{
+    int32_t sample_min; // Each sample must be in [sample_min, sample_max]
+    int32_t sample_max;
+    int32_t sum_min;    // The running sum must stay in [sum_min, sum_max]
+    int32_t sum_max;
+};
+
+/**
+ * @brief Running constrained sum over chunks of samples.
+ *
+ * feed() takes one chunk at a time — a DMA buffer, or one half of a ring
+ * buffer — and writes the running sum after each sample. The running sum
+ * carries over from one call to the next, so the chunks don't need to be
+ * copied together first.
+ *
+ * The errors follow add_constrained_err: a sample out of range is
+ * ESP_ERR_INVALID_ARG, a running sum out of range is ESP_FAIL. The first
+ * violation stops the stream; it stays stopped (feed() keeps returning the
+ * same error) until reset().
+ *
+ * The kernel works on 4 samples at a time with GCC vector extensions:
+ * SSE/NEON on the host, plain scalar code once lowered for Xtensa/RISC-V.
+ */
+class SumStream
+{
+public:
+    static constexpr uint64_t NO_VIOLATION = UINT64_MAX;
+
+    explicit SumStream(const SumStreamBounds &bounds);
+
+    // Adds count samples to the running sum. prefix[i] receives the running
+    // sum after samples[i]. On error, accepted tells how many samples went
+    // in (and how many prefix entries were written) before the violation.
+    esp_err_t feed(const int16_t *samples, size_t count, int32_t *prefix, size_t &accepted);
+
+    // Back to an empty stream, keeping the bounds
+    void reset();
+
+    int32_t total() const { return total_; }
+    uint64_t position() const { return position_; }
+
+    // Stream index of the first violating sample, or NO_VIOLATION
+    uint64_t violation_index() const { return violation_index_; }
+    esp_err_t status() const { return status_; }
+
+private:
+    SumStreamBounds bounds_;
+    int32_t total_;
+    uint64_t position_;
+    uint64_t violation_index_;
+    esp_err_t status_;
+};
@@ -0,0 +1,132 @@
+// trace_replay.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#include "batch_protocol.hpp"
+#include "sum_boss.hpp"
+
+/**
+ * @brief Header of a trace or results file (linux target only).
+ *
+ * Both files are this header followed by count records of record_size
+ * bytes, little-endian: BatchPair in a trace, BatchReply in a results
+ * file, the same records the batch protocol carries. The header is 24
+ * bytes, so the records start 8-byte aligned in the mapping.
+ */
+struct TraceHeader
+{
+    static constexpr char TRACE_MAGIC[8] = "SBTRACE";
+    static constexpr char RESULTS_MAGIC[8] = "SBRESLT";
+    static constexpr uint32_t VERSION = 1;
+
+    char magic[8];        // TRACE_MAGIC or RESULTS_MAGIC, NUL-padded
+    uint32_t version;     // VERSION
+    uint32_t record_size; // sizeof(BatchPair) or sizeof(BatchReply)
+    uint64_t count;
+};
+
+/**
+ * @brief A trace file mapped read-only.
+ *
+ * open() checks the header and that the file really holds count records.
+ * The records are then read straight from the page cache: no read() per
+ * record, no copy. The kernel is told the access is sequential, so it
+ * reads ahead and drops pages behind.
+ */
+class MappedTrace
+{
+public:
+    MappedTrace();
+    ~MappedTrace();
+
+    MappedTrace(const MappedTrace &) = delete;
+    MappedTrace &operator=(const MappedTrace &) = delete;
+
+    // ESP_ERR_NOT_FOUND if the file can't be opened, ESP_ERR_INVALID_ARG
+    // if it isn't a trace, ESP_ERR_INVALID_VERSION for another version,
+    // ESP_ERR_INVALID_SIZE if it's shorter than its header says.
+    esp_err_t open(const char *path);
+    void close();
+
+    const BatchPair *records() const { return records_; }
+    size_t count() const { return count_; }
+
+private:
+    void *map_;
+    size_t map_size_;
+    const BatchPair *records_;
+    size_t count_;
+};
+
+/**
+ * @brief A results file, created at its final size and mapped read-write.
+ *
+ * The replay writes each reply into the mapping, and the kernel writes the
+ * pages back on its own. close() flushes them with msync.
+ */
+class MappedResults
+{
+public:
+    MappedResults();
+    ~MappedResults();
+
+    MappedResults(const MappedResults &) = delete;
+    MappedResults &operator=(const MappedResults &) = delete;
+
+    // Creates or truncates path, for count replies. ESP_FAIL if the file
+    // can't be created, sized or mapped.
+    esp_err_t create(const char *path, size_t count);
+    esp_err_t close();
+
+    BatchReply *records() { return records_; }
+    size_t count() const { return count_; }
+
+private:
+    void *map_;
+    size_t map_size_;
+    BatchReply *records_;
+    size_t count_;
+};
+
+/**
+ * @brief How a replay went.
+ */
+struct ReplayReport
+{
+    uint64_t records;
+    uint64_t successes;    // ESP_OK
+    uint64_t out_of_range; // ESP_FAIL
+    uint64_t invalid_args; // ESP_ERR_INVALID_ARG
+    uint64_t other_errors; // Anything else, a failed green() included
+    double seconds;        // Time spent in the replay loop
+};
+
+/**
+ * @brief Runs every record of a trace through SumBoss.
+ *
+ * The loop does nothing but compute, count the returned error and, if
+ * there is an output, store the reply: the trace and the results are
+ * both mapped, so no I/O call is made per record.
+ */
+class TraceReplay
+{
+public:
+    enum Path
+    {
+        COMPUTE,     // SumBoss::compute, as a task calls it
+        COMPUTE_ISR, // SumBoss::compute_isr, the path without logging
+    };
+
+    TraceReplay(SumBoss &boss, Path path);
+
+    // out may be nullptr. Otherwise it must hold count replies.
+    void run(const BatchPair *records, size_t count, BatchReply *out, ReplayReport &report);
+
+private:
+    SumBoss &boss_;
+    Path path_;
+};
@@ -0,0 +1,34 @@
+// uart_stream.hpp
+#pragma once
+
+#include "driver/uart.h"
+#include "esp_err.h"
+
+#include "i_byte_stream.hpp"
+
+/**
+ * @brief IByteStream over a UART (chips only).
+ *
+ * Installs the UART driver with an RX ring of RX_BUFFER_SIZE bytes and no
+ * TX ring, so write() returns once the bytes are in the hardware FIFO.
+ * The pins are left as they are: on UART0, the console pins.
+ */
+class UartStream : public IByteStream
+{
+public:
+    static constexpr int RX_BUFFER_SIZE = 4096;
+
+    UartStream(uart_port_t port, int baud_rate);
+    ~UartStream();
+
+    UartStream(const UartStream &) = delete;
+    UartStream &operator=(const UartStream &) = delete;
+
+    int read(uint8_t *data, size_t length, uint32_t timeout_ms) override;
+    int write(const uint8_t *data, size_t length) override;
+
+private:
+    uart_port_t port_;
+    bool installed_; // By this object, so the destructor removes it
+    esp_err_t init_err_;
+};
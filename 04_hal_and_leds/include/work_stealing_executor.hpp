@@ -0,0 +1,115 @@
+// work_stealing_executor.hpp
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#include "esp_err.h"
+
+#include "chase_lev_deque.hpp"
+#include "sum_boss.hpp"
+
+/**
+ * @brief One SumBoss::compute call, for WorkStealingExecutor::compute().
+ */
+struct ComputeJob
+{
+    int a;
+    int b;
+    int result;
+    esp_err_t err;
+};
+
+/**
+ * @brief Work-stealing thread pool for batches of small jobs (linux target only).
+ *
+ * A batch is a job function plus a count: job(ctx, i) is called once for
+ * every i in [0, count). The indices are dealt to per-worker Chase-Lev
+ * deques before the workers are woken. Each worker drains its own deque
+ * from the bottom, then steals from the top of the others until every
+ * deque is empty, so a worker that got slow jobs doesn't hold up the
+ * batch while the rest sit idle.
+ *
+ * run() blocks until the whole batch is done and may only be called by
+ * one thread at a time. If jobs throw, the rest of the batch still runs,
+ * and the first exception is rethrown from run(); the pool stays usable.
+ *
+ * This executor exists for the host, where the FreeRTOS simulator runs
+ * one task at a time. On the chips, see ParallelSum.
+ */
+class WorkStealingExecutor
+{
+public:
+    static constexpr size_t MAX_WORKERS = 16;
+    // Per worker. Bigger batches are run in rounds.
+    static constexpr size_t DEQUE_CAPACITY = 1024;
+
+    using Job = void (*)(void *ctx, size_t index);
+
+    enum class Placement
+    {
+        Spread,      // Contiguous slices, one per worker
+        FirstWorker, // Everything on worker 0, the others only get work by stealing
+    };
+
+    // workers = 0 uses every hardware thread. The count is capped at MAX_WORKERS.
+    explicit WorkStealingExecutor(size_t workers = 0);
+    ~WorkStealingExecutor();
+
+    WorkStealingExecutor(const WorkStealingExecutor &) = delete;
+    WorkStealingExecutor &operator=(const WorkStealingExecutor &) = delete;
+
+    // ESP_ERR_INVALID_ARG if job is null, ESP_ERR_INVALID_STATE after shutdown()
+    esp_err_t run(Job job, void *ctx, size_t count, Placement placement = Placement::Spread);
+
+    // Runs boss.compute() for every job and stores result and err in it.
+    // boss's ISum and ILedSargent must be thread-safe (Sum and AtomicLedSink are).
+    esp_err_t compute(SumBoss &boss, ComputeJob *jobs, size_t count);
+
+    // Stops and joins the workers. Idempotent, also called by the destructor.
+    void shutdown();
+
+    size_t workers() const { return workers_; }
+
+    // Jobs taken from another worker's deque, since construction
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    using Deque = ChaseLevDeque<size_t, DEQUE_CAPACITY>;
+
+    struct alignas(64) Worker
+    {
+        Deque deque;
+        std::thread thread;
+    };
+
+    void thread_main(size_t worker);
+    bool take(size_t worker, size_t &index);
+    void execute(size_t index);
+    size_t deal(size_t first, size_t count, Placement placement);
+
+    size_t workers_;
+    std::unique_ptr<Worker[]> pool_;
+
+    // Current round, written by run() while the workers are parked
+    Job job_;
+    void *ctx_;
+    std::exception_ptr error_;
+    std::mutex error_mutex_;
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_;
+    size_t active_;
+    bool stop_;
+
+    std::atomic<uint64_t> steals_;
+};
@@ -0,0 +1,142 @@
+// batch_protocol.cpp
+
+#include <string.h>
+
+#include "esp_rom_crc.h"
+
+#include "batch_protocol.hpp"
+
+size_t BatchProtocol::seal(uint8_t type, uint8_t seq, size_t count, uint8_t *frame)
+{
+    if (count > MAX_BATCH) {
+        return 0;
+    }
+    frame[0] = MAGIC_0;
+    frame[1] = MAGIC_1;
+    frame[2] = type;
+    frame[3] = seq;
+    frame[4] = static_cast<uint8_t>(count);
+    frame[5] = static_cast<uint8_t>(count >> 8);
+    frame[6] = 0;
+    frame[7] = 0;
+
+    size_t crc_offset = HEADER_SIZE + count * RECORD_SIZE;
+    uint32_t crc = esp_rom_crc32_le(0, frame, crc_offset);
+    memcpy(frame + crc_offset, &crc, sizeof(crc));
+    return crc_offset + CRC_SIZE;
+}
+
+size_t BatchProtocol::encode_request(uint8_t seq, const BatchPair *pairs, size_t count, uint8_t *out)
+{
+    if (count > MAX_BATCH) {
+        return 0;
+    }
+    if (count != 0) {
+        memcpy(out + HEADER_SIZE, pairs, count * sizeof(BatchPair));
+    }
+    return seal(REQUEST, seq, count, out);
+}
+
+size_t BatchProtocol::encode_reply(uint8_t seq, const BatchReply *replies, size_t count, uint8_t *out)
+{
+    if (count > MAX_BATCH) {
+        return 0;
+    }
+    if (count != 0) {
+        memcpy(out + HEADER_SIZE, replies, count * sizeof(BatchReply));
+    }
+    return seal(REPLY, seq, count, out);
+}
+
+// ------------------------------------------------------------------
+// ByteRing
+// ------------------------------------------------------------------
+
+size_t ByteRing::write(const uint8_t *data, size_t length)
+{
+    size_t written = 0;
+    while (written < length && space() != 0) {
+        size_t span;
+        uint8_t *dest = free_span(span);
+        size_t chunk = (length - written < span) ? length - written : span;
+        memcpy(dest, data + written, chunk);
+        produce(chunk);
+        written += chunk;
+    }
+    return written;
+}
+
+void ByteRing::copy_out(size_t offset, void *out, size_t length) const
+{
+    size_t start = (tail_ + offset) % SIZE;
+    size_t first = (length < SIZE - start) ? length : SIZE - start;
+    memcpy(out, &data_[start], first);
+    memcpy(static_cast<uint8_t *>(out) + first, &data_[0], length - first);
+}
+
+uint32_t ByteRing::crc32(size_t offset, size_t length) const
+{
+    // At most two pieces: up to the end of the storage, then from its start
+    size_t start = (tail_ + offset) % SIZE;
+    size_t first = (length < SIZE - start) ? length : SIZE - start;
+    uint32_t crc = esp_rom_crc32_le(0, &data_[start], first);
+    if (length > first) {
+        crc = esp_rom_crc32_le(crc, &data_[0], length - first);
+    }
+    return crc;
+}
+
+// ------------------------------------------------------------------
+// BatchParser
+// ------------------------------------------------------------------
+
+bool BatchParser::next(ByteRing &ring, BatchFrame &frame)
+{
+    while (true) {
+        // Sync on the magic
+        if (ring.size() >= 1 && ring.at(0) != BatchProtocol::MAGIC_0) {
+            ring.consume(1);
+            skipped_++;
+            continue;
+        }
+        if (ring.size() >= 2 && ring.at(1) != BatchProtocol::MAGIC_1) {
+            ring.consume(1);
+            skipped_++;
+            continue;
+        }
+        if (ring.size() < BatchProtocol::HEADER_SIZE) {
+            return false;
+        }
+
+        // A header that can't be right means the magic was a data byte
+        uint8_t type = ring.at(2);
+        uint16_t count = static_cast<uint16_t>(ring.at(4) | (ring.at(5) << 8));
+        bool header_ok = (type == BatchProtocol::REQUEST || type == BatchProtocol::REPLY) &&
+                         count <= BatchProtocol::MAX_BATCH && ring.at(6) == 0 && ring.at(7) == 0;
+        if (!header_ok) {
+            ring.consume(1);
+            skipped_++;
+            continue;
+        }
+
+        size_t size = BatchProtocol::frame_size(count);
+        if (ring.size() < size) {
+            return false;
+        }
+
+        uint32_t crc;
+        ring.copy_out(size - BatchProtocol::CRC_SIZE, &crc, sizeof(crc));
+        if (crc != ring.crc32(0, size - BatchProtocol::CRC_SIZE)) {
+            ring.consume(1);
+            skipped_++;
+            bad_crc_++;
+            continue;
+        }
+
+        frame.type = type;
+        frame.seq = ring.at(3);
+        frame.count = count;
+        frame.ring = &ring;
+        return true;
+    }
+}
@@ -0,0 +1,59 @@
+// batch_server.cpp
+
+#include "batch_server.hpp"
+
+BatchServer::BatchServer(IByteStream &stream, SumBoss &boss)
+    : stream_(stream)
+    , boss_(boss)
+    , frames_(0)
+    , pairs_(0)
+{
+}
+
+esp_err_t BatchServer::poll(uint32_t timeout_ms)
+{
+    // The parser never leaves a full ring behind: a frame fits in it with
+    // room to spare, and bytes that can't start one are dropped.
+    size_t span;
+    uint8_t *free = ring_.free_span(span);
+    int n = stream_.read(free, span, timeout_ms);
+    if (n < 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (n == 0) {
+        return ESP_ERR_TIMEOUT;
+    }
+    ring_.produce(static_cast<size_t>(n));
+
+    BatchFrame frame;
+    while (parser_.next(ring_, frame)) {
+        esp_err_t ret = ESP_OK;
+        if (frame.type == BatchProtocol::REQUEST) {
+            ret = answer(frame);
+        }
+        ring_.consume(frame.size()); // A stray REPLY is dropped
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t BatchServer::answer(const BatchFrame &request)
+{
+    BatchReply *replies = reinterpret_cast<BatchReply *>(tx_ + BatchProtocol::HEADER_SIZE);
+    for (size_t i = 0; i < request.count; i++) {
+        BatchPair pair = request.pair(i);
+        int result;
+        replies[i].err = boss_.compute(pair.a, pair.b, result);
+        replies[i].result = result;
+    }
+
+    size_t size = BatchProtocol::seal(BatchProtocol::REPLY, request.seq, request.count, tx_);
+    if (stream_.write(tx_, size) != static_cast<int>(size)) {
+        return ESP_FAIL;
+    }
+    frames_++;
+    pairs_ += request.count;
+    return ESP_OK;
+}
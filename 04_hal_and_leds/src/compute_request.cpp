@@ -0,0 +1,13 @@
+// compute_request.cpp
+
+#include "compute_request.hpp"
+
+// At namespace scope, not in the function: a function-local static is
+// built by the first call, behind a guard that takes a lock, which an ISR
+// must not do
+static ComputeRequestPool pool;
+
+ComputeRequestPool &compute_request_pool()
+{
+    return pool;
+}
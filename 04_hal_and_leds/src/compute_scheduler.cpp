@@ -0,0 +1,180 @@
+// compute_scheduler.cpp
+
+#include "compute_scheduler.hpp"
+
+#include <stdlib.h>
+
+CoroutineFramePool &coroutine_frame_pool()
+{
+    static CoroutineFramePool pool;
+    return pool;
+}
+
+// ---------------------------------------------------------------
+// ComputeTask
+// ---------------------------------------------------------------
+
+void *ComputeTask::promise_type::operator new(size_t size) noexcept
+{
+    if (size > sizeof(CoroutineFrame)) {
+        return nullptr; // get_return_object_on_allocation_failure
+    }
+    return coroutine_frame_pool().allocate();
+}
+
+void ComputeTask::promise_type::operator delete(void *frame) noexcept
+{
+    coroutine_frame_pool().deallocate(frame);
+}
+
+void ComputeTask::promise_type::unhandled_exception()
+{
+    abort(); // Nothing is left to resume the coroutine that threw
+}
+
+ComputeTask::ComputeTask(ComputeTask &&other) noexcept
+    : handle_(other.handle_)
+{
+    other.handle_ = nullptr;
+}
+
+ComputeTask &ComputeTask::operator=(ComputeTask &&other) noexcept
+{
+    if (this != &other) {
+        if (handle_) {
+            handle_.destroy();
+        }
+        handle_ = other.handle_;
+        other.handle_ = nullptr;
+    }
+    return *this;
+}
+
+ComputeTask::~ComputeTask()
+{
+    if (handle_) {
+        handle_.destroy();
+    }
+}
+
+// ---------------------------------------------------------------
+// ComputeScheduler
+// ---------------------------------------------------------------
+
+ComputeScheduler::ComputeAwaiter::ComputeAwaiter(ComputeScheduler &scheduler, int a, int b)
+    : scheduler_(scheduler)
+    , request_{a, b, -1, ESP_OK, nullptr, nullptr}
+{
+}
+
+bool ComputeScheduler::ComputeAwaiter::await_suspend(std::coroutine_handle<> caller) noexcept
+{
+    request_.on_done = on_computed;
+    request_.ctx = caller.address();
+    if (!scheduler_.post({&request_, nullptr})) {
+        request_.err = ESP_ERR_NO_MEM;
+        return false; // Not suspended, the coroutine goes on with the error
+    }
+    return true;
+}
+
+ComputeScheduler::ComputeScheduler(SumBoss &boss)
+    : boss_(boss)
+    , task_(nullptr)
+{
+    queue_ = xQueueCreateStatic(QUEUE_LENGTH, sizeof(Item), queue_storage_, &queue_buffer_);
+    stopped_ = xSemaphoreCreateBinaryStatic(&stopped_buffer_);
+}
+
+ComputeScheduler::~ComputeScheduler()
+{
+    stop();
+    vQueueDelete(queue_);
+    vSemaphoreDelete(stopped_);
+}
+
+esp_err_t ComputeScheduler::start(UBaseType_t priority, uint32_t stack_size)
+{
+    if (task_ != nullptr) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xTaskCreate(task_main, "compute_sched", stack_size, this, priority, &task_) != pdPASS) {
+        task_ = nullptr;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void ComputeScheduler::stop()
+{
+    if (task_ == nullptr) {
+        return;
+    }
+    // The slot kept for it in QUEUE_LENGTH is free unless stop() races itself
+    Item stop_item = {nullptr, nullptr};
+    xQueueSend(queue_, &stop_item, portMAX_DELAY);
+    xSemaphoreTake(stopped_, portMAX_DELAY);
+    task_ = nullptr;
+}
+
+esp_err_t ComputeScheduler::spawn(ComputeTask task)
+{
+    if (!task.valid()) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (!post({nullptr, task.handle_.address()})) {
+        return ESP_ERR_NO_MEM; // task frees the frame on the way out
+    }
+    task.handle_ = nullptr; // The scheduler owns it now
+    return ESP_OK;
+}
+
+size_t ComputeScheduler::run_ready()
+{
+    size_t ran = 0;
+    Item item;
+    while (xQueueReceive(queue_, &item, 0) == pdTRUE) {
+        dispatch(item);
+        ran++;
+    }
+    return ran;
+}
+
+bool ComputeScheduler::post(const Item &item)
+{
+    return xQueueSend(queue_, &item, 0) == pdTRUE;
+}
+
+bool ComputeScheduler::dispatch(const Item &item)
+{
+    if (item.request != nullptr) {
+        boss_.process(*item.request); // on_done resumes the coroutine
+        return true;
+    }
+    if (item.coroutine != nullptr) {
+        std::coroutine_handle<>::from_address(item.coroutine).resume();
+        return true;
+    }
+    return false;
+}
+
+void ComputeScheduler::on_computed(ComputeRequest &, void *ctx)
+{
+    // The request is in the coroutine frame, and process() doesn't touch
+    // it after on_done, so the coroutine may run to its end from here
+    std::coroutine_handle<>::from_address(ctx).resume();
+}
+
+void ComputeScheduler::task_main(void *arg)
+{
+    ComputeScheduler *self = static_cast<ComputeScheduler *>(arg);
+    Item item;
+    while (true) {
+        xQueueReceive(self->queue_, &item, portMAX_DELAY);
+        if (!self->dispatch(item)) {
+            break;
+        }
+    }
+    xSemaphoreGive(self->stopped_);
+    vTaskDelete(NULL);
+}
@@ -0,0 +1,139 @@
+// dedic_gpio_hal.cpp
+
+#include "esp_log.h"
+
+#include "dedic_gpio_hal.hpp"
+
+static const char *TAG = "DEDIC_GPIO_HAL";
+
+DedicGpioHal::DedicGpioHal(const gpio_num_t *pins, size_t count)
+    : DedicGpioHal(pins, count, own_fallback_)
+{
+}
+
+DedicGpioHal::DedicGpioHal(const gpio_num_t *pins, size_t count, IGpioHal &fallback)
+    : fallback_(fallback)
+    , count_(count)
+    , init_err_(ESP_OK)
+{
+    if (count_ > MAX_PINS) {
+        ESP_LOGW(TAG, "Only the first %d of %d pins are mapped", (int)MAX_PINS, (int)count);
+        count_ = MAX_PINS;
+    }
+    for (size_t i = 0; i < count_; i++) {
+        pins_[i] = pins[i];
+    }
+
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    if (count_ > 0) {
+        int gpio_array[MAX_PINS];
+        for (size_t i = 0; i < count_; i++) {
+            gpio_array[i] = pins_[i];
+        }
+
+        dedic_gpio_bundle_config_t config = {};
+        config.gpio_array = gpio_array;
+        config.array_size = count_;
+        config.flags.out_en = 1; // Makes the pads outputs, routed to the bundle
+
+        esp_err_t err = dedic_gpio_new_bundle(&config, &bundle_);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "No dedicated bundle (%s), falling back to GpioHal", esp_err_to_name(err));
+            bundle_ = nullptr;
+        }
+    }
+    if (bundle_ != nullptr) {
+        return;
+    }
+#endif
+
+    // No bundle: the mapped pins are plain outputs of the fallback, set up
+    // here so that pin_set_direction() treats every mapped pin the same way
+    for (size_t i = 0; i < count_; i++) {
+        esp_err_t ret = fallback_.pin_set_direction(pins_[i], GPIO_MODE_OUTPUT);
+        if (ret != ESP_OK && init_err_ == ESP_OK) {
+            init_err_ = ret;
+        }
+    }
+}
+
+DedicGpioHal::~DedicGpioHal()
+{
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    if (bundle_ != nullptr) {
+        dedic_gpio_del_bundle(bundle_);
+    }
+#endif
+}
+
+esp_err_t DedicGpioHal::pin_set_direction(gpio_num_t pin, gpio_mode_t mode)
+{
+    // gpio_set_direction() would reconnect a bundle pin's pad to the plain
+    // GPIO output signal, and the bundle writes would stop reaching it
+    if (pin_mask(pin) != 0) {
+        if (init_err_ != ESP_OK) {
+            return init_err_;
+        }
+        return mode == GPIO_MODE_OUTPUT ? ESP_OK : ESP_ERR_NOT_SUPPORTED;
+    }
+    return fallback_.pin_set_direction(pin, mode);
+}
+
+esp_err_t DedicGpioHal::pin_set_level(gpio_num_t pin, uint32_t level)
+{
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    uint32_t mask = pin_mask(pin);
+    if (bundle_ != nullptr && mask != 0) {
+        dedic_gpio_bundle_write(bundle_, mask, level ? mask : 0);
+        return ESP_OK;
+    }
+#endif
+    return fallback_.pin_set_level(pin, level);
+}
+
+uint32_t DedicGpioHal::pin_mask(gpio_num_t pin) const
+{
+    for (size_t i = 0; i < count_; i++) {
+        if (pins_[i] == pin) {
+            return 1u << i;
+        }
+    }
+    return 0;
+}
+
+esp_err_t DedicGpioHal::write_mask(uint32_t mask, uint32_t value)
+{
+    uint32_t valid = (1u << count_) - 1;
+    if ((mask & ~valid) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    if (bundle_ != nullptr) {
+        dedic_gpio_bundle_write(bundle_, mask, value);
+        return ESP_OK;
+    }
+#endif
+
+    // No bundle: one driver call per selected pin, stop on the first error
+    for (size_t i = 0; i < count_; i++) {
+        uint32_t bit = 1u << i;
+        if ((mask & bit) == 0) {
+            continue;
+        }
+        esp_err_t ret = fallback_.pin_set_level(pins_[i], (value & bit) ? 1 : 0);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+bool DedicGpioHal::has_bundle() const
+{
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    return bundle_ != nullptr;
+#else
+    return false;
+#endif
+}
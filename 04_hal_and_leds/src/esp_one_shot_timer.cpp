@@ -0,0 +1,46 @@
+// esp_one_shot_timer.cpp
+
+#include "esp_one_shot_timer.hpp"
+
+EspOneShotTimer::EspOneShotTimer(const char *name)
+    : name_(name)
+    , timer_(nullptr)
+{
+}
+
+EspOneShotTimer::~EspOneShotTimer()
+{
+    if (timer_ != nullptr) {
+        esp_timer_stop(timer_);
+        esp_timer_delete(timer_);
+    }
+}
+
+esp_err_t EspOneShotTimer::attach(Callback callback, void *arg)
+{
+    if (timer_ != nullptr) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_timer_create_args_t args = {};
+    args.callback = callback;
+    args.arg = arg;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = name_;
+    return esp_timer_create(&args, &timer_);
+}
+
+esp_err_t EspOneShotTimer::start_once(uint64_t timeout_us)
+{
+    if (timer_ == nullptr) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_timer_stop(timer_); // ESP_ERR_INVALID_STATE if it wasn't running, which is fine
+    return esp_timer_start_once(timer_, timeout_us);
+}
+
+void EspOneShotTimer::stop()
+{
+    if (timer_ != nullptr) {
+        esp_timer_stop(timer_);
+    }
+}
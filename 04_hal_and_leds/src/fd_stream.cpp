@@ -0,0 +1,50 @@
+// fd_stream.cpp
+
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "fd_stream.hpp"
+
+FdStream::FdStream(int read_fd, int write_fd)
+    : read_fd_(read_fd)
+    , write_fd_(write_fd)
+{
+}
+
+int FdStream::read(uint8_t *data, size_t length, uint32_t timeout_ms)
+{
+    struct pollfd fd = {read_fd_, POLLIN, 0};
+    int ready;
+    do {
+        ready = poll(&fd, 1, static_cast<int>(timeout_ms));
+    } while (ready < 0 && errno == EINTR);
+    if (ready < 0) {
+        return -1;
+    }
+    if (ready == 0) {
+        return 0;
+    }
+
+    ssize_t n;
+    do {
+        n = ::read(read_fd_, data, length);
+    } while (n < 0 && errno == EINTR);
+    return (n > 0) ? static_cast<int>(n) : -1; // 0 is end of file
+}
+
+int FdStream::write(const uint8_t *data, size_t length)
+{
+    size_t written = 0;
+    while (written < length) {
+        ssize_t n = ::write(write_fd_, data + written, length - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return static_cast<int>(length);
+}
@@ -0,0 +1,96 @@
+// latency_histogram.cpp
+
+#include "latency_histogram.hpp"
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void LatencyHistogram::record(uint32_t value)
+{
+    buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t seen = max_.load(std::memory_order_relaxed);
+    while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (size_t i = 0; i < BUCKETS; i++) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint32_t LatencyHistogram::count() const
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+uint32_t LatencyHistogram::max() const
+{
+    return max_.load(std::memory_order_relaxed);
+}
+
+uint32_t LatencyHistogram::percentile(double percent) const
+{
+    uint32_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    // Rank of the sample we're after, 1-based, rounded up
+    double wanted = percent / 100.0 * total;
+    uint32_t rank = static_cast<uint32_t>(wanted);
+    if (rank < wanted || rank == 0) {
+        rank++;
+    }
+    if (rank > total) {
+        rank = total;
+    }
+
+    uint32_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // Never report more than what was actually recorded
+            uint32_t highest = bucket_highest(i);
+            uint32_t top = max();
+            return highest < top ? highest : top;
+        }
+    }
+    return max();
+}
+
+size_t LatencyHistogram::bucket_index(uint32_t value)
+{
+    // Values up to 2 * SUB_BUCKETS map one to one
+    if (value < 2 * SUB_BUCKETS) {
+        return value;
+    }
+
+    // Above that, the leading SUB_BUCKET_BITS + 1 bits pick the bucket:
+    // the position of the top bit gives the group, the bits right below
+    // it the linear step inside the group.
+    uint32_t msb = 31 - __builtin_clz(value);
+    uint32_t group = msb - SUB_BUCKET_BITS + 1;
+    uint32_t top = value >> (msb - SUB_BUCKET_BITS); // in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+    return group * SUB_BUCKETS + (top - SUB_BUCKETS);
+}
+
+uint32_t LatencyHistogram::bucket_highest(size_t index)
+{
+    if (index < 2 * SUB_BUCKETS) {
+        return static_cast<uint32_t>(index);
+    }
+
+    uint32_t group = static_cast<uint32_t>(index / SUB_BUCKETS);
+    uint32_t sub = static_cast<uint32_t>(index % SUB_BUCKETS);
+    uint32_t shift = group - 1;
+    uint64_t lowest = static_cast<uint64_t>(SUB_BUCKETS + sub) << shift;
+    return static_cast<uint32_t>(lowest + (1ull << shift) - 1);
+}
@@ -7,20 +7,32 @@ LedSargent::LedSargent(IGpioHal &gpio_hal, gpio_num_t green, gpio_num_t red)
     , green_(green)
     , red_(red)
 {
-    gpio_hal_.pin_set_direction(green, GPIO_MODE_OUTPUT);
-    gpio_hal_.pin_set_direction(red, GPIO_MODE_OUTPUT);
+    // Pins are validated here, once. If either setup fails, the methods
+    // below return that error instead of writing to the HAL.
+    esp_err_t ret_green = gpio_hal_.pin_set_direction(green, GPIO_MODE_OUTPUT);
+    esp_err_t ret_red = gpio_hal_.pin_set_direction(red, GPIO_MODE_OUTPUT);
+    init_err_ = (ret_green != ESP_OK) ? ret_green : ret_red;
 }
 
 esp_err_t LedSargent::green()
 {
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
     return gpio_hal_.pin_set_level(green_, 1);
 }
 esp_err_t LedSargent::red()
 {
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
     return gpio_hal_.pin_set_level(red_, 1);
 }
 esp_err_t LedSargent::off()
 {
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
     esp_err_t ret;
     ret = gpio_hal_.pin_set_level(green_, 0);
     if (ret != ESP_OK) {
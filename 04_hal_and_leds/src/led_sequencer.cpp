@@ -0,0 +1,237 @@
+// led_sequencer.cpp
+
+#include "led_sequencer.hpp"
+
+LedSequencer::LedSequencer(ILedSargent &leds, IOneShotTimer &timer, int64_t (*now_us)())
+    : leds_(leds)
+    , timer_(timer)
+    , now_us_(now_us)
+    , slots_()
+    , active_(-1)
+    , deadline_us_(0)
+    , next_order_(0)
+    , shown_(-1)
+    , stopping_(false)
+{
+    init_err_ = timer_.attach(on_timer, this);
+}
+
+LedSequencer::~LedSequencer()
+{
+    // A callback dispatched just before the stop may already be waiting
+    // on the mutex: let it through and wait until it is out
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopping_ = true;
+    timer_.stop();
+    idle_.wait(lock, [this] { return callbacks_.load() == 0; });
+}
+
+esp_err_t LedSequencer::play(const LedPattern &pattern)
+{
+    if (pattern.steps == nullptr || pattern.count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint8_t i = 0; i < pattern.count; i++) {
+        if (pattern.steps[i].ms == 0) {
+            return ESP_ERR_INVALID_ARG; // The timer would never get ahead of it
+        }
+    }
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t now = now_us_();
+
+    // The same pattern restarts in its slot, otherwise a free slot, and
+    // as a last resort the lowest priority one, if lower than this one
+    int slot = -1;
+    int lowest = -1;
+    for (int i = 0; i < static_cast<int>(MAX_PATTERNS); i++) {
+        const LedPattern *p = slots_[i].pattern;
+        if (p == &pattern) {
+            slot = i;
+            break;
+        }
+        if (p == nullptr) {
+            slot = (slot == -1) ? i : slot;
+        }
+        else if (lowest == -1 || p->priority < slots_[lowest].pattern->priority) {
+            lowest = i;
+        }
+    }
+    if (slot == -1) {
+        if (slots_[lowest].pattern->priority >= pattern.priority) {
+            return ESP_ERR_NO_MEM;
+        }
+        slot = lowest;
+    }
+
+    Slot &s = slots_[slot];
+    s.pattern = &pattern;
+    s.step = 0;
+    s.repeats_left = pattern.repeat;
+    s.remaining_us = static_cast<int64_t>(pattern.steps[0].ms) * 1000;
+    s.order = next_order_++;
+    if (active_ == slot) {
+        active_ = -1; // Restarted or replaced: nothing of the old step to keep
+    }
+
+    esp_err_t led_err = ESP_OK;
+    int before = active_;
+    reschedule(now);
+    if (active_ == slot && active_ != before) {
+        led_err = show(pattern.steps[0].color);
+    }
+    esp_err_t timer_err = arm(now);
+    return (led_err != ESP_OK) ? led_err : timer_err;
+}
+
+void LedSequencer::stop(const LedPattern &pattern)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < static_cast<int>(MAX_PATTERNS); i++) {
+        if (slots_[i].pattern == &pattern) {
+            slots_[i].pattern = nullptr;
+            if (active_ == i) {
+                active_ = -1;
+            }
+        }
+    }
+    int64_t now = now_us_();
+    int before = active_;
+    reschedule(now);
+    if (active_ != before && active_ != -1) {
+        const Slot &s = slots_[active_];
+        show(s.pattern->steps[s.step].color);
+    }
+    arm(now);
+}
+
+void LedSequencer::stop_all()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Slot &s : slots_) {
+        s.pattern = nullptr;
+    }
+    active_ = -1;
+    arm(now_us_());
+}
+
+const LedPattern *LedSequencer::showing() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (active_ != -1) ? slots_[active_].pattern : nullptr;
+}
+
+size_t LedSequencer::playing() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const Slot &s : slots_) {
+        count += (s.pattern != nullptr);
+    }
+    return count;
+}
+
+void LedSequencer::on_timer(void *arg)
+{
+    LedSequencer *self = static_cast<LedSequencer *>(arg);
+    self->callbacks_.fetch_add(1);
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    if (!self->stopping_) {
+        int64_t now = self->now_us_();
+        self->advance(now);
+        self->arm(now);
+    }
+    // Still under the mutex, so the destructor can't return before this
+    if (self->callbacks_.fetch_sub(1) == 1 && self->stopping_) {
+        self->idle_.notify_all();
+    }
+}
+
+int LedSequencer::best_slot() const
+{
+    int best = -1;
+    for (int i = 0; i < static_cast<int>(MAX_PATTERNS); i++) {
+        const Slot &s = slots_[i];
+        if (s.pattern == nullptr) {
+            continue;
+        }
+        if (best == -1 || s.pattern->priority > slots_[best].pattern->priority ||
+            (s.pattern->priority == slots_[best].pattern->priority && s.order > slots_[best].order)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void LedSequencer::reschedule(int64_t now)
+{
+    // Pauses the active slot if another one should show, and starts the
+    // clock of the new one on what was left of its step
+    int best = best_slot();
+    if (best == active_) {
+        return;
+    }
+    if (active_ != -1) {
+        int64_t left = deadline_us_ - now;
+        slots_[active_].remaining_us = (left > 0) ? left : 0;
+    }
+    active_ = best;
+    if (active_ != -1) {
+        deadline_us_ = now + slots_[active_].remaining_us;
+    }
+}
+
+void LedSequencer::advance(int64_t now)
+{
+    // Steps are chained on the deadline, not on now, so a late callback
+    // doesn't stretch the pattern
+    while (active_ != -1 && now >= deadline_us_) {
+        Slot &s = slots_[active_];
+        s.step++;
+        if (s.step == s.pattern->count) {
+            s.step = 0;
+            if (s.pattern->repeat != 0 && --s.repeats_left == 0) {
+                s.pattern = nullptr;
+                active_ = -1;
+                reschedule(now);
+                if (active_ != -1) {
+                    const Slot &next = slots_[active_];
+                    show(next.pattern->steps[next.step].color);
+                }
+                continue;
+            }
+        }
+        deadline_us_ += static_cast<int64_t>(s.pattern->steps[s.step].ms) * 1000;
+        show(s.pattern->steps[s.step].color);
+    }
+}
+
+esp_err_t LedSequencer::show(LedStep::Color color)
+{
+    if (shown_ == color) {
+        return ESP_OK;
+    }
+    // LedSargent's green() and red() leave the other LED alone
+    esp_err_t ret = (shown_ == LedStep::OFF) ? ESP_OK : leds_.off();
+    if (ret == ESP_OK && color == LedStep::GREEN) {
+        ret = leds_.green();
+    }
+    else if (ret == ESP_OK && color == LedStep::RED) {
+        ret = leds_.red();
+    }
+    shown_ = (ret == ESP_OK) ? color : -1; // Unknown after a failure: write everything next time
+    return ret;
+}
+
+esp_err_t LedSequencer::arm(int64_t now)
+{
+    if (active_ == -1) {
+        timer_.stop();
+        return show(LedStep::OFF);
+    }
+    int64_t delay = deadline_us_ - now;
+    return timer_.start_once(delay > 0 ? static_cast<uint64_t>(delay) : 0);
+}
@@ -0,0 +1,90 @@
+// ledc_hal.cpp
+
+#include "driver/ledc.h"
+#include "soc/soc_caps.h"
+
+#include "ledc_hal.hpp"
+
+static const ledc_mode_t MODE = LEDC_LOW_SPEED_MODE;
+static const ledc_timer_t TIMER = LEDC_TIMER_0;
+
+// The driver makes any new duty or fade wait for the fade in progress on
+// the channel. Stopping it first, where the chip can, lets the new one
+// take over at once, from the current duty.
+static void stop_fade(ledc_channel_t channel)
+{
+#if SOC_LEDC_SUPPORT_FADE_STOP
+    ledc_fade_stop(MODE, channel); // No fade running is fine: there is nothing to stop
+#else
+    (void)channel; // No ledc_fade_stop(): the next call waits for the fade
+#endif
+}
+
+LedcHal::LedcHal()
+    : fade_installed_(false)
+{
+}
+
+LedcHal::~LedcHal()
+{
+    if (fade_installed_) {
+        ledc_fade_func_uninstall();
+    }
+}
+
+esp_err_t LedcHal::timer_config(uint32_t freq_hz, uint32_t duty_bits)
+{
+    ledc_timer_config_t timer = {};
+    timer.speed_mode = MODE;
+    timer.duty_resolution = static_cast<ledc_timer_bit_t>(duty_bits);
+    timer.timer_num = TIMER;
+    timer.freq_hz = freq_hz;
+    timer.clk_cfg = LEDC_AUTO_CLK;
+    esp_err_t ret = ledc_timer_config(&timer);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // The fade service is shared by the whole app, like the GPIO ISR service
+    if (!fade_installed_) {
+        ret = ledc_fade_func_install(0);
+        if (ret == ESP_OK) {
+            fade_installed_ = true;
+        }
+        else if (ret != ESP_ERR_INVALID_STATE) {
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t LedcHal::channel_config(uint32_t channel, gpio_num_t pin)
+{
+    ledc_channel_config_t config = {};
+    config.gpio_num = pin;
+    config.speed_mode = MODE;
+    config.channel = static_cast<ledc_channel_t>(channel);
+    config.intr_type = LEDC_INTR_DISABLE;
+    config.timer_sel = TIMER;
+    config.duty = 0;
+    config.hpoint = 0;
+    return ledc_channel_config(&config);
+}
+
+esp_err_t LedcHal::set_duty(uint32_t channel, uint32_t duty)
+{
+    stop_fade(static_cast<ledc_channel_t>(channel));
+    return ledc_set_duty_and_update(MODE, static_cast<ledc_channel_t>(channel), duty, 0);
+}
+
+esp_err_t LedcHal::fade_to(uint32_t channel, uint32_t duty, uint32_t time_ms)
+{
+    stop_fade(static_cast<ledc_channel_t>(channel));
+    return ledc_set_fade_time_and_start(MODE, static_cast<ledc_channel_t>(channel), duty, time_ms,
+                                        LEDC_FADE_NO_WAIT);
+}
+
+uint32_t LedcHal::get_duty(uint32_t channel)
+{
+    return ledc_get_duty(MODE, static_cast<ledc_channel_t>(channel));
+}
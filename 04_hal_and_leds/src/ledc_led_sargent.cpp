@@ -0,0 +1,96 @@
+// ledc_led_sargent.cpp
+
+#include "ledc_led_sargent.hpp"
+
+// Indexed by LedcLedSargent::Led
+static const LedcLedSargent::Led LEDS[] = {LedcLedSargent::GREEN, LedcLedSargent::RED};
+static const uint32_t CHANNELS[] = {LedcLedSargent::GREEN_CHANNEL, LedcLedSargent::RED_CHANNEL};
+
+LedcLedSargent::LedcLedSargent(ILedcHal &ledc_hal, gpio_num_t green, gpio_num_t red)
+    : ledc_hal_(ledc_hal)
+    , duty_(MAX_DUTY)
+    , fade_ms_(0)
+    , lit_{false, false}
+{
+    // The timer first, then both channels on it, stopping at the first error
+    init_err_ = ledc_hal_.timer_config(FREQ_HZ, DUTY_BITS);
+    if (init_err_ == ESP_OK) {
+        init_err_ = ledc_hal_.channel_config(GREEN_CHANNEL, green);
+    }
+    if (init_err_ == ESP_OK) {
+        init_err_ = ledc_hal_.channel_config(RED_CHANNEL, red);
+    }
+}
+
+esp_err_t LedcLedSargent::apply(Led led, uint32_t duty, uint32_t time_ms)
+{
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+    if (time_ms == 0) {
+        return ledc_hal_.set_duty(CHANNELS[led], duty);
+    }
+    return ledc_hal_.fade_to(CHANNELS[led], duty, time_ms);
+}
+
+esp_err_t LedcLedSargent::green()
+{
+    esp_err_t ret = apply(GREEN, duty_, fade_ms_);
+    if (ret == ESP_OK) {
+        lit_[GREEN] = true;
+    }
+    return ret;
+}
+esp_err_t LedcLedSargent::red()
+{
+    esp_err_t ret = apply(RED, duty_, fade_ms_);
+    if (ret == ESP_OK) {
+        lit_[RED] = true;
+    }
+    return ret;
+}
+esp_err_t LedcLedSargent::off()
+{
+    esp_err_t ret = apply(GREEN, 0, fade_ms_);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    lit_[GREEN] = false;
+    ret = apply(RED, 0, fade_ms_);
+    if (ret == ESP_OK) {
+        lit_[RED] = false;
+    }
+    return ret;
+}
+
+esp_err_t LedcLedSargent::set_brightness(uint8_t percent)
+{
+    if (percent > 100) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+    duty_ = duty_for(percent);
+    for (Led led : LEDS) {
+        if (lit_[led]) {
+            esp_err_t ret = apply(led, duty_, fade_ms_);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t LedcLedSargent::fade(Led led, uint8_t percent, uint32_t time_ms)
+{
+    if (percent > 100) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = apply(led, duty_for(percent), time_ms);
+    if (ret == ESP_OK) {
+        lit_[led] = (percent != 0);
+    }
+    return ret;
+}
@@ -0,0 +1,53 @@
+// ll_gpio_hal.cpp
+
+#include "sdkconfig.h"
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "hal/gpio_ll.h"
+#include "soc/gpio_reg.h"
+#include "soc/gpio_struct.h"
+#include "soc/soc.h"
+#include "soc/soc_caps.h"
+#endif
+
+#include "ll_gpio_hal.hpp"
+
+esp_err_t LlGpioHal::pin_set_direction(gpio_num_t gpio_num, gpio_mode_t mode)
+{
+    // Setup path: the driver validates the pin here, once
+    return gpio_set_direction(gpio_num, mode);
+}
+
+esp_err_t LlGpioHal::pin_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    return gpio_set_level(gpio_num, level);
+#else
+    gpio_ll_set_level(&GPIO, gpio_num, level);
+    return ESP_OK;
+#endif
+}
+
+int LlGpioHal::pin_get_level(gpio_num_t gpio_num)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    return gpio_get_level(gpio_num);
+#else
+    return gpio_ll_get_level(&GPIO, gpio_num);
+#endif
+}
+
+esp_err_t LlGpioHal::port_set_levels(uint64_t set_mask, uint64_t clear_mask)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    return IGpioHal::port_set_levels(set_mask, clear_mask);
+#else
+    REG_WRITE(GPIO_OUT_W1TC_REG, static_cast<uint32_t>(clear_mask));
+    REG_WRITE(GPIO_OUT_W1TS_REG, static_cast<uint32_t>(set_mask));
+#if SOC_GPIO_PIN_COUNT > 32
+    REG_WRITE(GPIO_OUT1_W1TC_REG, static_cast<uint32_t>(clear_mask >> 32));
+    REG_WRITE(GPIO_OUT1_W1TS_REG, static_cast<uint32_t>(set_mask >> 32));
+#endif
+    return ESP_OK;
+#endif
+}
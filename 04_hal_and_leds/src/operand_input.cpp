@@ -0,0 +1,119 @@
+// operand_input.cpp
+
+#include "operand_input.hpp"
+
+OperandInput::OperandInput(IGpioHal &gpio_hal, const OperandInputConfig &config)
+    : gpio_hal_(gpio_hal)
+    , config_(config)
+    , last_edge_us_(0)
+    , has_last_edge_(false)
+{
+    // Same rule as LedSargent: remember the first setup error, and
+    // refuse to work later if there was one.
+    init_err_ = gpio_hal_.pin_set_direction(config_.strobe, GPIO_MODE_INPUT);
+    for (size_t i = 0; i < OperandInputConfig::BITS; i++) {
+        esp_err_t ret_a = gpio_hal_.pin_set_direction(config_.a_pins[i], GPIO_MODE_INPUT);
+        esp_err_t ret_b = gpio_hal_.pin_set_direction(config_.b_pins[i], GPIO_MODE_INPUT);
+        if (init_err_ == ESP_OK) {
+            init_err_ = (ret_a != ESP_OK) ? ret_a : ret_b;
+        }
+    }
+    if (init_err_ == ESP_OK) {
+        init_err_ = gpio_hal_.pin_set_intr(config_.strobe, GPIO_INTR_POSEDGE, on_strobe, this);
+    }
+}
+
+OperandInput::~OperandInput()
+{
+    if (init_err_ == ESP_OK) {
+        gpio_hal_.pin_remove_intr(config_.strobe);
+    }
+}
+
+esp_err_t OperandInput::process(SumBoss &boss, int &result, TickType_t timeout)
+{
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+
+    waiter_.store(xTaskGetCurrentTaskHandle(), std::memory_order_release);
+
+    // The ISR notifies once per push, but a call that finds operands
+    // queued pops them without taking the notification. So a notification
+    // can be left over from operands already processed: the take then
+    // returns at once with nothing queued. Loop until something is popped
+    // or the whole timeout has passed, the way the FreeRTOS queues do.
+    TimeOut_t time_out;
+    vTaskSetTimeOutState(&time_out);
+    Operands operands;
+    while (!pop(operands)) {
+        if (xTaskCheckForTimeOut(&time_out, &timeout) != pdFALSE) {
+            return ESP_ERR_TIMEOUT;
+        }
+        ulTaskNotifyTake(pdTRUE, timeout);
+    }
+    return boss.compute(operands.a, operands.b, result);
+}
+
+bool OperandInput::pop(Operands &out)
+{
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    out = queue_[tail % QUEUE_SIZE];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+uint32_t OperandInput::dropped() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void OperandInput::on_strobe(void *arg)
+{
+    OperandInput *self = static_cast<OperandInput *>(arg);
+
+    // Leading-edge debounce: accept the first edge, ignore the bounces after it
+    int64_t now = self->config_.now_us();
+    if (self->has_last_edge_ && now - self->last_edge_us_ < self->config_.debounce_us) {
+        return;
+    }
+    self->last_edge_us_ = now;
+    self->has_last_edge_ = true;
+
+    Operands operands;
+    operands.a = self->read_operand(self->config_.a_pins);
+    operands.b = self->read_operand(self->config_.b_pins);
+    self->push_from_isr(operands);
+}
+
+int OperandInput::read_operand(const gpio_num_t *pins)
+{
+    int value = 0;
+    for (size_t i = 0; i < OperandInputConfig::BITS; i++) {
+        if (gpio_hal_.pin_get_level(pins[i])) {
+            value |= 1 << i;
+        }
+    }
+    return value;
+}
+
+void OperandInput::push_from_isr(const Operands &operands)
+{
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == QUEUE_SIZE) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    queue_[head % QUEUE_SIZE] = operands;
+    head_.store(head + 1, std::memory_order_release);
+
+    TaskHandle_t waiter = waiter_.load(std::memory_order_acquire);
+    if (waiter != nullptr) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(waiter, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
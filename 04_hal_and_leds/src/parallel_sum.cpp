@@ -0,0 +1,251 @@
+// parallel_sum.cpp
+
+#include "parallel_sum.hpp"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <signal.h>
+#endif
+
+esp_err_t ParallelSum::reduce(const int16_t *samples, size_t count, const SumStreamBounds &bounds, int64_t &result)
+{
+    result = -1; // Invalid result on initialization
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+
+    size_t used = workers_;
+    if (workers_ == 1 || count < 2 * MIN_SAMPLES_PER_WORKER) {
+        // Not worth waking anyone: the caller sums the whole buffer
+        partials_[0] = sum_range(samples, 0, count, bounds);
+        used = 1;
+    }
+    else {
+        samples_ = samples;
+        count_ = count;
+        bounds_ = bounds;
+#if CONFIG_IDF_TARGET_LINUX
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            pending_ = workers_;
+            generation_++;
+            start_cv_.notify_all();
+            done_cv_.wait(lock, [this] { return pending_ == 0; });
+        }
+#else
+        for (size_t i = 0; i < workers_; i++) {
+            xTaskNotifyGive(tasks_[i]);
+        }
+        for (size_t i = 0; i < workers_; i++) {
+            xSemaphoreTake(done_, portMAX_DELAY);
+        }
+#endif
+    }
+
+    // Combine in the same order as add_constrained_err checks: inputs first, then the sum
+    bool invalid = false;
+    int64_t total = 0;
+    for (size_t i = 0; i < used; i++) {
+        invalid |= partials_[i].invalid;
+        total += partials_[i].sum;
+    }
+    if (invalid) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (total < bounds.sum_min || total > bounds.sum_max) {
+        return ESP_FAIL;
+    }
+    result = total;
+    return ESP_OK;
+}
+
+void ParallelSum::run_slice(size_t worker)
+{
+    size_t begin = count_ * worker / workers_;
+    size_t end = count_ * (worker + 1) / workers_;
+    partials_[worker] = sum_range(samples_, begin, end, bounds_);
+}
+
+ParallelSum::Partial ParallelSum::sum_range(
+    const int16_t *samples,
+    size_t begin,
+    size_t end,
+    const SumStreamBounds &bounds)
+{
+    // Branch-free with 32-bit lanes, so the compiler can vectorize it.
+    // 32768 int16 samples can't overflow an int32, so the block sums are
+    // moved to the 64-bit total every BLOCK samples.
+    const size_t BLOCK = 32768;
+    int64_t sum = 0;
+    int32_t invalid = 0;
+    for (size_t block = begin; block < end; block += BLOCK) {
+        size_t block_end = (end - block > BLOCK) ? block + BLOCK : end;
+        int32_t block_sum = 0;
+        for (size_t i = block; i < block_end; i++) {
+            int32_t s = samples[i];
+            block_sum += s;
+            invalid |= (s < bounds.sample_min) | (s > bounds.sample_max);
+        }
+        sum += block_sum;
+    }
+
+    Partial partial;
+    partial.sum = sum;
+    partial.invalid = invalid != 0;
+    return partial;
+}
+
+#if CONFIG_IDF_TARGET_LINUX
+
+// ---------------------------------------------------------------
+// linux target: thread pool
+// ---------------------------------------------------------------
+
+ParallelSum::ParallelSum(size_t workers)
+    : workers_(workers)
+    , samples_(nullptr)
+    , count_(0)
+    , bounds_()
+    , stop_(false)
+    , init_err_(ESP_OK)
+    , generation_(0)
+    , pending_(0)
+{
+    size_t cores = std::thread::hardware_concurrency();
+    if (workers_ == 0) {
+        workers_ = cores > 0 ? cores : 1;
+    }
+    if (workers_ > MAX_WORKERS) {
+        workers_ = MAX_WORKERS;
+    }
+    for (size_t i = 0; i < workers_; i++) {
+        threads_.emplace_back(&ParallelSum::thread_main, this, i);
+    }
+}
+
+ParallelSum::~ParallelSum()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+void ParallelSum::thread_main(size_t worker)
+{
+    // The FreeRTOS simulator drives its scheduler with signals. Keep them
+    // away from the pool so they always land on a FreeRTOS thread.
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, nullptr);
+
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        run_slice(worker);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+#else
+
+// ---------------------------------------------------------------
+// Chips: one FreeRTOS task per core
+// ---------------------------------------------------------------
+
+ParallelSum::ParallelSum(size_t workers)
+    : workers_(workers)
+    , samples_(nullptr)
+    , count_(0)
+    , bounds_()
+    , stop_(false)
+    , init_err_(ESP_OK)
+{
+    if (workers_ == 0 || workers_ > portNUM_PROCESSORS) {
+        workers_ = portNUM_PROCESSORS;
+    }
+
+    done_ = xSemaphoreCreateCounting(portNUM_PROCESSORS, 0);
+    if (done_ == nullptr) {
+        workers_ = 0;
+        init_err_ = ESP_ERR_NO_MEM;
+        return;
+    }
+    for (size_t i = 0; i < workers_; i++) {
+        worker_args_[i].self = this;
+        worker_args_[i].index = i;
+        // Worker i runs on core i: PRO_CPU (0), then APP_CPU (1)
+        BaseType_t ret = xTaskCreatePinnedToCore(
+            task_main,
+            "parallel_sum",
+            2048,
+            &worker_args_[i],
+            uxTaskPriorityGet(NULL),
+            &tasks_[i],
+            static_cast<BaseType_t>(i));
+        if (ret != pdPASS) {
+            // Stop the workers already running: reduce() won't use them
+            workers_ = i;
+            init_err_ = ESP_ERR_NO_MEM;
+            stop_workers();
+            return;
+        }
+    }
+}
+
+ParallelSum::~ParallelSum()
+{
+    stop_workers();
+}
+
+void ParallelSum::stop_workers()
+{
+    if (done_ == nullptr) {
+        return; // Never created, or already stopped
+    }
+    stop_ = true;
+    for (size_t i = 0; i < workers_; i++) {
+        xTaskNotifyGive(tasks_[i]);
+    }
+    // Each task gives done_ one last time right before deleting itself
+    for (size_t i = 0; i < workers_; i++) {
+        xSemaphoreTake(done_, portMAX_DELAY);
+    }
+    vSemaphoreDelete(done_);
+    done_ = nullptr;
+    workers_ = 0;
+}
+
+void ParallelSum::task_main(void *arg)
+{
+    Worker *worker = static_cast<Worker *>(arg);
+    ParallelSum *self = worker->self;
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (self->stop_) {
+            break;
+        }
+        self->run_slice(worker->index);
+        xSemaphoreGive(self->done_);
+    }
+    xSemaphoreGive(self->done_);
+    vTaskDelete(NULL);
+}
+
+#endif
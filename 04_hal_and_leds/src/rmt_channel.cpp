@@ -0,0 +1,195 @@
+// rmt_channel.cpp
+
+#include "soc/soc_caps.h"
+
+#include "rmt_channel.hpp"
+
+// WS2812 bit timings, in RESOLUTION_HZ ticks
+static const uint16_t T0H = 3; // 0.3 us high, 0.9 us low
+static const uint16_t T0L = 9;
+static const uint16_t T1H = 9; // 0.9 us high, 0.3 us low
+static const uint16_t T1L = 3;
+// Low for 300 us, in two halves: what the newer WS2812B need to latch
+static const uint16_t RESET_TICKS = 1500;
+
+RmtChannel::RmtChannel(gpio_num_t pin)
+    : channel_(nullptr)
+    , encoder_()
+    , queued_()
+    , head_(0)
+    , count_(0)
+{
+    done_ = xSemaphoreCreateCountingStatic(QUEUE_SIZE, 0, &done_buffer_);
+
+    rmt_tx_channel_config_t config = {};
+    config.gpio_num = pin;
+    config.clk_src = RMT_CLK_SRC_DEFAULT;
+    config.resolution_hz = RESOLUTION_HZ;
+    config.trans_queue_depth = QUEUE_SIZE;
+#if SOC_RMT_SUPPORT_DMA
+    config.mem_block_symbols = 1024; // The DMA buffer, refilled by the encoder
+    config.flags.with_dma = true;
+#else
+    config.mem_block_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL;
+#endif
+    init_err_ = rmt_new_tx_channel(&config, &channel_);
+    if (init_err_ != ESP_OK) {
+        channel_ = nullptr;
+        return;
+    }
+    init_err_ = init_encoder();
+    if (init_err_ != ESP_OK) {
+        return;
+    }
+
+    rmt_tx_event_callbacks_t callbacks = {};
+    callbacks.on_trans_done = on_trans_done;
+    init_err_ = rmt_tx_register_event_callbacks(channel_, &callbacks, this);
+    if (init_err_ == ESP_OK) {
+        init_err_ = rmt_enable(channel_);
+    }
+}
+
+RmtChannel::~RmtChannel()
+{
+    if (channel_ != nullptr) {
+        rmt_disable(channel_);
+        rmt_del_channel(channel_);
+    }
+    del_encoder(&encoder_.base);
+    vSemaphoreDelete(done_);
+}
+
+esp_err_t RmtChannel::init_encoder()
+{
+    encoder_.base.encode = encode;
+    encoder_.base.reset = reset_encoder;
+    encoder_.base.del = del_encoder;
+
+    rmt_bytes_encoder_config_t bits = {};
+    bits.bit0.level0 = 1;
+    bits.bit0.duration0 = T0H;
+    bits.bit0.level1 = 0;
+    bits.bit0.duration1 = T0L;
+    bits.bit1.level0 = 1;
+    bits.bit1.duration0 = T1H;
+    bits.bit1.level1 = 0;
+    bits.bit1.duration1 = T1L;
+    bits.flags.msb_first = 1; // The WS2812 takes each byte MSB first
+    esp_err_t ret = rmt_new_bytes_encoder(&bits, &encoder_.bytes);
+    if (ret != ESP_OK) {
+        encoder_.bytes = nullptr;
+        return ret;
+    }
+
+    rmt_copy_encoder_config_t copy = {};
+    ret = rmt_new_copy_encoder(&copy, &encoder_.copy);
+    if (ret != ESP_OK) {
+        encoder_.copy = nullptr;
+        return ret;
+    }
+
+    encoder_.reset.level0 = 0;
+    encoder_.reset.duration0 = RESET_TICKS;
+    encoder_.reset.level1 = 0;
+    encoder_.reset.duration1 = RESET_TICKS;
+    return ESP_OK;
+}
+
+esp_err_t RmtChannel::queue_tx(const uint8_t *data, size_t len)
+{
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+    // rmt_transmit() would block on a full queue: refuse first
+    if (count_ >= QUEUE_SIZE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    rmt_transmit_config_t config = {};
+    config.loop_count = 0; // Once
+    esp_err_t ret = rmt_transmit(channel_, &encoder_.base, data, len, &config);
+    if (ret == ESP_OK) {
+        queued_[(head_ + count_) % QUEUE_SIZE] = data;
+        count_++;
+    }
+    return ret;
+}
+
+esp_err_t RmtChannel::wait_tx(const uint8_t **data, uint32_t timeout_ms)
+{
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+    if (count_ == 0 || xSemaphoreTake(done_, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    // Transfers end in order: the one that ended is the oldest
+    *data = queued_[head_];
+    head_ = (head_ + 1) % QUEUE_SIZE;
+    count_--;
+    return ESP_OK;
+}
+
+size_t RmtChannel::encode(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *data, size_t size, rmt_encode_state_t *ret_state)
+{
+    // Called from the RMT ISR each time the RMT memory or DMA buffer has
+    // room, and picks up where the previous call stopped
+    Ws2812Encoder *self = reinterpret_cast<Ws2812Encoder *>(encoder);
+    rmt_encode_state_t session = RMT_ENCODING_RESET;
+    size_t encoded = 0;
+
+    if (self->state == 0) {
+        encoded += self->bytes->encode(self->bytes, channel, data, size, &session);
+        if (session & RMT_ENCODING_COMPLETE) {
+            self->state = 1;
+        }
+        if (session & RMT_ENCODING_MEM_FULL) {
+            *ret_state = RMT_ENCODING_MEM_FULL;
+            return encoded;
+        }
+    }
+
+    int state = RMT_ENCODING_RESET;
+    encoded += self->copy->encode(self->copy, channel, &self->reset, sizeof(self->reset), &session);
+    if (session & RMT_ENCODING_COMPLETE) {
+        self->state = 0;
+        state |= RMT_ENCODING_COMPLETE;
+    }
+    if (session & RMT_ENCODING_MEM_FULL) {
+        state |= RMT_ENCODING_MEM_FULL;
+    }
+    *ret_state = static_cast<rmt_encode_state_t>(state);
+    return encoded;
+}
+
+esp_err_t RmtChannel::reset_encoder(rmt_encoder_t *encoder)
+{
+    Ws2812Encoder *self = reinterpret_cast<Ws2812Encoder *>(encoder);
+    rmt_encoder_reset(self->bytes);
+    rmt_encoder_reset(self->copy);
+    self->state = 0;
+    return ESP_OK;
+}
+
+esp_err_t RmtChannel::del_encoder(rmt_encoder_t *encoder)
+{
+    // The encoder itself is a member: only the driver's encoders are freed
+    Ws2812Encoder *self = reinterpret_cast<Ws2812Encoder *>(encoder);
+    if (self->bytes != nullptr) {
+        rmt_del_encoder(self->bytes);
+        self->bytes = nullptr;
+    }
+    if (self->copy != nullptr) {
+        rmt_del_encoder(self->copy);
+        self->copy = nullptr;
+    }
+    return ESP_OK;
+}
+
+bool RmtChannel::on_trans_done(rmt_channel_handle_t, const rmt_tx_done_event_data_t *, void *ctx)
+{
+    RmtChannel *self = static_cast<RmtChannel *>(ctx);
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(self->done_, &woken);
+    return woken == pdTRUE;
+}
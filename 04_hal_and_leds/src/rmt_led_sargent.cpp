@@ -0,0 +1,73 @@
+// rmt_led_sargent.cpp
+
+#include "rmt_led_sargent.hpp"
+
+RmtLedSargent::RmtLedSargent(IDmaTx &rmt, size_t pixels)
+    : pixels_(pixels)
+    , level_(level_for(DEFAULT_BRIGHTNESS))
+    , lit_{false, false}
+    , frames_(rmt, WAIT_MS)
+    , init_err_(ESP_OK)
+{
+    if (pixels_ == 0 || pixels_ > MAX_PIXELS) {
+        pixels_ = 0;
+        init_err_ = ESP_ERR_INVALID_ARG;
+        return;
+    }
+    // Whatever the pixels showed before the reset, they start off
+    init_err_ = push();
+}
+
+esp_err_t RmtLedSargent::green()
+{
+    return show(true, lit_[RED]);
+}
+
+esp_err_t RmtLedSargent::red()
+{
+    return show(lit_[GREEN], true);
+}
+
+esp_err_t RmtLedSargent::off()
+{
+    return show(false, false);
+}
+
+esp_err_t RmtLedSargent::set_brightness(uint8_t percent)
+{
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+    if (percent > 100) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    level_ = level_for(percent);
+    if (!lit_[GREEN] && !lit_[RED]) {
+        return ESP_OK; // Nothing on the strip changes
+    }
+    return push();
+}
+
+esp_err_t RmtLedSargent::show(bool green, bool red)
+{
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+    lit_[GREEN] = green;
+    lit_[RED] = red;
+    // If the frame can't go out, the colors are kept: the next change carries them
+    return push();
+}
+
+esp_err_t RmtLedSargent::push()
+{
+    uint8_t g = lit_[GREEN] ? level_ : 0;
+    uint8_t r = lit_[RED] ? level_ : 0;
+    return frames_.send(pixels_ * BYTES_PER_PIXEL, [this, g, r](uint8_t *frame) {
+        for (size_t p = 0; p < pixels_; p++) {
+            frame[p * BYTES_PER_PIXEL + 0] = g;
+            frame[p * BYTES_PER_PIXEL + 1] = r;
+            frame[p * BYTES_PER_PIXEL + 2] = 0; // Blue
+        }
+    });
+}
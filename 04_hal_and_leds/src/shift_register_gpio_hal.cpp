@@ -0,0 +1,75 @@
+// shift_register_gpio_hal.cpp
+
+#include "shift_register_gpio_hal.hpp"
+
+ShiftRegisterGpioHal::ShiftRegisterGpioHal(IDmaTx &spi, size_t registers)
+    : registers_(registers)
+    , state_()
+    , frames_(spi, WAIT_MS)
+    , init_err_(ESP_OK)
+{
+    if (registers_ == 0 || registers_ > MAX_REGISTERS) {
+        registers_ = 0;
+        init_err_ = ESP_ERR_INVALID_ARG;
+        return;
+    }
+    // A 74HC595 powers up with whatever its latches hold
+    init_err_ = push();
+}
+
+esp_err_t ShiftRegisterGpioHal::pin_set_direction(gpio_num_t pin, gpio_mode_t mode)
+{
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+    if (!valid(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // A 74HC595 output can't be read or turned off
+    return (mode & GPIO_MODE_DEF_OUTPUT) != 0 ? ESP_OK : ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t ShiftRegisterGpioHal::pin_set_level(gpio_num_t pin, uint32_t level)
+{
+    if (!valid(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint64_t mask = 1ull << pin;
+    return level ? port_set_levels(mask, 0) : port_set_levels(0, mask);
+}
+
+int ShiftRegisterGpioHal::pin_get_level(gpio_num_t pin)
+{
+    if (!valid(pin)) {
+        return 0;
+    }
+    return (state_[pin / 8] >> (pin % 8)) & 1;
+}
+
+esp_err_t ShiftRegisterGpioHal::port_set_levels(uint64_t set_mask, uint64_t clear_mask)
+{
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+    uint64_t outputs_mask = (outputs() == 64) ? ~0ull : (1ull << outputs()) - 1;
+    if (((set_mask | clear_mask) & ~outputs_mask) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t r = 0; r < registers_; r++) {
+        uint8_t set = static_cast<uint8_t>(set_mask >> (r * 8));
+        uint8_t clear = static_cast<uint8_t>(clear_mask >> (r * 8));
+        state_[r] = static_cast<uint8_t>((state_[r] & ~clear) | set);
+    }
+    // If the frame can't go out, the state is kept: the next write carries it
+    return push();
+}
+
+esp_err_t ShiftRegisterGpioHal::push()
+{
+    // The first byte out ends up in the last register of the chain
+    return frames_.send(registers_, [this](uint8_t *frame) {
+        for (size_t r = 0; r < registers_; r++) {
+            frame[registers_ - 1 - r] = state_[r];
+        }
+    });
+}
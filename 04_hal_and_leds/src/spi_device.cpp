@@ -0,0 +1,76 @@
+// spi_device.cpp
+
+#include "freertos/FreeRTOS.h"
+
+#include "spi_device.hpp"
+
+SpiDevice::SpiDevice(spi_host_device_t host, gpio_num_t mosi, gpio_num_t sclk, gpio_num_t latch, int clock_hz)
+    : host_(host)
+    , device_(nullptr)
+    , transactions_()
+    , next_(0)
+{
+    spi_bus_config_t bus = {};
+    bus.mosi_io_num = mosi;
+    bus.miso_io_num = -1;
+    bus.sclk_io_num = sclk;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    init_err_ = spi_bus_initialize(host_, &bus, SPI_DMA_CH_AUTO);
+    if (init_err_ != ESP_OK) {
+        return;
+    }
+
+    spi_device_interface_config_t device = {};
+    device.mode = 0;
+    device.clock_speed_hz = clock_hz;
+    device.spics_io_num = latch; // Rises after the last bit: the 74HC595 latch
+    device.queue_size = QUEUE_SIZE;
+    init_err_ = spi_bus_add_device(host_, &device, &device_);
+    if (init_err_ != ESP_OK) {
+        spi_bus_free(host_);
+    }
+}
+
+SpiDevice::~SpiDevice()
+{
+    if (init_err_ == ESP_OK) {
+        spi_bus_remove_device(device_);
+        spi_bus_free(host_);
+    }
+}
+
+esp_err_t SpiDevice::queue_tx(const uint8_t *data, size_t len)
+{
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+    // Transfers end in order, so the slot used QUEUE_SIZE transfers ago is
+    // free once its owner got it back through wait_tx()
+    spi_transaction_t &transaction = transactions_[next_];
+    transaction = {};
+    transaction.length = len * 8; // In bits
+    transaction.tx_buffer = data;
+    esp_err_t ret = spi_device_queue_trans(device_, &transaction, 0);
+    if (ret == ESP_ERR_TIMEOUT) {
+        return ESP_ERR_INVALID_STATE; // The driver's queue is full
+    }
+    if (ret == ESP_OK) {
+        next_ = (next_ + 1) % QUEUE_SIZE;
+    }
+    return ret;
+}
+
+esp_err_t SpiDevice::wait_tx(const uint8_t **data, uint32_t timeout_ms)
+{
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+    spi_transaction_t *done = nullptr;
+    esp_err_t ret = spi_device_get_trans_result(device_, &done, pdMS_TO_TICKS(timeout_ms));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    *data = static_cast<const uint8_t *>(done->tx_buffer);
+    return ESP_OK;
+}
@@ -0,0 +1,175 @@
+// stats_store.cpp
+
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#include "stats_store.hpp"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <stdlib.h>
+#else
+#include "esp_system.h"
+#endif
+
+static const char *TAG = "STATS";
+
+namespace
+{
+// What goes to flash: the layout version first, so a firmware with a
+// different SumStats can tell the blob isn't its own.
+struct StatsBlob
+{
+    uint32_t version;
+    SumStats stats;
+};
+} // namespace
+
+StatsStore *StatsStore::hooked_ = nullptr;
+
+StatsStore::StatsStore(const StatsStoreConfig &config)
+    : config_(config)
+    , handle_(0)
+    , last_commit_us_(config.now_us != nullptr ? config.now_us() : 0)
+{
+    init_err_ = load();
+}
+
+StatsStore::~StatsStore()
+{
+    if (hooked_ == this) {
+        hooked_ = nullptr;
+    }
+    if (init_err_ == ESP_OK) {
+        flush();
+        nvs_close(handle_);
+    }
+}
+
+esp_err_t StatsStore::commit_if_due()
+{
+    return commit(false);
+}
+
+esp_err_t StatsStore::flush()
+{
+    return commit(true);
+}
+
+esp_err_t StatsStore::install_shutdown_hook()
+{
+    static bool installed = false;
+    if (!installed) {
+#if CONFIG_IDF_TARGET_LINUX
+        if (atexit(on_shutdown) != 0) {
+            return ESP_FAIL;
+        }
+#else
+        esp_err_t ret = esp_register_shutdown_handler(on_shutdown);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+#endif
+        installed = true;
+    }
+    hooked_ = this;
+    return ESP_OK;
+}
+
+SumStats StatsStore::totals() const
+{
+    SumStats stats;
+    stats.successes = successes_.load(std::memory_order_relaxed);
+    stats.out_of_range = out_of_range_.load(std::memory_order_relaxed);
+    stats.invalid_args = invalid_args_.load(std::memory_order_relaxed);
+    stats.other_errors = other_errors_.load(std::memory_order_relaxed);
+    stats.led_errors = led_errors_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void StatsStore::on_shutdown()
+{
+    if (hooked_ != nullptr) {
+        hooked_->flush();
+    }
+}
+
+esp_err_t StatsStore::load()
+{
+    esp_err_t ret = nvs_open(config_.nvs_namespace, NVS_READWRITE, &handle_);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    StatsBlob blob;
+    size_t length = sizeof(blob);
+    ret = nvs_get_blob(handle_, config_.key, &blob, &length);
+    if (ret == ESP_ERR_NVS_NOT_FOUND) {
+        return ESP_OK; // First boot: start from zero
+    }
+    if (ret == ESP_ERR_NVS_INVALID_LENGTH ||
+        (ret == ESP_OK && (length != sizeof(blob) || blob.version != LAYOUT_VERSION))) {
+        ESP_LOGW(TAG, "Stats blob '%s' has another layout, starting from zero", config_.key);
+        return ESP_OK; // Overwritten by the first commit
+    }
+    if (ret != ESP_OK) {
+        nvs_close(handle_);
+        return ret;
+    }
+
+    successes_.store(blob.stats.successes, std::memory_order_relaxed);
+    out_of_range_.store(blob.stats.out_of_range, std::memory_order_relaxed);
+    invalid_args_.store(blob.stats.invalid_args, std::memory_order_relaxed);
+    other_errors_.store(blob.stats.other_errors, std::memory_order_relaxed);
+    led_errors_.store(blob.stats.led_errors, std::memory_order_relaxed);
+    return ESP_OK;
+}
+
+esp_err_t StatsStore::commit(bool force)
+{
+    if (init_err_ != ESP_OK) {
+        return init_err_;
+    }
+
+    // A forced commit waits for its turn, so nothing recorded before
+    // flush() was called is left behind. It blocks on the mutex instead of
+    // spinning: a spinning task of higher priority would keep the holder
+    // from ever running, while the mutex lends the holder its priority.
+    // commit_if_due() doesn't bother: whoever holds it is committing anyway.
+    std::unique_lock<std::mutex> lock(committing_, std::defer_lock);
+    if (force) {
+        lock.lock();
+    }
+    else if (!lock.try_lock()) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = ESP_OK;
+    uint32_t pending = pending_.load(std::memory_order_acquire);
+    int64_t now = config_.now_us != nullptr ? config_.now_us() : 0;
+    bool due = force || (config_.commit_every != 0 && pending >= config_.commit_every) ||
+               (config_.commit_interval_us != 0 && config_.now_us != nullptr &&
+                now - last_commit_us_ >= config_.commit_interval_us);
+
+    if (pending != 0 && due) {
+        // Records that land from here on count for the next commit. Some
+        // may make it into this snapshot too, which only makes the next
+        // commit come a little early.
+        pending_.fetch_sub(pending, std::memory_order_relaxed);
+
+        StatsBlob blob;
+        blob.version = LAYOUT_VERSION;
+        blob.stats = totals();
+        ret = nvs_set_blob(handle_, config_.key, &blob, sizeof(blob));
+        if (ret == ESP_OK) {
+            ret = nvs_commit(handle_);
+        }
+        if (ret == ESP_OK) {
+            last_commit_us_ = now;
+            commits_.fetch_add(1, std::memory_order_relaxed);
+        }
+        else {
+            pending_.fetch_add(pending, std::memory_order_relaxed); // Try again next time
+        }
+    }
+    return ret;
+}
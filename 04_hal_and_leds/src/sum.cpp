@@ -27,20 +27,28 @@ int Sum::add_constrained(int a, int b)
 }
 
 esp_err_t Sum::add_constrained_err(int a, int b, int &result)
+{
+    esp_err_t err = add_constrained_err_isr(a, b, result);
+    if (err == ESP_ERR_INVALID_ARG) {
+        ESP_LOGE(TAG, "Invalid params: a = %d, b = %d, error = %s", a, b, esp_err_to_name(err));
+    }
+    else if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid result: sum = %d, error=%s", a + b, esp_err_to_name(err));
+    }
+    return err;
+}
+
+esp_err_t Sum::add_constrained_err_isr(int a, int b, int &result)
 {
     result = -1; // Invalid result on initialization
     if (a < 0 || a > 10 || b < 0 || b > 10) {
-        esp_err_t err = ESP_ERR_INVALID_ARG;
-        ESP_LOGE(TAG, "Invalid params: a = %d, b = %d, error = %s", a, b, esp_err_to_name(err));
-        return err;
+        return ESP_ERR_INVALID_ARG;
     }
 
     int sum = a + b;
 
     if (sum > 10) {
-        esp_err_t err = ESP_FAIL;
-        ESP_LOGE(TAG, "Invalid result: sum = %d, error=%s", sum, esp_err_to_name(err));
-        return err;
+        return ESP_FAIL;
     }
 
     result = sum;
@@ -1,22 +1,109 @@
 #include "sum_boss.hpp"
+#include "led_sequencer.hpp"
+#include "result_fanout.hpp"
+#include "stats_store.hpp"
 
 SumBoss::SumBoss(ISum &sum, ILedSargent &led_sargent)
     : sum_(sum)
     , led_sargent_(led_sargent)
+    , latency_(nullptr)
+    , now_(nullptr)
+    , stats_(nullptr)
+    , sequencer_(nullptr)
+    , observer_(nullptr)
 {
 }
 
 esp_err_t SumBoss::compute(int a, int b, int &result)
 {
-    esp_err_t ret = sum_.add_constrained_err(a, b, result);
+    int64_t start = latency_start();
+    bool led_changed;
+    esp_err_t sum_err = sum_.add_constrained_err(a, b, result);
+    esp_err_t ret = show_result(sum_err, true, led_changed);
+    latency_end(start, led_changed);
+    if (stats_ != nullptr) {
+        stats_->record(sum_err, led_changed);
+        stats_->commit_if_due(); // Writes flash only when a threshold was reached
+    }
+    if (observer_ != nullptr) {
+        observer_->on_result({a, b, result, sum_err, led_changed});
+    }
+    return ret;
+}
+
+esp_err_t SumBoss::compute_isr(int a, int b, int &result)
+{
+    int64_t start = latency_start();
+    bool led_changed;
+    esp_err_t sum_err = sum_.add_constrained_err_isr(a, b, result);
+    esp_err_t ret = show_result(sum_err, false, led_changed);
+    latency_end(start, led_changed);
+    if (stats_ != nullptr) {
+        stats_->record(sum_err, led_changed);
+    }
+    return ret;
+}
+
+esp_err_t SumBoss::process(ComputeRequest &request)
+{
+    esp_err_t err = compute(request.a, request.b, request.result);
+    request.err = err;
+    if (request.on_done != nullptr) {
+        request.on_done(request, request.ctx); // may release the request
+    }
+    return err;
+}
+
+void SumBoss::set_latency_histogram(LatencyHistogram *histogram, int64_t (*now)())
+{
+    latency_ = histogram;
+    now_ = now;
+}
+
+void SumBoss::set_stats(StatsStore *stats)
+{
+    stats_ = stats;
+}
+
+void SumBoss::set_sequencer(LedSequencer *sequencer)
+{
+    sequencer_ = sequencer;
+}
+
+void SumBoss::set_observer(IResultObserver *observer)
+{
+    observer_ = observer;
+}
+
+esp_err_t SumBoss::show_result(esp_err_t ret, bool use_sequencer, bool &led_changed)
+{
+    if (use_sequencer && sequencer_ != nullptr) {
+        esp_err_t play_err = sequencer_->play(LedPatterns::for_result(ret));
+        led_changed = (play_err == ESP_OK);
+        return (ret == ESP_OK) ? play_err : ret;
+    }
     if (ret == ESP_OK) {            // no error
         ret = led_sargent_.green(); // check if green led works
+        led_changed = (ret == ESP_OK);
         if (ret != ESP_OK) {        // green led does not work
             return ret;             // return the error
         }
     }
-    else {                  // if the sum failed
-        led_sargent_.red(); // the sum error is already in ret
+    else {                                            // if the sum failed
+        led_changed = (led_sargent_.red() == ESP_OK); // the sum error is already in ret
     }
     return ret;
+}
+
+int64_t SumBoss::latency_start()
+{
+    return (latency_ != nullptr && now_ != nullptr) ? now_() : 0;
+}
+
+void SumBoss::latency_end(int64_t start, bool led_changed)
+{
+    // A failed LED call means the level never changed: nothing to measure
+    if (latency_ != nullptr && now_ != nullptr && led_changed) {
+        latency_->record(static_cast<uint32_t>(now_() - start));
+    }
 }
\ No newline at end of file
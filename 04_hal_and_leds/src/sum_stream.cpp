@@ -0,0 +1,94 @@
+// sum_stream.cpp
+
+#include <string.h>
+
+#include "sum_stream.hpp"
+
+// 4 x int32 lanes. GCC maps this to SSE/NEON on the host; on targets
+// without a vector unit it's lowered to scalar code.
+typedef int32_t v4i32 __attribute__((vector_size(16)));
+
+// In-lane prefix sum: {a, b, c, d} -> {a, a+b, a+b+c, a+b+c+d}
+static inline v4i32 prefix4(v4i32 x)
+{
+    const v4i32 zero = {0, 0, 0, 0};
+    const v4i32 shift1 = {0, 4, 5, 6}; // {0, x0, x1, x2}
+    const v4i32 shift2 = {0, 1, 4, 5}; // {0, 0, x0, x1}
+    x += __builtin_shuffle(zero, x, shift1);
+    x += __builtin_shuffle(zero, x, shift2);
+    return x;
+}
+
+static inline v4i32 splat(int32_t v)
+{
+    v4i32 r = {v, v, v, v};
+    return r;
+}
+
+SumStream::SumStream(const SumStreamBounds &bounds)
+    : bounds_(bounds)
+{
+    reset();
+}
+
+void SumStream::reset()
+{
+    total_ = 0;
+    position_ = 0;
+    violation_index_ = NO_VIOLATION;
+    status_ = ESP_OK;
+}
+
+esp_err_t SumStream::feed(const int16_t *samples, size_t count, int32_t *prefix, size_t &accepted)
+{
+    accepted = 0;
+    if (status_ != ESP_OK) {
+        return status_;
+    }
+
+    int32_t total = total_;
+    size_t i = 0;
+
+    // Vector part: 4 samples per step. A block with any violation is left
+    // to the scalar loop below, which finds exactly where it is.
+    const v4i32 sample_min = splat(bounds_.sample_min);
+    const v4i32 sample_max = splat(bounds_.sample_max);
+    const v4i32 sum_min = splat(bounds_.sum_min);
+    const v4i32 sum_max = splat(bounds_.sum_max);
+    for (; i + 4 <= count; i += 4) {
+        v4i32 s = {samples[i], samples[i + 1], samples[i + 2], samples[i + 3]};
+        v4i32 p = prefix4(s) + splat(total);
+        v4i32 bad = (s < sample_min) | (s > sample_max) | (p < sum_min) | (p > sum_max);
+        if (bad[0] | bad[1] | bad[2] | bad[3]) {
+            break;
+        }
+        memcpy(&prefix[i], &p, sizeof(p));
+        total = p[3];
+    }
+
+    // Scalar part: the tail, and the block holding a violation if any
+    esp_err_t err = ESP_OK;
+    for (; i < count; i++) {
+        int32_t s = samples[i];
+        if (s < bounds_.sample_min || s > bounds_.sample_max) {
+            err = ESP_ERR_INVALID_ARG;
+            break;
+        }
+        int32_t next = total + s;
+        if (next < bounds_.sum_min || next > bounds_.sum_max) {
+            err = ESP_FAIL;
+            break;
+        }
+        prefix[i] = next;
+        total = next;
+    }
+
+    accepted = i;
+    total_ = total;
+    if (err != ESP_OK) {
+        status_ = err;
+        violation_index_ = position_ + i;
+    }
+    position_ += i;
+    return err;
+}
@@ -0,0 +1,185 @@
+// trace_replay.cpp
+
+#include <chrono>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "trace_replay.hpp"
+
+// ------------------------------------------------------------------
+// MappedTrace
+// ------------------------------------------------------------------
+
+MappedTrace::MappedTrace()
+    : map_(nullptr)
+    , map_size_(0)
+    , records_(nullptr)
+    , count_(0)
+{
+}
+
+MappedTrace::~MappedTrace()
+{
+    close();
+}
+
+esp_err_t MappedTrace::open(const char *path)
+{
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TraceHeader)) {
+        ::close(fd);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file open
+    if (map == MAP_FAILED) {
+        return ESP_FAIL;
+    }
+
+    const TraceHeader *header = static_cast<const TraceHeader *>(map);
+    esp_err_t ret = ESP_OK;
+    if (memcmp(header->magic, TraceHeader::TRACE_MAGIC, sizeof(header->magic)) != 0) {
+        ret = ESP_ERR_INVALID_ARG;
+    }
+    else if (header->version != TraceHeader::VERSION) {
+        ret = ESP_ERR_INVALID_VERSION;
+    }
+    else if (header->record_size != sizeof(BatchPair) ||
+             header->count > (size - sizeof(TraceHeader)) / sizeof(BatchPair)) {
+        ret = ESP_ERR_INVALID_SIZE;
+    }
+    if (ret != ESP_OK) {
+        munmap(map, size);
+        return ret;
+    }
+
+    madvise(map, size, MADV_SEQUENTIAL);
+    map_ = map;
+    map_size_ = size;
+    records_ = reinterpret_cast<const BatchPair *>(header + 1);
+    count_ = static_cast<size_t>(header->count);
+    return ESP_OK;
+}
+
+void MappedTrace::close()
+{
+    if (map_ != nullptr) {
+        munmap(map_, map_size_);
+    }
+    map_ = nullptr;
+    map_size_ = 0;
+    records_ = nullptr;
+    count_ = 0;
+}
+
+// ------------------------------------------------------------------
+// MappedResults
+// ------------------------------------------------------------------
+
+MappedResults::MappedResults()
+    : map_(nullptr)
+    , map_size_(0)
+    , records_(nullptr)
+    , count_(0)
+{
+}
+
+MappedResults::~MappedResults()
+{
+    close();
+}
+
+esp_err_t MappedResults::create(const char *path, size_t count)
+{
+    close();
+
+    int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return ESP_FAIL;
+    }
+    size_t size = sizeof(TraceHeader) + count * sizeof(BatchReply);
+    void *map = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return ESP_FAIL;
+    }
+
+    TraceHeader *header = static_cast<TraceHeader *>(map);
+    memcpy(header->magic, TraceHeader::RESULTS_MAGIC, sizeof(header->magic));
+    header->version = TraceHeader::VERSION;
+    header->record_size = sizeof(BatchReply);
+    header->count = count;
+
+    map_ = map;
+    map_size_ = size;
+    records_ = reinterpret_cast<BatchReply *>(header + 1);
+    count_ = count;
+    return ESP_OK;
+}
+
+esp_err_t MappedResults::close()
+{
+    esp_err_t ret = ESP_OK;
+    if (map_ != nullptr) {
+        if (msync(map_, map_size_, MS_SYNC) != 0) {
+            ret = ESP_FAIL;
+        }
+        munmap(map_, map_size_);
+    }
+    map_ = nullptr;
+    map_size_ = 0;
+    records_ = nullptr;
+    count_ = 0;
+    return ret;
+}
+
+// ------------------------------------------------------------------
+// TraceReplay
+// ------------------------------------------------------------------
+
+TraceReplay::TraceReplay(SumBoss &boss, Path path)
+    : boss_(boss)
+    , path_(path)
+{
+}
+
+void TraceReplay::run(const BatchPair *records, size_t count, BatchReply *out, ReplayReport &report)
+{
+    memset(&report, 0, sizeof(report));
+    // One counter per class, indexed without a branch per record
+    uint64_t classes[4] = {0, 0, 0, 0};
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        int result;
+        esp_err_t err = (path_ == COMPUTE) ? boss_.compute(records[i].a, records[i].b, result)
+                                           : boss_.compute_isr(records[i].a, records[i].b, result);
+        size_t cls = (err == ESP_OK) ? 0 : (err == ESP_FAIL) ? 1 : (err == ESP_ERR_INVALID_ARG) ? 2 : 3;
+        classes[cls]++;
+        if (out != nullptr) {
+            out[i].result = result;
+            out[i].err = err;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    report.records = count;
+    report.successes = classes[0];
+    report.out_of_range = classes[1];
+    report.invalid_args = classes[2];
+    report.other_errors = classes[3];
+    report.seconds = std::chrono::duration<double>(end - start).count();
+}
@@ -0,0 +1,63 @@
+// uart_stream.cpp
+
+#include "freertos/FreeRTOS.h"
+
+#include "uart_stream.hpp"
+
+UartStream::UartStream(uart_port_t port, int baud_rate)
+    : port_(port)
+    , installed_(false)
+{
+    uart_config_t config = {};
+    config.baud_rate = baud_rate;
+    config.data_bits = UART_DATA_8_BITS;
+    config.parity = UART_PARITY_DISABLE;
+    config.stop_bits = UART_STOP_BITS_1;
+    config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    config.source_clk = UART_SCLK_DEFAULT;
+
+    // Same rule as LedSargent: remember the first setup error, and
+    // refuse to work later if there was one.
+    init_err_ = uart_driver_install(port_, RX_BUFFER_SIZE, 0, 0, nullptr, 0);
+    if (init_err_ == ESP_OK) {
+        installed_ = true;
+        init_err_ = uart_param_config(port_, &config);
+    }
+}
+
+UartStream::~UartStream()
+{
+    if (installed_) {
+        uart_driver_delete(port_);
+    }
+}
+
+int UartStream::read(uint8_t *data, size_t length, uint32_t timeout_ms)
+{
+    if (init_err_ != ESP_OK) {
+        return -1;
+    }
+    // Wait for the first byte, then take whatever else is already buffered
+    int n = uart_read_bytes(port_, data, 1, pdMS_TO_TICKS(timeout_ms));
+    if (n <= 0) {
+        return n;
+    }
+    size_t buffered = 0;
+    uart_get_buffered_data_len(port_, &buffered);
+    if (buffered > length - 1) {
+        buffered = length - 1;
+    }
+    if (buffered == 0) {
+        return 1;
+    }
+    int more = uart_read_bytes(port_, data + 1, buffered, 0);
+    return (more < 0) ? -1 : 1 + more;
+}
+
+int UartStream::write(const uint8_t *data, size_t length)
+{
+    if (init_err_ != ESP_OK) {
+        return -1;
+    }
+    return uart_write_bytes(port_, data, length);
+}
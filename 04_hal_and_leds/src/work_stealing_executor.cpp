@@ -0,0 +1,205 @@
+// work_stealing_executor.cpp
+
+#include <signal.h>
+
+#include "work_stealing_executor.hpp"
+
+WorkStealingExecutor::WorkStealingExecutor(size_t workers)
+    : workers_(workers)
+    , job_(nullptr)
+    , ctx_(nullptr)
+    , generation_(0)
+    , active_(0)
+    , stop_(false)
+    , steals_(0)
+{
+    size_t cores = std::thread::hardware_concurrency();
+    if (workers_ == 0) {
+        workers_ = cores > 0 ? cores : 1;
+    }
+    if (workers_ > MAX_WORKERS) {
+        workers_ = MAX_WORKERS;
+    }
+
+    pool_.reset(new Worker[workers_]);
+    for (size_t i = 0; i < workers_; i++) {
+        pool_[i].thread = std::thread(&WorkStealingExecutor::thread_main, this, i);
+    }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    shutdown();
+}
+
+void WorkStealingExecutor::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_) {
+            return;
+        }
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (size_t i = 0; i < workers_; i++) {
+        pool_[i].thread.join();
+    }
+}
+
+esp_err_t WorkStealingExecutor::run(Job job, void *ctx, size_t count, Placement placement)
+{
+    if (job == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_) {
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+
+    job_ = job;
+    ctx_ = ctx;
+    error_ = nullptr;
+
+    // Every worker is parked between rounds, so the deques can be refilled
+    // from this thread. The mutex hand-off publishes them to the workers.
+    size_t first = 0;
+    while (first < count) {
+        size_t dealt = deal(first, count - first, placement);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        active_ = workers_;
+        generation_++;
+        start_cv_.notify_all();
+        done_cv_.wait(lock, [this] { return active_ == 0; });
+
+        first += dealt;
+    }
+
+#if __cpp_exceptions
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+#endif
+    return ESP_OK;
+}
+
+esp_err_t WorkStealingExecutor::compute(SumBoss &boss, ComputeJob *jobs, size_t count)
+{
+    struct Batch
+    {
+        SumBoss *boss;
+        ComputeJob *jobs;
+    };
+    Batch batch = {&boss, jobs};
+
+    return run(
+        [](void *ctx, size_t index) {
+            Batch *batch = static_cast<Batch *>(ctx);
+            ComputeJob &job = batch->jobs[index];
+            job.err = batch->boss->compute(job.a, job.b, job.result);
+        },
+        &batch,
+        count);
+}
+
+size_t WorkStealingExecutor::deal(size_t first, size_t count, Placement placement)
+{
+    size_t used = placement == Placement::FirstWorker ? 1 : workers_;
+    if (count > used * DEQUE_CAPACITY) {
+        count = used * DEQUE_CAPACITY;
+    }
+
+    for (size_t w = 0; w < workers_; w++) {
+        pool_[w].deque.reset();
+    }
+    for (size_t w = 0; w < used; w++) {
+        size_t begin = first + count * w / used;
+        size_t end = first + count * (w + 1) / used;
+        for (size_t i = begin; i < end; i++) {
+            pool_[w].deque.push(i);
+        }
+    }
+    return count;
+}
+
+bool WorkStealingExecutor::take(size_t worker, size_t &index)
+{
+    if (pool_[worker].deque.pop(index)) {
+        return true;
+    }
+
+    // Nothing is pushed during a round, so once every other deque reports
+    // Empty the round has no work left to take. Retry means a race was
+    // lost on a deque that may still hold jobs: sweep again.
+    bool retry = true;
+    while (retry) {
+        retry = false;
+        for (size_t k = 1; k < workers_; k++) {
+            size_t victim = (worker + k) % workers_;
+            switch (pool_[victim].deque.steal(index)) {
+            case Deque::Steal::Success:
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            case Deque::Steal::Retry:
+                retry = true;
+                break;
+            case Deque::Steal::Empty:
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+void WorkStealingExecutor::execute(size_t index)
+{
+#if __cpp_exceptions
+    try {
+        job_(ctx_, index);
+    }
+    catch (...) {
+        // Keep the first one, the batch goes on
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+    }
+#else
+    job_(ctx_, index);
+#endif
+}
+
+void WorkStealingExecutor::thread_main(size_t worker)
+{
+    // Same as ParallelSum: the FreeRTOS simulator's signals must not land here
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, nullptr);
+
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        size_t index;
+        while (take(worker, index)) {
+            execute(index);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--active_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#include <stdlib.h>
+
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#include "batch_server.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <unistd.h>
+
+#include "atomic_led_sink.hpp"
+#include "fd_stream.hpp"
+#else
+#include "gpio_hal.hpp"
+#include "led_sargent.hpp"
+#include "uart_stream.hpp"
+
+// GPIO pin assignments for the LEDs
+#define GREEN_LED_PIN GPIO_NUM_4
+#define RED_LED_PIN GPIO_NUM_5
+
+// The console UART, switched to a faster rate once the app starts.
+// tools/batch_client.py must open the port at the same rate.
+#define BATCH_UART UART_NUM_0
+#define BATCH_BAUD_RATE 921600
+#endif
+
+// How long poll() waits before checking the stream again
+#define POLL_TIMEOUT_MS 1000
+
+extern "C" void app_main(void)
+{
+    // The batches share the console: a single log line in the middle of a
+    // reply would make the client drop it as a bad frame
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    Sum sum;
+#if CONFIG_IDF_TARGET_LINUX
+    // No LEDs on the host, and stdin/stdout are the stream: run it with
+    // tools/batch_client.py --exec, through pipes or a pty
+    AtomicLedSink led_sargent;
+    FdStream stream(STDIN_FILENO, STDOUT_FILENO);
+#else
+    GpioHal gpio_hal;
+    LedSargent led_sargent(gpio_hal, GREEN_LED_PIN, RED_LED_PIN);
+    UartStream stream(BATCH_UART, BATCH_BAUD_RATE);
+#endif
+    SumBoss sum_boss(sum, led_sargent);
+    BatchServer server(stream, sum_boss);
+
+    // Serve until the stream closes (stdin reaching its end, on the host)
+    while (server.poll(POLL_TIMEOUT_MS) != ESP_ERR_INVALID_STATE) {
+    }
+
+#if CONFIG_IDF_TARGET_LINUX
+    exit(0);
+#endif
+}
@@ -0,0 +1,325 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "block_pool.hpp"
+#include "compute_request.hpp"
+#include "dedic_gpio_hal.hpp"
+#include "gpio_hal.hpp"
+#include "latency_histogram.hpp"
+#include "led_sargent.hpp"
+#include "ll_gpio_hal.hpp"
+#include "parallel_sum.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+// Same pins as test_build, so the LEDs flicker while the benchmark runs
+#define GREEN_LED_PIN GPIO_NUM_4
+#define RED_LED_PIN GPIO_NUM_5
+
+// Writes per measurement, and how many measurements to take (the best one is kept)
+#define ITERATIONS 10000
+#define ROUNDS 5
+
+// Number of interrupts fired for the ISR latency test, one every ISR_PERIOD_US
+#define ISR_SAMPLES 1000
+#define ISR_PERIOD_US 1000
+
+static const char *TAG = "BENCH";
+
+// ---------------------------------------------------------------
+// Cycle counting helpers
+// Every backend is called through IGpioHal&/ILedSargent&, the same
+// way LedSargent and SumBoss use them, so the virtual call is part
+// of what's measured.
+// ---------------------------------------------------------------
+static uint32_t cycles_per_pin_write(IGpioHal &hal)
+{
+    uint32_t best = UINT32_MAX;
+    for (int round = 0; round < ROUNDS; round++) {
+        uint32_t start = esp_cpu_get_cycle_count();
+        for (int i = 0; i < ITERATIONS; i++) {
+            hal.pin_set_level(GREEN_LED_PIN, i & 1);
+        }
+        uint32_t elapsed = esp_cpu_get_cycle_count() - start;
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best / ITERATIONS;
+}
+
+static uint32_t cycles_per_led_cycle(ILedSargent &led)
+{
+    uint32_t best = UINT32_MAX;
+    for (int round = 0; round < ROUNDS; round++) {
+        uint32_t start = esp_cpu_get_cycle_count();
+        for (int i = 0; i < ITERATIONS; i++) {
+            led.green();
+            led.off();
+        }
+        uint32_t elapsed = esp_cpu_get_cycle_count() - start;
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best / ITERATIONS;
+}
+
+static void run_backend(const char *name, IGpioHal &hal)
+{
+    LedSargent led(hal, GREEN_LED_PIN, RED_LED_PIN);
+
+    uint32_t pin_cycles = cycles_per_pin_write(hal);
+    uint32_t led_cycles = cycles_per_led_cycle(led);
+
+    printf(
+        "  %-14s pin_set_level: %4lu cycles   green()+off(): %4lu cycles\n",
+        name,
+        (unsigned long)pin_cycles,
+        (unsigned long)led_cycles);
+}
+
+// ---------------------------------------------------------------
+// ISR latency: SumBoss::compute_isr fired from a gptimer alarm
+// The alarm callback runs in interrupt context. It times one
+// compute_isr call and wakes the task once all samples are in.
+// ---------------------------------------------------------------
+struct IsrBench
+{
+    SumBoss *boss;
+    TaskHandle_t waiter;
+    uint32_t cycles[ISR_SAMPLES];
+    int count;
+};
+
+static bool IRAM_ATTR on_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data)
+{
+    IsrBench *bench = static_cast<IsrBench *>(user_data);
+    if (bench->count >= ISR_SAMPLES) {
+        return false;
+    }
+
+    int result;
+    uint32_t start = esp_cpu_get_cycle_count();
+    bench->boss->compute_isr(bench->count & 1 ? 6 : 3, 4, result); // alternates green and red
+    bench->cycles[bench->count++] = esp_cpu_get_cycle_count() - start;
+
+    BaseType_t woken = pdFALSE;
+    if (bench->count == ISR_SAMPLES) {
+        gptimer_stop(timer);
+        vTaskNotifyGiveFromISR(bench->waiter, &woken);
+    }
+    return woken == pdTRUE;
+}
+
+static void run_isr_latency(SumBoss &boss)
+{
+    static IsrBench bench; // too big for the main task stack
+    bench.boss = &boss;
+    bench.waiter = xTaskGetCurrentTaskHandle();
+    bench.count = 0;
+
+    gptimer_handle_t timer = NULL;
+    gptimer_config_t timer_config = {};
+    timer_config.clk_src = GPTIMER_CLK_SRC_DEFAULT;
+    timer_config.direction = GPTIMER_COUNT_UP;
+    timer_config.resolution_hz = 1000000; // 1 tick = 1 us
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &timer));
+
+    gptimer_event_callbacks_t callbacks = {};
+    callbacks.on_alarm = on_alarm;
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(timer, &callbacks, &bench));
+
+    gptimer_alarm_config_t alarm_config = {};
+    alarm_config.alarm_count = ISR_PERIOD_US;
+    alarm_config.reload_count = 0;
+    alarm_config.flags.auto_reload_on_alarm = true;
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(timer, &alarm_config));
+
+    ESP_ERROR_CHECK(gptimer_enable(timer));
+    ESP_ERROR_CHECK(gptimer_start(timer));
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    ESP_ERROR_CHECK(gptimer_disable(timer));
+    ESP_ERROR_CHECK(gptimer_del_timer(timer));
+
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+    uint64_t total = 0;
+    for (int i = 0; i < ISR_SAMPLES; i++) {
+        uint32_t c = bench.cycles[i];
+        min = c < min ? c : min;
+        max = c > max ? c : max;
+        total += c;
+    }
+    printf(
+        "  compute_isr in ISR: min %lu / avg %lu / max %lu cycles\n",
+        (unsigned long)min,
+        (unsigned long)(total / ISR_SAMPLES),
+        (unsigned long)max);
+}
+
+// ---------------------------------------------------------------
+// Compute-to-LED latency distribution
+// SumBoss timestamps the request and the LED write with the cycle
+// counter and records the difference in a LatencyHistogram.
+// ---------------------------------------------------------------
+static int64_t cycle_clock()
+{
+    return esp_cpu_get_cycle_count(); // wraps at 32 bits, the histogram handles it
+}
+
+static void run_latency_histogram(SumBoss &boss)
+{
+    static LatencyHistogram histogram; // a few KB, keep it off the stack
+    histogram.reset();
+    boss.set_latency_histogram(&histogram, cycle_clock);
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        int result;
+        boss.compute(i & 1 ? 6 : 3, 4, result); // alternates green and red
+    }
+    boss.set_latency_histogram(nullptr, nullptr);
+
+    printf(
+        "  compute -> LED: p50 %lu / p99 %lu / p999 %lu / max %lu cycles\n",
+        (unsigned long)histogram.p50(),
+        (unsigned long)histogram.p99(),
+        (unsigned long)histogram.p999(),
+        (unsigned long)histogram.max());
+}
+
+// ---------------------------------------------------------------
+// ParallelSum: one core against both
+// Sizes are kept to what fits in internal RAM.
+// ---------------------------------------------------------------
+static void run_parallel_sum()
+{
+    const SumStreamBounds bounds = {0, 4095, 0, INT32_MAX};
+    const size_t max_bytes = 64 * 1024;
+    int16_t *samples = static_cast<int16_t *>(malloc(max_bytes));
+    if (samples == NULL) {
+        ESP_LOGE(TAG, "  not enough memory for %u bytes", (unsigned)max_bytes);
+        return;
+    }
+    for (size_t i = 0; i < max_bytes / sizeof(int16_t); i++) {
+        samples[i] = i % 4096;
+    }
+
+    ParallelSum single(1);
+    ParallelSum both(0);
+    for (size_t bytes = 1024; bytes <= max_bytes; bytes *= 4) {
+        size_t count = bytes / sizeof(int16_t);
+        int64_t result;
+
+        uint32_t start = esp_cpu_get_cycle_count();
+        single.reduce(samples, count, bounds, result);
+        uint32_t single_cycles = esp_cpu_get_cycle_count() - start;
+
+        start = esp_cpu_get_cycle_count();
+        both.reduce(samples, count, bounds, result);
+        uint32_t both_cycles = esp_cpu_get_cycle_count() - start;
+
+        printf(
+            "  %3u KiB: 1 core %7lu cycles, %u cores %7lu cycles\n",
+            (unsigned)(bytes / 1024),
+            (unsigned long)single_cycles,
+            (unsigned)both.workers(),
+            (unsigned long)both_cycles);
+    }
+    free(samples);
+}
+
+// ---------------------------------------------------------------
+// BlockPool against heap_caps_malloc
+// One allocate + free pair of a ComputeRequest. heap_caps_malloc
+// takes the heap lock on every call, the pool is one CAS each way.
+// ---------------------------------------------------------------
+static void *volatile sink; // keeps the compiler from removing a malloc/free pair
+
+static void run_block_pool()
+{
+    static BlockPool<ComputeRequest, 64, portNUM_PROCESSORS> pool;
+
+    uint32_t best_pool = UINT32_MAX;
+    uint32_t best_heap = UINT32_MAX;
+    for (int round = 0; round < ROUNDS; round++) {
+        uint32_t start = esp_cpu_get_cycle_count();
+        for (int i = 0; i < ITERATIONS; i++) {
+            void *block = pool.allocate();
+            sink = block;
+            pool.deallocate(block);
+        }
+        uint32_t elapsed = esp_cpu_get_cycle_count() - start;
+        best_pool = elapsed < best_pool ? elapsed : best_pool;
+
+        start = esp_cpu_get_cycle_count();
+        for (int i = 0; i < ITERATIONS; i++) {
+            void *block = heap_caps_malloc(sizeof(ComputeRequest), MALLOC_CAP_DEFAULT);
+            sink = block;
+            heap_caps_free(block);
+        }
+        elapsed = esp_cpu_get_cycle_count() - start;
+        best_heap = elapsed < best_heap ? elapsed : best_heap;
+    }
+
+    printf(
+        "  allocate+free: BlockPool %4lu cycles, heap_caps_malloc %4lu cycles\n",
+        (unsigned long)(best_pool / ITERATIONS),
+        (unsigned long)(best_heap / ITERATIONS));
+}
+
+extern "C" void app_main(void)
+{
+    ESP_LOGI(TAG, "--- Benchmark: IGpioHal backends ---");
+    ESP_LOGI(TAG, "Best of %d rounds, %d calls each", ROUNDS, ITERATIONS);
+
+    // Let the boot logs finish before measuring
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    GpioHal gpio_hal;
+    run_backend("GpioHal", gpio_hal);
+
+    LlGpioHal ll_gpio_hal;
+    run_backend("LlGpioHal", ll_gpio_hal);
+
+    const gpio_num_t led_pins[] = {GREEN_LED_PIN, RED_LED_PIN};
+    DedicGpioHal dedic_gpio_hal(led_pins, 2);
+    run_backend(dedic_gpio_hal.has_bundle() ? "DedicGpioHal" : "DedicGpioHal*", dedic_gpio_hal);
+    if (!dedic_gpio_hal.has_bundle()) {
+        ESP_LOGW(TAG, "* no dedicated GPIO on this chip, DedicGpioHal used its GpioHal fallback");
+    }
+
+    // The ISR path: real Sum, LlGpioHal (no logging, no driver checks)
+#if CONFIG_HAL_AND_LEDS_COMPUTE_IN_IRAM
+    ESP_LOGI(TAG, "--- ISR latency (compute path in IRAM) ---");
+#else
+    ESP_LOGI(TAG, "--- ISR latency (compute path in flash) ---");
+#endif
+    Sum sum;
+    LedSargent isr_led(ll_gpio_hal, GREEN_LED_PIN, RED_LED_PIN);
+    SumBoss boss(sum, isr_led);
+    run_isr_latency(boss);
+
+    // Task path with the driver HAL. Sum logs every failed case, so keep
+    // the log level at WARN or below to measure the LED path, not the UART.
+    ESP_LOGI(TAG, "--- Compute-to-LED latency (GpioHal) ---");
+    esp_log_level_set("SUM", ESP_LOG_NONE);
+    LedSargent task_led(gpio_hal, GREEN_LED_PIN, RED_LED_PIN);
+    SumBoss task_boss(sum, task_led);
+    run_latency_histogram(task_boss);
+
+    ESP_LOGI(TAG, "--- ParallelSum ---");
+    run_parallel_sum();
+
+    ESP_LOGI(TAG, "--- BlockPool ---");
+    run_block_pool();
+}
@@ -0,0 +1,119 @@
+// demo_sequence.cpp
+
+#include <stdio.h>
+
+#include "esp_log.h"
+
+#include "demo_sequence.hpp"
+
+static const char *TAG = "DEMO";
+
+DemoSequence::DemoSequence(IGpioHal &gpio_hal, gpio_num_t green, gpio_num_t red, void (*delay_ms)(uint32_t ms))
+    : led_sargent_(gpio_hal, green, red)
+    , sum_boss_(sum_, led_sargent_)
+    , delay_ms_(delay_ms)
+{
+}
+
+void DemoSequence::run_intro()
+{
+    // ---------------------------------------------------------------
+    // Section 1: Sum — basic arithmetic
+    // The simplest form: add() returns an int directly.
+    // ---------------------------------------------------------------
+    ESP_LOGI(TAG, "[1] Sum::add — basic addition");
+
+    int result = sum_.add(1, 2);
+    printf("  1 + 2 = %d\n", result);
+
+    result = sum_.add_constrained(3, 4);
+    printf("  3 + 4 (constrained) = %d\n", result);
+
+    delay_ms_(RESULT_DELAY_MS);
+
+    // ---------------------------------------------------------------
+    // Section 2: Sum — constrained addition with esp_err_t
+    // add_constrained_err() returns the result via reference and uses
+    // esp_err_t to signal success or failure. The function itself logs
+    // the error internally when something goes wrong.
+    // ---------------------------------------------------------------
+    ESP_LOGI(TAG, "[2] Sum::add_constrained_err — error codes via esp_err_t");
+
+    int constrained_result = 0;
+
+    // Valid input: 4 + 5 = 9, within bounds
+    esp_err_t err = sum_.add_constrained_err(4, 5, constrained_result);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "  4 + 5 = %d", constrained_result);
+    }
+
+    // Invalid result: 6 + 6 = 12, exceeds the limit of 10 — returns ESP_FAIL
+    err = sum_.add_constrained_err(6, 6, constrained_result);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "  6 + 6 => %s (result exceeds limit)", esp_err_to_name(err));
+    }
+
+    // Invalid input: 11 is out of the 0-10 range — returns ESP_ERR_INVALID_ARG
+    err = sum_.add_constrained_err(1, 11, constrained_result);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "  1 + 11 => %s (input out of range)", esp_err_to_name(err));
+    }
+
+    delay_ms_(RESULT_DELAY_MS);
+
+    // ---------------------------------------------------------------
+    // Section 3: LedSargent — hardware abstraction in action
+    // LedSargent uses IGpioHal to control the LEDs without knowing
+    // which GPIO library is underneath: GpioHal on the board, a
+    // recording HAL in the host tests.
+    // ---------------------------------------------------------------
+    ESP_LOGI(TAG, "[3] LedSargent — testing the LEDs");
+
+    led_sargent_.off();
+
+    ESP_LOGI(TAG, "  Green LED on");
+    led_sargent_.green();
+    delay_ms_(LED_TEST_MS);
+
+    ESP_LOGI(TAG, "  Red LED on");
+    led_sargent_.red();
+    delay_ms_(LED_TEST_MS);
+
+    ESP_LOGI(TAG, "  Both off");
+    led_sargent_.off();
+
+    delay_ms_(RESULT_DELAY_MS);
+}
+
+size_t DemoSequence::run_cases()
+{
+    // ---------------------------------------------------------------
+    // Section 4: SumBoss — the orchestrator
+    // SumBoss receives Sum and LedSargent via dependency injection.
+    // It delegates the calculation to Sum and lights the correct LED
+    // based on the result.
+    // ---------------------------------------------------------------
+    size_t failures = 0;
+    for (size_t i = 0; i < CASE_COUNT; i++) {
+        int a = CASES[i].a;
+        int b = CASES[i].b;
+        int res = 0;
+
+        ESP_LOGI(TAG, "  compute(%d, %d)", a, b);
+        esp_err_t err = sum_boss_.compute(a, b, res);
+
+        if (err == ESP_OK) {
+            ESP_LOGI(TAG, "  => %d + %d = %d [green]", a, b, res);
+        }
+        else {
+            ESP_LOGE(TAG, "  => %d + %d failed: %s [red]", a, b, esp_err_to_name(err));
+            failures++;
+        }
+
+        // Hold the LED long enough to be visible, then clear before next case
+        delay_ms_(RESULT_DELAY_MS);
+        led_sargent_.off();
+        delay_ms_(INTER_DELAY_MS);
+    }
+    return failures;
+}
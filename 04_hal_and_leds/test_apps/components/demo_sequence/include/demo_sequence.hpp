@@ -0,0 +1,53 @@
+// demo_sequence.hpp
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "i_gpio_hal.hpp"
+#include "led_sargent.hpp"
+#include "sum.hpp"
+#include "sum_boss.hpp"
+
+/**
+ * @brief The test_build walkthrough, with the HAL and the delays injected.
+ *
+ * test_apps/test_build runs it with GpioHal and vTaskDelay, where a pass
+ * over the cases takes 11 seconds of real time. The host tests run it with
+ * a recording HAL and a virtual clock whose delay only moves time forward,
+ * so hours of the app's timeline play out in milliseconds and every LED
+ * change can be checked with its timestamp.
+ */
+class DemoSequence
+{
+public:
+    // How long each result stays visible on the LEDs before moving to the next
+    static constexpr uint32_t RESULT_DELAY_MS = 2000;
+    // Short pause between turning a LED off and starting the next calculation
+    static constexpr uint32_t INTER_DELAY_MS = 200;
+    // How long each LED stays on during the LED test
+    static constexpr uint32_t LED_TEST_MS = 500;
+
+    struct Case
+    {
+        int a;
+        int b;
+    };
+    static constexpr Case CASES[] = {{1, 2}, {6, 6}, {5, 5}, {-1, 5}, {11, 0}};
+    static constexpr size_t CASE_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+
+    // delay_ms blocks the caller for ms milliseconds (vTaskDelay on the chips)
+    DemoSequence(IGpioHal &gpio_hal, gpio_num_t green, gpio_num_t red, void (*delay_ms)(uint32_t ms));
+
+    // Sections 1 to 3: Sum on its own, then a green/red/off LED test
+    void run_intro();
+
+    // Section 4: one pass of SumBoss over CASES. Returns how many failed.
+    size_t run_cases();
+
+private:
+    Sum sum_;
+    LedSargent led_sargent_;
+    SumBoss sum_boss_;
+    void (*delay_ms_)(uint32_t ms);
+};
@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""Load-tests test_apps/batch_server and reports round-trip throughput.
+
+Sends batches of random (a, b) pairs in the BatchProtocol framing (see
+include/batch_protocol.hpp), checks every reply against the rules of
+Sum::add_constrained_err, and prints the throughput and the round-trip
+time per batch.
+
+    # A board running the app, on its console UART
+    tools/batch_client.py --port /dev/ttyUSB0
+
+    # The linux build, through pipes or through a pty
+    tools/batch_client.py --exec test_apps/batch_server/build/batch_server.elf
+    tools/batch_client.py --exec test_apps/batch_server/build/batch_server.elf --pty
+
+--window keeps that many requests in flight, so the link never sits idle
+waiting for a reply.
+"""
+
+import argparse
+import os
+import random
+import struct
+import subprocess
+import sys
+import time
+import tty
+import zlib
+
+MAGIC = b"SB"
+REQUEST = 1
+REPLY = 2
+HEADER = struct.Struct("<2sBBHH")
+RECORD = struct.Struct("<ii")
+MAX_BATCH = 256
+
+ESP_OK = 0
+ESP_FAIL = -1
+ESP_ERR_INVALID_ARG = 0x102
+
+
+def encode_request(seq, pairs):
+    body = HEADER.pack(MAGIC, REQUEST, seq, len(pairs), 0)
+    body += b"".join(RECORD.pack(a, b) for a, b in pairs)
+    return body + struct.pack("<I", zlib.crc32(body))  # Same CRC as esp_rom_crc32_le(0, ...)
+
+
+def expected(a, b):
+    """What Sum::add_constrained_err returns, as (result, err)."""
+    if not (0 <= a <= 10 and 0 <= b <= 10):
+        return -1, ESP_ERR_INVALID_ARG
+    if a + b > 10:
+        return -1, ESP_FAIL
+    return a + b, ESP_OK
+
+
+class Link:
+    """Bytes to and from the server, whatever carries them."""
+
+    def __init__(self, args):
+        self.process = None
+        if args.exec:
+            if args.pty:
+                master, slave = os.openpty()
+                tty.setraw(slave)  # No echo, no line editing, no CR/LF mangling
+                self.process = subprocess.Popen([args.exec], stdin=slave, stdout=slave)
+                os.close(slave)
+                self.read_fd = self.write_fd = master
+            else:
+                self.process = subprocess.Popen([args.exec], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+                self.read_fd = self.process.stdout.fileno()
+                self.write_fd = self.process.stdin.fileno()
+            self.serial = None
+        else:
+            import serial  # pyserial, only needed for a real port
+
+            self.serial = serial.Serial(args.port, args.baud, timeout=args.timeout)
+            self.serial.reset_input_buffer()
+
+    def write(self, data):
+        if self.serial:
+            self.serial.write(data)
+            return
+        view = memoryview(data)
+        while view:
+            view = view[os.write(self.write_fd, view):]
+
+    def read(self, size):
+        if self.serial:
+            return self.serial.read(size)
+        return os.read(self.read_fd, size)
+
+    def close(self):
+        if self.serial:
+            self.serial.close()
+        if self.process:
+            if self.process.stdin:
+                self.process.stdin.close()  # End of file: the app exits
+            else:
+                self.process.terminate()
+            self.process.wait(timeout=5)
+
+
+class ReplyReader:
+    """Finds REPLY frames in the byte stream, like BatchParser does."""
+
+    def __init__(self, link):
+        self.link = link
+        self.buffer = bytearray()
+        self.skipped = 0
+
+    def next(self):
+        while True:
+            start = self.buffer.find(MAGIC)
+            if start < 0:
+                self.skipped += max(len(self.buffer) - 1, 0)
+                del self.buffer[: max(len(self.buffer) - 1, 0)]
+            elif start > 0:
+                self.skipped += start
+                del self.buffer[:start]
+
+            if len(self.buffer) >= HEADER.size:
+                _, kind, seq, count, reserved = HEADER.unpack_from(self.buffer)
+                size = HEADER.size + count * RECORD.size + 4
+                if kind != REPLY or count > MAX_BATCH or reserved != 0:
+                    del self.buffer[:1]
+                    self.skipped += 1
+                    continue
+                if len(self.buffer) >= size:
+                    (crc,) = struct.unpack_from("<I", self.buffer, size - 4)
+                    if crc != zlib.crc32(self.buffer[: size - 4]):
+                        del self.buffer[:1]
+                        self.skipped += 1
+                        continue
+                    records = [RECORD.unpack_from(self.buffer, HEADER.size + i * RECORD.size) for i in range(count)]
+                    del self.buffer[:size]
+                    return seq, records
+
+            chunk = self.link.read(65536)
+            if not chunk:
+                raise TimeoutError("no reply from the server")
+            self.buffer += chunk
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    target = parser.add_mutually_exclusive_group(required=True)
+    target.add_argument("--port", help="serial port of a board running batch_server")
+    target.add_argument("--exec", help="linux build of batch_server to run")
+    parser.add_argument("--pty", action="store_true", help="with --exec, talk through a pty instead of pipes")
+    parser.add_argument("--baud", type=int, default=921600, help="serial rate (default: 921600)")
+    parser.add_argument("--timeout", type=float, default=2.0, help="seconds to wait for a reply (default: 2)")
+    parser.add_argument("--batches", type=int, default=1000, help="requests to send (default: 1000)")
+    parser.add_argument("--batch-size", type=int, default=64, help=f"pairs per request, 1..{MAX_BATCH} (default: 64)")
+    parser.add_argument("--window", type=int, default=4, help="requests in flight (default: 4)")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the random pairs (default: 1)")
+    args = parser.parse_args()
+
+    if not 1 <= args.batch_size <= MAX_BATCH:
+        parser.error(f"--batch-size must be between 1 and {MAX_BATCH}")
+
+    rng = random.Random(args.seed)
+    # Mostly valid pairs, with invalid and out-of-range ones mixed in
+    batches = [[(rng.randint(-1, 11), rng.randint(-1, 11)) for _ in range(args.batch_size)] for _ in range(args.batches)]
+
+    link = Link(args)
+    reader = ReplyReader(link)
+    sent_at = {}
+    rtts = []
+    mismatches = 0
+
+    try:
+        start = time.perf_counter()
+        sent = 0
+        for received in range(args.batches):
+            while sent < args.batches and sent - received < args.window:
+                seq = sent % 256
+                sent_at[seq] = (time.perf_counter(), batches[sent])
+                link.write(encode_request(seq, batches[sent]))
+                sent += 1
+
+            seq, replies = reader.next()
+            when, pairs = sent_at.pop(seq)
+            rtts.append(time.perf_counter() - when)
+            for (a, b), reply in zip(pairs, replies):
+                if reply != expected(a, b):
+                    mismatches += 1
+        elapsed = time.perf_counter() - start
+    finally:
+        link.close()
+
+    rtts.sort()
+    pairs = args.batches * args.batch_size
+    print(f"{args.batches} batches of {args.batch_size} pairs in {elapsed:.3f} s, window {args.window}")
+    print(f"  throughput  {pairs / elapsed:,.0f} pairs/s, {args.batches / elapsed:,.0f} batches/s")
+    print(f"  round trip  p50 {rtts[len(rtts) // 2] * 1e6:,.0f} us, p99 {rtts[len(rtts) * 99 // 100] * 1e6:,.0f} us")
+    print(f"  mismatches  {mismatches}, skipped bytes {reader.skipped}")
+    return 1 if mismatches else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+"""Runs the host benchmarks several times and gates them on a baseline.
+
+Every BENCH line of host_test/benchmark is collected over --runs runs.
+Each benchmark gets its median and its MAD (median absolute deviation),
+which a single noisy run can't move much. The medians are compared with
+host_test/benchmark/baseline.json. A benchmark regresses when its median
+is above
+
+    baseline median * (1 + threshold) + 3 * 1.4826 * max(both MADs)
+
+1.4826 * MAD estimates a standard deviation, so the last term keeps a
+noisy benchmark from failing on noise alone. threshold is per benchmark
+in the baseline, default_threshold otherwise. A benchmark missing from
+the run also fails the gate; a new one is only reported.
+
+    # Gate: exits with 1 on a regression
+    tools/bench_gate.py
+
+    # Accept an intentional change to one benchmark, or to all of them
+    tools/bench_gate.py --accept sum_boss/compute/led_sargent
+    tools/bench_gate.py --update
+
+    # Outputs saved elsewhere, one file per run, instead of running
+    tools/bench_gate.py --log run1.txt run2.txt run3.txt
+
+Host numbers only compare on the same machine: make the baseline on the
+machine that runs the gate.
+"""
+
+import argparse
+import json
+import os
+import platform
+import statistics
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_EXEC = os.path.normpath(os.path.join(HERE, "..", "host_test", "benchmark", "build", "benchmark.elf"))
+DEFAULT_BASELINE = os.path.normpath(os.path.join(HERE, "..", "host_test", "benchmark", "baseline.json"))
+DEFAULT_THRESHOLD = 0.20
+MAD_TO_SIGMA = 1.4826
+NOISE_SIGMAS = 3
+
+
+def parse_bench_lines(text):
+    """BENCH <name> <value> <unit> lines, as {name: (value, unit)}."""
+    results = {}
+    for line in text.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[0] == "BENCH":
+            try:
+                results[fields[1]] = (float(fields[2]), fields[3])
+            except ValueError:
+                pass
+    return results
+
+
+def collect(args):
+    """One {name: (value, unit)} per run."""
+    runs = []
+    if args.log:
+        for path in args.log:
+            with open(path) as f:
+                runs.append(parse_bench_lines(f.read()))
+        return runs
+
+    for i in range(args.runs):
+        print(f"run {i + 1}/{args.runs}: {args.exec}", file=sys.stderr)
+        try:
+            done = subprocess.run([args.exec], capture_output=True, text=True, timeout=args.timeout)
+        except (OSError, subprocess.TimeoutExpired) as e:
+            sys.exit(f"can't run the benchmarks: {e}")
+        if done.returncode != 0:
+            sys.exit(f"{args.exec} exited with {done.returncode}")
+        runs.append(parse_bench_lines(done.stdout))
+    return runs
+
+
+def summarize(runs):
+    """{name: {unit, median, mad, runs}} over every run that reported the name."""
+    values = {}
+    units = {}
+    for run in runs:
+        for name, (value, unit) in run.items():
+            values.setdefault(name, []).append(value)
+            units[name] = unit
+    summary = {}
+    for name, samples in values.items():
+        median = statistics.median(samples)
+        mad = statistics.median(abs(v - median) for v in samples)
+        summary[name] = {"unit": units[name], "median": median, "mad": mad, "runs": len(samples)}
+    return summary
+
+
+def machine():
+    return {"machine": platform.machine(), "system": platform.system(), "cpus": os.cpu_count()}
+
+
+def load_baseline(path):
+    if not os.path.exists(path):
+        return {"default_threshold": DEFAULT_THRESHOLD, "benchmarks": {}}
+    with open(path) as f:
+        return json.load(f)
+
+
+def save_baseline(path, baseline, summary, names, runs):
+    benchmarks = baseline.setdefault("benchmarks", {})
+    for name in names:
+        entry = benchmarks.setdefault(name, {})
+        entry["unit"] = summary[name]["unit"]
+        entry["median"] = round(summary[name]["median"], 3)
+        entry["mad"] = round(summary[name]["mad"], 3)
+    ordered = {
+        "default_threshold": baseline.get("default_threshold", DEFAULT_THRESHOLD),
+        "machine": machine(),
+        "runs": runs,
+        "benchmarks": dict(sorted(benchmarks.items())),
+    }
+    with open(path, "w") as f:
+        json.dump(ordered, f, indent=2)
+        f.write("\n")
+
+
+def gate(baseline, summary):
+    """Prints one line per benchmark and returns how many failed."""
+    default_threshold = baseline.get("default_threshold", DEFAULT_THRESHOLD)
+    benchmarks = baseline.get("benchmarks", {})
+    failures = 0
+
+    print(f"{'benchmark':<40} {'baseline':>12} {'now':>12} {'change':>8}  {'limit':>12}  status")
+    for name in sorted(set(benchmarks) | set(summary)):
+        base = benchmarks.get(name)
+        now = summary.get(name)
+        if base is None:
+            print(f"{name:<40} {'':>12} {now['median']:>12.3f} {'':>8}  {'':>12}  new ({now['unit']})")
+            continue
+        if now is None:
+            print(f"{name:<40} {base['median']:>12.3f} {'':>12} {'':>8}  {'':>12}  MISSING")
+            failures += 1
+            continue
+
+        threshold = base.get("threshold", default_threshold)
+        noise = NOISE_SIGMAS * MAD_TO_SIGMA * max(base["mad"], now["mad"])
+        limit = base["median"] * (1 + threshold) + noise
+        change = (now["median"] / base["median"] - 1) * 100 if base["median"] else 0.0
+        if now["median"] > limit:
+            status = "REGRESSED"
+            failures += 1
+        elif now["median"] < base["median"] * (1 - threshold) - noise:
+            status = "improved, --accept to keep it"
+        else:
+            status = "ok"
+        print(f"{name:<40} {base['median']:>12.3f} {now['median']:>12.3f} {change:>+7.1f}%  {limit:>12.3f}  {status}")
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--exec", default=DEFAULT_EXEC, help="benchmark binary (default: the host_test build)")
+    parser.add_argument("--runs", type=int, default=5, help="runs of the binary (default: 5)")
+    parser.add_argument("--timeout", type=float, default=300, help="seconds allowed per run (default: 300)")
+    parser.add_argument("--log", nargs="+", help="saved outputs, one per run, instead of running --exec")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE, help="baseline JSON (default: %(default)s)")
+    parser.add_argument("--update", action="store_true", help="replace the whole baseline with this run")
+    parser.add_argument("--accept", action="append", default=[], metavar="NAME",
+                        help="take this run's numbers for one benchmark, and gate the others")
+    args = parser.parse_args()
+
+    runs = collect(args)
+    summary = summarize(runs)
+    if not summary:
+        sys.exit("no BENCH lines in the output")
+    baseline = load_baseline(args.baseline)
+
+    if args.update:
+        # Benchmarks that are gone are dropped, thresholds are kept
+        baseline["benchmarks"] = {k: v for k, v in baseline.get("benchmarks", {}).items() if k in summary}
+        save_baseline(args.baseline, baseline, summary, summary.keys(), len(runs))
+        print(f"{args.baseline}: {len(summary)} benchmarks over {len(runs)} runs")
+        return 0
+
+    recorded = baseline.get("machine")
+    if recorded and recorded != machine():
+        print(f"warning: the baseline was made on {recorded}, this is {machine()}", file=sys.stderr)
+
+    unknown = [name for name in args.accept if name not in summary]
+    if unknown:
+        sys.exit(f"not in this run: {', '.join(unknown)}")
+    if args.accept:
+        save_baseline(args.baseline, baseline, summary, args.accept, len(runs))
+        print(f"{args.baseline}: accepted {', '.join(args.accept)}")
+
+    failures = gate(baseline, summary)
+    print(f"{failures} of {len(set(baseline.get('benchmarks', {})) | set(summary))} benchmarks failed the gate")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
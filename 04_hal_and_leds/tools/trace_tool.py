@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Makes, shows and diffs the files of host_test/replay.
+
+A trace is a 24-byte header followed by (a, b) records; a results file is
+the same header followed by (result, err) records, one per trace record
+(see include/trace_replay.hpp). Both are little-endian int32 pairs.
+
+    # 10 million random pairs, mostly valid
+    tools/trace_tool.py make trace.bin --count 10000000
+
+    # From a capture, one "a,b" per line
+    tools/trace_tool.py make trace.bin --csv capture.csv
+
+    # First records of any of the two kinds
+    tools/trace_tool.py show results.bin --limit 20
+
+    # Where two replays disagree; exits with 1 if they do
+    tools/trace_tool.py diff before.bin after.bin --trace trace.bin
+"""
+
+import argparse
+import mmap
+import random
+import struct
+import sys
+
+HEADER = struct.Struct("<8sIIQ")
+RECORD = struct.Struct("<ii")
+TRACE_MAGIC = b"SBTRACE\0"
+RESULTS_MAGIC = b"SBRESLT\0"
+VERSION = 1
+
+ERR_NAMES = {0: "ESP_OK", -1: "ESP_FAIL", 0x102: "ESP_ERR_INVALID_ARG"}
+
+
+class RecordFile:
+    """A trace or results file, mapped read-only."""
+
+    def __init__(self, path):
+        self.path = path
+        with open(path, "rb") as f:
+            self.map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        if len(self.map) < HEADER.size:
+            sys.exit(f"{path}: too short for a header")
+        magic, version, record_size, self.count = HEADER.unpack_from(self.map)
+        if magic not in (TRACE_MAGIC, RESULTS_MAGIC):
+            sys.exit(f"{path}: not a trace or results file")
+        if version != VERSION:
+            sys.exit(f"{path}: version {version}, this tool knows {VERSION}")
+        if record_size != RECORD.size or len(self.map) < HEADER.size + self.count * RECORD.size:
+            sys.exit(f"{path}: shorter than its header says")
+        self.is_trace = magic == TRACE_MAGIC
+
+    def record(self, i):
+        return RECORD.unpack_from(self.map, HEADER.size + i * RECORD.size)
+
+    def describe(self, i):
+        first, second = self.record(i)
+        if self.is_trace:
+            return f"a={first} b={second}"
+        return f"result={first} err={ERR_NAMES.get(second, hex(second))}"
+
+
+def make(args):
+    if args.csv:
+        with open(args.csv) as f:
+            pairs = [tuple(int(v) for v in line.split(",")[:2]) for line in f if line.strip()]
+    else:
+        rng = random.Random(args.seed)
+        pairs = None
+
+    count = len(pairs) if pairs is not None else args.count
+    with open(args.output, "wb") as f:
+        f.write(HEADER.pack(TRACE_MAGIC, VERSION, RECORD.size, count))
+        if pairs is not None:
+            f.write(b"".join(RECORD.pack(a, b) for a, b in pairs))
+            return 0
+        # Written in chunks so 100M records don't need the memory of 100M tuples
+        chunk = 1 << 16
+        for start in range(0, count, chunk):
+            n = min(chunk, count - start)
+            f.write(b"".join(RECORD.pack(rng.randint(-1, 11), rng.randint(-1, 11)) for _ in range(n)))
+    return 0
+
+
+def show(args):
+    records = RecordFile(args.file)
+    kind = "trace" if records.is_trace else "results"
+    print(f"{args.file}: {kind}, {records.count} records")
+    for i in range(min(args.limit, records.count)):
+        print(f"  {i:10d}  {records.describe(i)}")
+    return 0
+
+
+def diff(args):
+    before = RecordFile(args.before)
+    after = RecordFile(args.after)
+    trace = RecordFile(args.trace) if args.trace else None
+    if before.count != after.count:
+        print(f"record counts differ: {before.count} and {after.count}")
+        return 1
+
+    # Compare 1 MiB at a time, and only look at records inside a chunk that differs
+    differences = 0
+    chunk = (1 << 20) // RECORD.size
+    for start in range(0, before.count, chunk):
+        n = min(chunk, before.count - start)
+        lo = HEADER.size + start * RECORD.size
+        hi = lo + n * RECORD.size
+        if before.map[lo:hi] == after.map[lo:hi]:
+            continue
+        for i in range(start, start + n):
+            if before.record(i) == after.record(i):
+                continue
+            differences += 1
+            if differences <= args.limit:
+                where = f"  ({trace.describe(i)})" if trace and i < trace.count else ""
+                print(f"  {i:10d}  {before.describe(i)}  ->  {after.describe(i)}{where}")
+
+    print(f"{differences} of {before.count} records differ")
+    return 1 if differences else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    p = commands.add_parser("make", help="write a trace")
+    p.add_argument("output")
+    p.add_argument("--count", type=int, default=1000000, help="random records (default: 1000000)")
+    p.add_argument("--seed", type=int, default=1, help="seed of the random records (default: 1)")
+    p.add_argument("--csv", help="take the records from a file of 'a,b' lines instead")
+    p.set_defaults(run=make)
+
+    p = commands.add_parser("show", help="print the first records of a trace or results file")
+    p.add_argument("file")
+    p.add_argument("--limit", type=int, default=10)
+    p.set_defaults(run=show)
+
+    p = commands.add_parser("diff", help="compare two results files record by record")
+    p.add_argument("before")
+    p.add_argument("after")
+    p.add_argument("--trace", help="the trace both came from, to show the inputs of each difference")
+    p.add_argument("--limit", type=int, default=20, help="differences to print (default: 20)")
+    p.set_defaults(run=diff)
+
+    args = parser.parse_args()
+    return args.run(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+# Builds GoogleTest/GMock 1.12.1 once and installs it where every chapter's
+# host_test can use it, so clean builds don't download or compile GTest again.
+#
+#   tools/install_gtest.sh [googletest source dir]
+#
+# Without a source dir the release tarball is downloaded. With one (a vendored
+# copy, /usr/src/googletest...) nothing touches the network.
+# Then point the builds at the install:
+#
+#   export GTEST_ROOT=$HOME/.cache/gtest-esp-idf/1.12.1
+#   idf.py build
+set -euo pipefail
+
+VERSION=1.12.1
+PREFIX="${GTEST_ROOT:-$HOME/.cache/gtest-esp-idf/$VERSION}"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+SOURCE="${1:-}"
+if [ -z "$SOURCE" ]; then
+    curl -sSfL "https://github.com/google/googletest/archive/refs/tags/release-$VERSION.tar.gz" \
+        | tar -xz -C "$WORK"
+    SOURCE="$WORK/googletest-release-$VERSION"
+fi
+
+cmake -S "$SOURCE" -B "$WORK/build" \
+    -DCMAKE_BUILD_TYPE=Release \
+    -DCMAKE_INSTALL_PREFIX="$PREFIX" \
+    -DBUILD_GMOCK=ON \
+    -DINSTALL_GTEST=ON
+cmake --build "$WORK/build" -j"$(nproc)"
+cmake --install "$WORK/build"
+
+echo "GTest $VERSION installed in $PREFIX"
+echo "export GTEST_ROOT=$PREFIX"